@@ -0,0 +1,148 @@
+#include "services/AudioImporter.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QList>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUrl>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Measures local import throughput (files/sec) for several worker counts.
+//
+//   MySongPlayerImportBenchmark [--cold] [music-directory]
+//
+// Without a directory a synthetic library of small MP3 files is generated. By default
+// an untimed import warms the page cache first, so every worker count reads from
+// memory and the numbers compare scheduling rather than disk speed. With --cold the
+// cached pages of every file are dropped before each worker count (posix_fadvise
+// DONTNEED, no root needed); run it on the HDD or network mount in question.
+
+namespace {
+
+constexpr int kSyntheticFileCount = 2000;
+constexpr qsizetype kSyntheticFileSize = 64 * 1024;
+
+QList<QUrl> collectAudioFiles(const QString& directory)
+{
+    QList<QUrl> files;
+    QDirIterator iterator(directory,
+                          {QStringLiteral("*.mp3"), QStringLiteral("*.flac"), QStringLiteral("*.ogg"),
+                           QStringLiteral("*.m4a"), QStringLiteral("*.wav"), QStringLiteral("*.opus")},
+                          QDir::Files, QDirIterator::Subdirectories);
+    while (iterator.hasNext()) {
+        files.append(QUrl::fromLocalFile(iterator.next()));
+    }
+    return files;
+}
+
+QList<QUrl> writeSyntheticLibrary(const QDir& directory)
+{
+    // An empty ID3v2.4 header followed by padding: TagLib parses the tag and scans
+    // for MPEG frames, which is the common cost of an untagged import.
+    QByteArray content("ID3\x04\x00\x00\x00\x00\x00\x00", 10);
+    content.append(QByteArray(kSyntheticFileSize - content.size(), '\0'));
+
+    QList<QUrl> files;
+    for (int index = 0; index < kSyntheticFileCount; ++index) {
+        const QString path = directory.filePath(QStringLiteral("track-%1.mp3").arg(index, 5, 10, QLatin1Char('0')));
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+            std::cerr << "Cannot write " << path.toStdString() << '\n';
+            return {};
+        }
+        files.append(QUrl::fromLocalFile(path));
+    }
+    return files;
+}
+
+// Written files are flushed first; dirty pages cannot be dropped.
+void dropCachedPages(const QUrl& file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    const int descriptor = ::open(QFile::encodeName(file.toLocalFile()).constData(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return;
+    }
+    ::fsync(descriptor);
+#if defined(POSIX_FADV_DONTNEED)
+    ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    ::close(descriptor);
+#else
+    static_cast<void>(file);
+#endif
+}
+
+double importFilesPerSecond(const QList<QUrl>& files, int workerCount)
+{
+    SongPlayer::AudioImporter importer;
+    importer.setImportWorkerCount(workerCount);
+
+    QEventLoop loop;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &loop, [&loop](int, int, int, bool) { loop.quit(); });
+
+    QElapsedTimer timer;
+    timer.start();
+    importer.importLocalAudio(files);
+    loop.exec();
+    const double seconds = std::max<qint64>(timer.elapsed(), 1) / 1000.0;
+    return files.size() / seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("MySongPlayerImportBenchmark"));
+
+    QTemporaryDir coverCache;
+    qputenv("XDG_CACHE_HOME", coverCache.path().toUtf8());
+
+    QStringList arguments = QCoreApplication::arguments().mid(1);
+    const bool cold = arguments.removeAll(QStringLiteral("--cold")) > 0;
+    QTemporaryDir synthetic;
+    const QList<QUrl> files = !arguments.isEmpty()
+        ? collectAudioFiles(arguments.front())
+        : writeSyntheticLibrary(QDir(synthetic.path()));
+    if (files.isEmpty()) {
+        std::cerr << "No audio files to import\n";
+        return 1;
+    }
+
+    std::vector<int> workerCounts{1, 2, 4, 8};
+    const int idealThreads = std::min(QThread::idealThreadCount(), SongPlayer::AudioImporter::kMaxImportWorkerCount);
+    if (std::ranges::find(workerCounts, idealThreads) == workerCounts.end()) {
+        workerCounts.push_back(idealThreads);
+    }
+
+    if (!cold) {
+        // Otherwise the first worker count alone pays for reading the files from disk.
+        importFilesPerSecond(files, idealThreads);
+    }
+
+    std::cout << "files: " << files.size() << ", " << (cold ? "cold" : "warm") << " page cache\n";
+    std::cout << "workers\tfiles/sec\n";
+    for (const int workerCount : workerCounts) {
+        if (cold) {
+            std::ranges::for_each(files, dropCachedPages);
+        }
+        std::cout << workerCount << '\t' << static_cast<int>(importFilesPerSecond(files, workerCount)) << '\n';
+    }
+    return 0;
+}
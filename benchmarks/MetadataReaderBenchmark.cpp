@@ -0,0 +1,247 @@
+#include "core/AudioImport.h"
+#include "infrastructure/ReadaheadFileStream.h"
+#include "infrastructure/TagLibAudioMetadataReader.h"
+
+#include <taglib/attachedpictureframe.h>
+#include <taglib/fileref.h>
+#include <taglib/id3v2tag.h>
+#include <taglib/mpegfile.h>
+#include <taglib/tfilestream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Measures single-threaded TagLibAudioMetadataReader throughput (files/sec), i.e. the
+// per-file parsing cost without pool scheduling or Qt delivery.
+//
+//   MySongPlayerMetadataBenchmark [--cold] [music-directory]
+//
+// Without a directory a synthetic set of tagged MP3 files with embedded covers is
+// written. Every file is read several times, so the page cache is warm and the
+// numbers reflect parsing work rather than disk speed. With --cold the cached pages
+// of every file are dropped before each round (posix_fadvise DONTNEED, no root
+// needed), so the numbers include the reads themselves; run it on the HDD or network
+// mount in question.
+//
+// Besides the full reader, a bare TagLib parse is timed once through TagLib's own
+// FileStream and once through ReadaheadFileStream, which isolates the I/O pattern.
+// Both parses also report the readBlock and seek calls TagLib issued per file, and
+// the ReadaheadFileStream one the pread calls that reached the file. Unlike files/sec
+// these counts do not depend on the disk, so they show what a change does to the I/O
+// pattern even where no cold-cache run on slow storage is possible.
+
+namespace {
+
+constexpr int kSyntheticFileCount = 500;
+constexpr std::size_t kSyntheticAudioBytes = 256 * 1024;
+constexpr std::size_t kSyntheticCoverBytes = 96 * 1024;
+constexpr int kRounds = 5;
+
+bool isAudioFile(const std::filesystem::path& path)
+{
+    std::string extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char character) {
+        return static_cast<char>(std::tolower(character));
+    });
+    return extension == ".mp3" || extension == ".flac" || extension == ".ogg" ||
+           extension == ".opus" || extension == ".m4a" || extension == ".wv";
+}
+
+std::vector<std::filesystem::path> collectAudioFiles(const std::filesystem::path& directory)
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_regular_file(error) && isAudioFile(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    return files;
+}
+
+std::vector<std::filesystem::path> writeSyntheticLibrary(const std::filesystem::path& directory)
+{
+    std::filesystem::create_directories(directory);
+    const TagLib::ByteVector cover(static_cast<unsigned int>(kSyntheticCoverBytes), '\x7f');
+
+    std::vector<std::filesystem::path> files;
+    for (int index = 0; index < kSyntheticFileCount; ++index) {
+        const std::filesystem::path path = directory / ("track-" + std::to_string(index) + ".mp3");
+        std::ofstream(path, std::ios::binary) << std::string(kSyntheticAudioBytes, '\0');
+
+        TagLib::MPEG::File file(path.c_str(), false);
+        TagLib::ID3v2::Tag* tag = file.ID3v2Tag(true);
+        tag->setTitle("Synthetic Track " + TagLib::String::number(index));
+        tag->setArtist("Benchmark Artist");
+        auto* picture = new TagLib::ID3v2::AttachedPictureFrame;
+        picture->setMimeType("image/jpeg");
+        picture->setType(TagLib::ID3v2::AttachedPictureFrame::FrontCover);
+        picture->setPicture(cover);
+        tag->addFrame(picture);
+        if (!file.save(TagLib::MPEG::File::ID3v2)) {
+            std::cerr << "Cannot tag " << path << '\n';
+            return {};
+        }
+        files.push_back(path);
+    }
+    return files;
+}
+
+// Written files are flushed first; dirty pages cannot be dropped.
+void dropCachedPages(const std::filesystem::path& file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    const int descriptor = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return;
+    }
+    ::fsync(descriptor);
+#if defined(POSIX_FADV_DONTNEED)
+    ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    ::close(descriptor);
+#else
+    static_cast<void>(file);
+#endif
+}
+
+// Calls a parse issued against a stream, summed over all files of all rounds.
+struct IoCounts {
+    std::size_t readBlocks{0};
+    std::size_t seeks{0};
+    std::size_t fileReads{0};
+};
+
+// Forwards to another stream and counts the readBlock and seek calls made on it.
+class CountingStream final : public TagLib::IOStream {
+public:
+    CountingStream(TagLib::IOStream& stream, IoCounts& counts)
+        : m_stream(stream)
+        , m_counts(counts)
+    {
+    }
+
+    TagLib::FileName name() const override { return m_stream.name(); }
+    TagLib::ByteVector readBlock(std::size_t length) override
+    {
+        ++m_counts.readBlocks;
+        return m_stream.readBlock(length);
+    }
+    void writeBlock(const TagLib::ByteVector& data) override { m_stream.writeBlock(data); }
+    void insert(const TagLib::ByteVector& data, TagLib::offset_t start, std::size_t replace) override
+    {
+        m_stream.insert(data, start, replace);
+    }
+    void removeBlock(TagLib::offset_t start, std::size_t length) override { m_stream.removeBlock(start, length); }
+    bool readOnly() const override { return m_stream.readOnly(); }
+    bool isOpen() const override { return m_stream.isOpen(); }
+    void seek(TagLib::offset_t offset, Position position) override
+    {
+        ++m_counts.seeks;
+        m_stream.seek(offset, position);
+    }
+    void clear() override { m_stream.clear(); }
+    TagLib::offset_t tell() const override { return m_stream.tell(); }
+    TagLib::offset_t length() override { return m_stream.length(); }
+    void truncate(TagLib::offset_t length) override { m_stream.truncate(length); }
+
+private:
+    TagLib::IOStream& m_stream;
+    IoCounts& m_counts;
+};
+
+// Runs readOne over every file for kRounds rounds and prints files/sec, followed by
+// the per-file call counts when counts is given; dropping the page cache is not part
+// of the measured time.
+void measure(const char* label, const std::vector<std::filesystem::path>& files, bool cold,
+             const std::function<bool(const std::filesystem::path&)>& readOne,
+             const IoCounts* counts = nullptr)
+{
+    int failed = 0;
+    std::chrono::duration<double> elapsed{0};
+    for (int round = 0; round < kRounds; ++round) {
+        if (cold) {
+            std::ranges::for_each(files, dropCachedPages);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (const std::filesystem::path& file : files) {
+            failed += readOne(file) ? 0 : 1;
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    const double parses = static_cast<double>(files.size() * kRounds);
+    std::cout << label << ": " << static_cast<int>(parses / std::max(elapsed.count(), 1e-6))
+              << " files/sec, failed: " << failed;
+    if (counts) {
+        std::cout << ", per file: " << static_cast<double>(counts->readBlocks) / parses << " readBlock, "
+                  << static_cast<double>(counts->seeks) / parses << " seek";
+        if (counts->fileReads > 0) {
+            std::cout << ", " << static_cast<double>(counts->fileReads) / parses << " pread";
+        }
+    }
+    std::cout << '\n';
+}
+
+bool parseTitle(const TagLib::FileRef& file)
+{
+    return !file.isNull() && file.tag() && !file.tag()->title().isEmpty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path scratch = std::filesystem::temp_directory_path() / "mysongplayer-metadata-benchmark";
+    std::error_code error;
+    std::filesystem::remove_all(scratch, error);
+
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    const bool cold = std::erase(arguments, "--cold") > 0;
+    const std::vector<std::filesystem::path> files = !arguments.empty()
+        ? collectAudioFiles(arguments.front())
+        : writeSyntheticLibrary(scratch / "library");
+    if (files.empty()) {
+        std::cerr << "No audio files to read\n";
+        return 1;
+    }
+    std::cout << "files: " << files.size() << " x " << kRounds << " rounds, "
+              << (cold ? "cold" : "warm") << " page cache\n";
+
+    SongPlayer::Infrastructure::TagLibAudioMetadataReader reader;
+    measure("reader", files, cold, [&](const std::filesystem::path& file) {
+        return reader.read({.audioFile = file, .coverCacheDirectory = scratch / "covers"}).has_value();
+    });
+    IoCounts fileStreamCounts;
+    measure("TagLib FileStream parse", files, cold, [&](const std::filesystem::path& file) {
+        TagLib::FileStream stream(file.c_str(), true);
+        CountingStream counting(stream, fileStreamCounts);
+        return stream.isOpen() && parseTitle(TagLib::FileRef(&counting, true, TagLib::AudioProperties::Fast));
+    }, &fileStreamCounts);
+    IoCounts readaheadCounts;
+    measure("ReadaheadFileStream parse", files, cold, [&](const std::filesystem::path& file) {
+        const auto stream = SongPlayer::Infrastructure::ReadaheadFileStream::open(file);
+        if (!stream) {
+            return false;
+        }
+        CountingStream counting(*stream, readaheadCounts);
+        const bool parsed = parseTitle(TagLib::FileRef(&counting, true, TagLib::AudioProperties::Fast));
+        readaheadCounts.fileReads += stream->fileReads();
+        return parsed;
+    }, &readaheadCounts);
+
+    std::filesystem::remove_all(scratch, error);
+    return 0;
+}
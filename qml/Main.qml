@@ -109,6 +109,11 @@ ApplicationWindow {
             close()
             audioFileDialog.open()
         }
+
+        onFolderImportRequested: {
+            close()
+            audioFolderDialog.open()
+        }
         
         onNetworkImportRequested: {
             close()
@@ -130,6 +135,15 @@ ApplicationWindow {
         }
     }
 
+    FolderDialog {
+        id: audioFolderDialog
+        title: "Select Music Folder"
+        currentFolder: StandardPaths.standardLocations(StandardPaths.MusicLocation)[0]
+        onAccepted: {
+            PlayerController.importAudioFolder(audioFolderDialog.selectedFolder, true)
+        }
+    }
+
     Frame {
         anchors.top: topContainer.bottom
         anchors.right: parent.right
@@ -147,11 +161,18 @@ ApplicationWindow {
             }
 
             Label {
-                text: qsTr("Importing %1 / %2")
+                // A folder import is still counting files while the total is unknown.
+                text: (PlayerController.importTotalKnown ? qsTr("Importing %1 / %2")
+                                                         : qsTr("Importing %1 / %2+"))
                     .arg(PlayerController.importCompleted)
                     .arg(PlayerController.importTotal)
             }
 
+            Label {
+                visible: PlayerController.queuedImportCount > 0
+                text: qsTr("(%1 more queued)").arg(PlayerController.queuedImportCount)
+            }
+
             Button {
                 text: qsTr("Cancel")
                 onClicked: PlayerController.cancelAudioImport()
@@ -8,8 +8,14 @@ Rectangle {
     property string audioTitle: ""
     property string audioAuthor: ""
     property url audioImageSource: ""
+    // Import-time thumbnail; covers cached before thumbnails existed fall back to
+    // audioImageSource.
+    property url audioListImageSource: ""
+    property bool listImageFailed: false
     property url audioSource: ""
     property url audioVideoSource: ""
+    // Read at import; 0 hides the label.
+    property real audioDurationMs: 0
     property int audioIndex: -1
 
     property color itemColor: AppStyles.backgroundColor
@@ -19,6 +25,8 @@ Rectangle {
     property bool showActionButton: true
     property string actionButtonIcon: ""
 
+    onAudioListImageSourceChanged: listImageFailed = false
+
     signal clicked()
     signal actionClicked()
     width: parent ? parent.width : 200
@@ -46,10 +54,21 @@ Rectangle {
                     Layout.preferredWidth: AppStyles.mediumIcon
                     Layout.preferredHeight: AppStyles.mediumIcon
                     Layout.alignment: Qt.AlignVCenter
-                    source: root.audioImageSource
+                    source: root.audioListImageSource.toString() !== "" && !root.listImageFailed
+                            ? root.audioListImageSource : root.audioImageSource
+                    // Decode the full-size fallback at icon size, never at 1500px.
+                    sourceSize.width: AppStyles.mediumIcon * 2
+                    sourceSize.height: AppStyles.mediumIcon * 2
+                    asynchronous: true
                     visible: root.showImage
                     mipmap: true
                     fillMode: Image.PreserveAspectFit
+
+                    onStatusChanged: {
+                        if (status === Image.Error && source.toString() === root.audioListImageSource.toString()) {
+                            root.listImageFailed = true
+                        }
+                    }
                 }
 
                 ColumnLayout {
@@ -76,6 +95,14 @@ Rectangle {
                         font: AppStyles.smallFont
                     }
                 }
+
+                Text {
+                    Layout.alignment: Qt.AlignVCenter
+                    text: TimeUtils.formatTime(root.audioDurationMs)
+                    visible: root.audioDurationMs > 0
+                    color: root.textSecondaryColor
+                    font: AppStyles.smallFont
+                }
             }
 
             TapHandler {
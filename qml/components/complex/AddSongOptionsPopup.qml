@@ -7,10 +7,11 @@ Popup {
     id: root
 
     signal localImportRequested()
+    signal folderImportRequested()
     signal networkImportRequested()
 
     width: 280
-    height: 200
+    height: 260
     modal: true
     focus: true
     closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutside
@@ -114,6 +115,58 @@ Popup {
                 }
             }
 
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.preferredHeight: 50
+                color: folderImportHoverHandler.hovered ? Qt.lighter(AppStyles.primaryColor, 1.2) : AppStyles.primaryColor
+                radius: 6
+
+                Behavior on color {
+                    ColorAnimation {
+                        duration: AppStyles.shortAnimation
+                    }
+                }
+
+                RowLayout {
+                    anchors.fill: parent
+                    anchors.margins: AppStyles.mediumSpacing
+                    spacing: AppStyles.mediumSpacing
+
+                    ImageButton {
+                        Layout.preferredWidth: AppStyles.mediumIcon
+                        Layout.preferredHeight: AppStyles.mediumIcon
+                        source: AppStyles.importIcon
+
+                        onClicked: {
+                            root.folderImportRequested()
+                        }
+                    }
+
+                    Item {
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+
+                        Text {
+                            anchors.fill: parent
+                            text: qsTr("Add from local folder")
+                            font: AppStyles.bodyFont
+                            color: AppStyles.textPrimary
+                            horizontalAlignment: Text.AlignLeft
+                            verticalAlignment: Text.AlignVCenter
+                        }
+
+                        TapHandler {
+                            gesturePolicy: TapHandler.ReleaseWithinBounds
+                            onTapped: root.folderImportRequested()
+                        }
+                    }
+                }
+
+                HoverHandler {
+                    id: folderImportHoverHandler
+                }
+            }
+
             Rectangle {
                 Layout.fillWidth: true
                 Layout.preferredHeight: 50
@@ -20,8 +20,22 @@ Item {
 
             Image {
                 id: albumImage
+
+                // The 256px import thumbnail; older covers without one use the original.
+                property bool detailImageFailed: false
+                readonly property url detailImageSource: !!PlayerController.currentSong
+                    ? PlayerController.currentSong.detailImageSource : ""
+
                 anchors.fill: parent
-                source: !!PlayerController.currentSong ? PlayerController.currentSong.imageSource : ""
+                source: !!PlayerController.currentSong
+                        ? (detailImageFailed ? PlayerController.currentSong.imageSource : detailImageSource)
+                        : ""
+                onDetailImageSourceChanged: detailImageFailed = false
+                onStatusChanged: {
+                    if (status === Image.Error && source.toString() === detailImageSource.toString()) {
+                        detailImageFailed = true
+                    }
+                }
             }
 
             Video {
@@ -31,7 +31,7 @@ Item {
             anchors.margins: AppStyles.mediumSpacing
             
             visible: root.lyricsModel && root.lyricsModel.hasLyrics
-            model: root.lyricsModel ? root.lyricsModel.allLyrics : null
+            model: root.lyricsModel
             
             interactive: false
 
@@ -50,25 +50,22 @@ Item {
             
             delegate: Item {
                 id: lyricItem
-                required property int index
-                required property string modelData
+                required property string lyricText
+                required property bool isCurrent
 
                 width: lyricsListView.width
-                height: lyricText.height + AppStyles.smallSpacing * 2
+                height: lyricLabel.height + AppStyles.smallSpacing * 2
                 
                 Text {
-                    id: lyricText
+                    id: lyricLabel
                     anchors.centerIn: parent
                     width: parent.width - AppStyles.mediumSpacing * 2
                     
-                    text: lyricItem.modelData
-                    color: (root.lyricsModel && lyricItem.index === root.lyricsModel.currentLineIndex) ?
-                           root.highlightTextColor : root.primaryTextColor
+                    text: lyricItem.lyricText
+                    color: lyricItem.isCurrent ? root.highlightTextColor : root.primaryTextColor
                     
-                    font.pixelSize: (root.lyricsModel && lyricItem.index === root.lyricsModel.currentLineIndex) ?
-                                   AppStyles.titleFont.pixelSize : AppStyles.bodyFont.pixelSize
-                    font.weight: (root.lyricsModel && lyricItem.index === root.lyricsModel.currentLineIndex) ?
-                                Font.DemiBold : Font.Normal
+                    font.pixelSize: lyricItem.isCurrent ? AppStyles.titleFont.pixelSize : AppStyles.bodyFont.pixelSize
+                    font.weight: lyricItem.isCurrent ? Font.DemiBold : Font.Normal
                     
                     horizontalAlignment: Text.AlignHCenter
                     verticalAlignment: Text.AlignVCenter
@@ -88,7 +85,7 @@ Item {
                         }
                     }
                     
-                    opacity: (root.lyricsModel && lyricItem.index === root.lyricsModel.currentLineIndex) ? 1.0 : 0.7
+                    opacity: lyricItem.isCurrent ? 1.0 : 0.7
                     
                     Behavior on opacity {
                         NumberAnimation {
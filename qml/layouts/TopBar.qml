@@ -19,6 +19,14 @@ Item {
     signal searchResultsRequested()
     
     height: AppStyles.topBarHeight
+
+    Connections {
+        target: PlayerController
+
+        function onLyricSearchFinished(text, matches) {
+            PlaylistSearchModel.performLyricsSearch(PlayerController.getPlaylistAudioInfoList(), matches)
+        }
+    }
     
     Rectangle {
         id: topbar
@@ -43,6 +51,10 @@ Item {
                                 if (root.useNetworkSearch) {
                                     console.log("Network search triggered:", value)
                                     AudioSearchModel.searchSong(value)
+                                } else if (PlaylistSearchModel.searchScope === PlaylistSearchModel.LyricsScope) {
+                                    console.log("Lyrics search triggered:", value)
+                                    // Matches arrive through onLyricSearchFinished below.
+                                    PlayerController.searchLyrics(value)
                                 } else {
                                     var playlistData = PlayerController.getPlaylistAudioInfoList()
                                     console.log("Local search triggered:", value, "playlist data count:", playlistData.length)
@@ -53,6 +65,19 @@ Item {
                             }
             }
 
+            Button {
+                id: lyricsScopeButton
+                Layout.preferredHeight: AppStyles.controlBarHeight
+                visible: !root._searchPanelHidden && !root.useNetworkSearch
+                checkable: true
+                checked: PlaylistSearchModel.searchScope === PlaylistSearchModel.LyricsScope
+                text: "Lyrics"
+                onToggled: {
+                    PlaylistSearchModel.searchScope = checked ? PlaylistSearchModel.LyricsScope
+                                                              : PlaylistSearchModel.TrackScope
+                }
+            }
+
             Item {
                 Layout.fillWidth: true
                 visible: root._searchPanelHidden
@@ -29,11 +29,19 @@ Rectangle {
     RowLayout {
       Text {
         id: playlistText
-        Layout.fillWidth: true
         text: "Playlist"
         color: AppStyles.textPrimary
         font: AppStyles.titleFont
       }
+      Text {
+        id: totalDurationText
+        Layout.fillWidth: true
+        Layout.alignment: Qt.AlignBottom
+        // Stays in the layout while empty so the clear button keeps its place.
+        text: listview.model.totalDurationMs > 0 ? TimeUtils.formatTime(listview.model.totalDurationMs) : ""
+        color: AppStyles.textSecondary
+        font: AppStyles.smallFont
+      }
       ImageButton {
         id: clearButton
         Layout.alignment: Qt.AlignRight
@@ -61,7 +69,9 @@ Rectangle {
         audioTitle: model.audioTitle
         audioAuthor: model.audioAuthorName
         audioImageSource: model.audioImageSource
+        audioListImageSource: model.audioListImageSource
         audioSource: model.audioSource
+        audioDurationMs: model.audioDurationMs
         audioIndex: model.index
 
         itemColor: AppStyles.backgroundColor
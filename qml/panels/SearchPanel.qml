@@ -38,6 +38,9 @@ Rectangle {
       property url audioImageSource: model.audioImageSource || ""
       property url audioSource: model.audioSource || ""
       property int originalIndex: root.searchMode === "local" ? model.originalIndex : -1
+      // Set for lyric search hits: where the matching line is sung, and the line itself.
+      property real matchTimestamp: root.searchMode === "local" ? model.matchTimestamp : -1
+      property string matchedLyric: root.searchMode === "local" ? (model.matchedLyric || "") : ""
 
       width: listView.width
       height: AppStyles.listItemHeight
@@ -89,7 +92,8 @@ Rectangle {
         Text {
           Layout.fillWidth: true
 
-          text: delegate.audioAuthorName
+          text: delegate.matchedLyric !== "" ? delegate.audioAuthorName + " · " + delegate.matchedLyric
+                                             : delegate.audioAuthorName
           color: AppStyles.textSecondary
 
           fontSizeMode: Text.Fit
@@ -110,6 +114,9 @@ Rectangle {
             // Network search: add to playlist
             PlayerController.addNetworkAudio(delegate.audioTitle, delegate.audioAuthorName,
                                              delegate.audioSource, delegate.audioImageSource)
+          } else if (delegate.matchTimestamp >= 0) {
+            // Lyrics search: play the song from the matching line
+            PlayerController.switchToAudioAtPosition(delegate.originalIndex, delegate.matchTimestamp)
           } else {
             // Local search: play song directly
             PlayerController.switchToAudioByIndex(delegate.originalIndex)
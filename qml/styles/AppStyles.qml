@@ -70,6 +70,7 @@ QtObject {
     readonly property string searchIcon: "/qt/qml/MySongPlayer/assets/icons/search_icon.png"
     readonly property string menuIcon: "/qt/qml/MySongPlayer/assets/icons/menu_icon.png"
     readonly property string addIcon: "/qt/qml/MySongPlayer/assets/icons/add_icon.png"
+    readonly property string importIcon: "/qt/qml/MySongPlayer/assets/icons/import_icon.png"
     readonly property string closeIcon: "/qt/qml/MySongPlayer/assets/icons/close_icon.png"
     readonly property string trashIcon: "/qt/qml/MySongPlayer/assets/icons/trash_icon.png"
 
@@ -0,0 +1,52 @@
+#!/bin/bash
+#
+# 在两个 git 版本上分别构建并运行同一个基准，用于记录改动前后的数字。
+#
+#   scripts/compare-benchmark.sh <基准目标> <旧版本> <新版本> [基准参数...]
+#
+# 例如比较 user-038 前后的元数据读取 (冷缓存)：
+#   scripts/compare-benchmark.sh MySongPlayerMetadataBenchmark HEAD~1 HEAD --cold ~/Music
+#
+# 每个版本检出到 build/compare/ 下的独立 worktree，用 bench 预设 (Release) 构建，
+# 不影响当前工作区。两次运行使用相同参数，先旧后新，输出依次打印。
+
+set -euo pipefail
+
+if [ "$#" -lt 3 ]; then
+    echo "用法: $0 <基准目标> <旧版本> <新版本> [基准参数...]" >&2
+    exit 1
+fi
+
+readonly TARGET="$1"
+readonly BASE_REVISION="$2"
+readonly HEAD_REVISION="$3"
+shift 3
+
+SCRIPT_DIR=$(dirname "$(readlink -f "$0")")
+readonly PROJECT_ROOT=$(dirname "$SCRIPT_DIR")
+readonly COMPARE_ROOT="$PROJECT_ROOT/build/compare"
+
+run_revision() {
+    local revision="$1"
+    shift
+    local commit
+    commit=$(git -C "$PROJECT_ROOT" rev-parse --short "$revision")
+    local worktree="$COMPARE_ROOT/$commit"
+
+    if [ ! -d "$worktree" ]; then
+        git -C "$PROJECT_ROOT" worktree add --detach "$worktree" "$commit" >/dev/null
+    fi
+    # 旧版本可能还没有 bench 预设，因此直接传入缓存变量。
+    cmake -S "$worktree" -B "$worktree/build" -G Ninja \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DBUILD_TESTING=OFF \
+        -DMYSONGPLAYER_BUILD_BENCHMARKS=ON >/dev/null
+    cmake --build "$worktree/build" --target "$TARGET" >/dev/null
+
+    echo "== $revision ($commit)"
+    "$worktree/build/$TARGET" "$@"
+}
+
+mkdir -p "$COMPARE_ROOT"
+run_revision "$BASE_REVISION" "$@"
+run_revision "$HEAD_REVISION" "$@"
@@ -92,9 +92,10 @@ void AudioPlayer::setPosition(qint64 newPosition)
     m_mediaPlayer.setPosition(newPosition);
 }
 
-void AudioPlayer::setSource(const QUrl &source)
+void AudioPlayer::setSource(const QUrl &source, qint64 startPosition)
 {
     m_mediaPlayer.stop();
+    m_startPosition = startPosition;
     m_isNewMedia = true;  // To differentiate between a new media load and a simple position seek,
                           // ensuring that `initializeNewMedia` is only called for genuinely new tracks.
     m_mediaPlayer.setSource(source);
@@ -129,7 +130,9 @@ void AudioPlayer::initializeNewMedia()
     // Workaround for QMediaPlayer: Setting a small initial position (100ms) helps ensure
     // proper audio playback initiation for certain media formats that might have non-zero
     // start times or embedded video streams, preventing initial silence or glitches.
-    m_mediaPlayer.setPosition(100);
+    // A requested start position (e.g. a lyric search hit) lies past that point anyway.
+    m_mediaPlayer.setPosition(qMax<qint64>(100, m_startPosition));
+    m_startPosition = 0;
 
     if (m_playing) {
         m_mediaPlayer.play();
@@ -6,11 +6,23 @@
 #include "interfaces/IPlaylistOperations.h"
 #include "models/LyricsModel.h"
 #include "services/AudioImporter.h"
+#include "services/CoverCacheManager.h"
+#include "services/CoverThumbnails.h"
+#include "services/HttpLyricsProvider.h"
+#include "services/LibraryWatcher.h"
 #include "services/LyricsService.h"
 #include "services/PlaylistStorageService.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
 #include <QTimer>
+#include <QVariantMap>
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -25,6 +37,14 @@ bool isValidPlayMode(int value) noexcept
     return false;
 }
 
+LyricsQuery lyricsQueryFor(const AudioInfo &song)
+{
+    return LyricsQuery{
+        .artist = song.authorName(),
+        .title = song.title(),
+    };
+}
+
 } // namespace
 
 PlayerController::PlayerController(QObject *parent)
@@ -32,6 +52,8 @@ PlayerController::PlayerController(QObject *parent)
     , m_audioPlayer{new AudioPlayer(this)}
     , m_playlistModel{new PlaylistModel(this)}
     , m_audioImporter{new SongPlayer::AudioImporter(this)}
+    , m_libraryWatcher{new SongPlayer::LibraryWatcher(this)}
+    , m_coverCacheManager{new SongPlayer::CoverCacheManager(SongPlayer::CoverThumbnails::coverCacheDirectory(), this)}
     , m_lyricsService{new LyricsService(this)}
     , m_lyricsModel{new LyricsModel(this)}
     , m_playlistStorageService{new PlaylistStorageService{this}}
@@ -78,10 +100,14 @@ PlayerController::PlayerController(QObject *parent)
 
     connect(m_audioImporter, &SongPlayer::AudioImporter::audioImported,
             this, &PlayerController::onAudioImported);
+    connect(m_audioImporter, &SongPlayer::AudioImporter::audioRemoved,
+            this, &PlayerController::onAudioRemoved);
     connect(m_audioImporter, &SongPlayer::AudioImporter::importingChanged,
             this, &PlayerController::importingChanged);
     connect(m_audioImporter, &SongPlayer::AudioImporter::importProgressChanged,
             this, &PlayerController::importProgressChanged);
+    connect(m_audioImporter, &SongPlayer::AudioImporter::importQueueChanged,
+            this, &PlayerController::importQueueChanged);
     connect(m_audioImporter, &SongPlayer::AudioImporter::importStarted,
             this, &PlayerController::importStarted);
     connect(m_audioImporter, &SongPlayer::AudioImporter::importStarted,
@@ -95,6 +121,22 @@ PlayerController::PlayerController(QObject *parent)
     connect(m_audioImporter, &SongPlayer::AudioImporter::importFailed,
             this, &PlayerController::importFailed);
 
+    connect(m_libraryWatcher, &SongPlayer::LibraryWatcher::rescanRequested,
+            this, &PlayerController::onLibraryRescanRequested);
+
+    // Imports write covers; the cache is only trimmed between them.
+    connect(m_audioImporter, &SongPlayer::AudioImporter::importingChanged, this, [this]() {
+        m_coverCacheManager->setBusy(importing());
+    });
+    connect(m_coverCacheManager, &SongPlayer::CoverCacheManager::collectionDue,
+            this, &PlayerController::collectCoverCache);
+    connect(m_coverCacheManager, &SongPlayer::CoverCacheManager::collected,
+            this, [](int removedCovers, qint64 freedBytes) {
+        if (removedCovers > 0) {
+            qInfo() << "PlayerController: Removed" << removedCovers << "cached covers," << freedBytes << "bytes";
+        }
+    });
+
     connect(m_playlistModel, &PlaylistModel::duplicateAudioSkipped,
             this, &PlayerController::duplicateAudioSkipped);
 
@@ -102,6 +144,8 @@ PlayerController::PlayerController(QObject *parent)
             this, &PlayerController::onPlaylistChanged);
     connect(m_playlistModel, &PlaylistModel::rowsRemoved,
             this, &PlayerController::onPlaylistChanged);
+    connect(m_playlistModel, &PlaylistModel::dataChanged,
+            this, &PlayerController::onPlaylistChanged);
     connect(m_playlistModel, &PlaylistModel::currentSongChanged,
             this, &PlayerController::onPlaylistChanged);
     connect(m_playlistModel, &PlaylistModel::playModeChanged,
@@ -121,6 +165,11 @@ PlayerController::PlayerController(QObject *parent)
         }
     });
 
+    // Imported tracks only get library rows with a save, so their associations are
+    // refreshed after it.
+    connect(m_playlistStorageService, &PlaylistStorageService::playlistSaved,
+            this, &PlayerController::refreshLyricAssociations);
+
     loadDefaultPlaylistOnStartup();
 }
 
@@ -218,6 +267,41 @@ void PlayerController::switchToAudioByIndex(int index)
     m_currentSongManager->switchToAudioByIndex(index);
 }
 
+void PlayerController::switchToAudioAtPosition(int index, qint64 positionMs)
+{
+    if (index < 0 || index >= m_playlistModel->rowCount()) {
+        return;
+    }
+
+    m_pendingStartPositionMs = qMax<qint64>(0, positionMs);
+    switchToAudioByIndex(index);
+    if (m_pendingStartPositionMs >= 0) {
+        // Already the current track: no source change consumed the position, so seek.
+        m_audioPlayer->setPosition(std::exchange(m_pendingStartPositionMs, -1));
+    }
+}
+
+void PlayerController::searchLyrics(const QString &text)
+{
+    const quint64 generation{++m_lyricSearchGeneration};
+    m_playlistStorageService->searchLyricsAsync(text).then(
+        this, [this, generation, text](const std::vector<LyricSearchMatch> &found) {
+            // A newer search supersedes this one.
+            if (generation != m_lyricSearchGeneration) {
+                return;
+            }
+            QVariantList matches;
+            for (const LyricSearchMatch &match : found) {
+                matches.append(QVariantMap{
+                    {QStringLiteral("audioSource"), match.audioSource},
+                    {QStringLiteral("timestampMs"), match.timestampMs},
+                    {QStringLiteral("lyricText"), match.lineText},
+                });
+            }
+            emit lyricSearchFinished(text, matches);
+        });
+}
+
 bool PlayerController::addAudio(const QString &title, const QString &authorName,
                                 const QUrl &audioSource, const QUrl &imageSource,
                                 const QUrl &videoSource)
@@ -232,7 +316,7 @@ void PlayerController::removeAudio(int index)
 
 void PlayerController::clearPlaylist()
 {
-    if (importing()) {
+    if (!m_userImportBatches.isEmpty()) {
         emit importRejected(QStringLiteral("Wait for the active import or cancel it before clearing the playlist"));
         return;
     }
@@ -251,7 +335,7 @@ bool PlayerController::saveCurrentPlaylist(const QString &playlistName)
 
 bool PlayerController::loadPlaylist(const QString &playlistName)
 {
-    if (importing()) {
+    if (!m_userImportBatches.isEmpty()) {
         emit importRejected(QStringLiteral("Wait for the active import or cancel it before loading another playlist"));
         return false;
     }
@@ -278,10 +362,81 @@ QString PlayerController::currentPlaylistName() const
     return m_playlistPersistence->currentPlaylistName();
 }
 
-void PlayerController::importLocalAudio(const QList<QUrl> &fileUrls)
+int PlayerController::importLocalAudio(const QList<QUrl> &fileUrls)
+{
+    qDebug() << "PlayerController: Queueing local audio import for" << fileUrls.size() << "files";
+    const int batchId{m_audioImporter->importLocalAudio(fileUrls)};
+    if (batchId != 0) {
+        m_userImportBatches.insert(batchId);
+    }
+    return batchId;
+}
+
+int PlayerController::importAudioFolder(const QUrl &folderUrl, bool watchFolder)
+{
+    qDebug() << "PlayerController: Queueing folder import for" << folderUrl;
+    if (watchFolder && folderUrl.isLocalFile() && QFileInfo{folderUrl.toLocalFile()}.isDir()) {
+        if (!m_playlistStorageService->addLibraryFolder(folderUrl)) {
+            qWarning() << "PlayerController: Failed to register the library folder:"
+                       << m_playlistStorageService->lastError();
+        }
+        m_libraryWatcher->watchFolder(folderUrl);
+    }
+    // May join a queued background rescan of the folder, which then counts as the user's.
+    const int batchId{startFolderRescan(folderUrl, true, true)};
+    if (batchId != 0) {
+        m_userImportBatches.insert(batchId);
+    }
+    return batchId;
+}
+
+void PlayerController::unwatchLibraryFolder(const QUrl &folderUrl)
+{
+    if (!m_playlistStorageService->removeLibraryFolder(folderUrl)) {
+        qWarning() << "PlayerController: Failed to unregister the library folder:"
+                   << m_playlistStorageService->lastError();
+    }
+    m_libraryWatcher->unwatchFolder(folderUrl);
+    // Folders inside it were covered by its watch; they are watched on their own now.
+    for (const QUrl &remaining : m_playlistStorageService->libraryFolders()) {
+        m_libraryWatcher->watchFolder(remaining);
+    }
+}
+
+int PlayerController::startFolderRescan(const QUrl &folderUrl, bool recursive, bool restoreRemovedTracks)
 {
-    qDebug() << "PlayerController: Starting local audio import for" << fileUrls.size() << "files";
-    m_audioImporter->importLocalAudio(fileUrls);
+    // A recorded file missing from the playlist was removed by the user. Importing the
+    // folder again brings it back, so its tags must be read; a background rescan leaves
+    // it out until the file itself changes.
+    std::optional<QSet<QUrl>> playlistSources;
+    if (restoreRemovedTracks) {
+        playlistSources.emplace();
+        for (int row{0}; row < m_playlistModel->rowCount(); ++row) {
+            playlistSources->insert(m_playlistModel->getAudioInfoAtIndex(row)->audioSource());
+        }
+    }
+
+    // Only the folder's own fingerprints are read, on the importer's feeding task when
+    // the walk starts, so a burst of watcher events costs the GUI thread nothing. A file
+    // an earlier queued batch read first may not be recorded yet; the importer skips it
+    // as already read.
+    const int batchId{m_audioImporter->rescanDirectory(
+        folderUrl, recursive,
+        [readFingerprints = m_playlistStorageService->folderFingerprintsReader(folderUrl),
+         playlistSources = std::move(playlistSources)] {
+            SongPlayer::Core::FileFingerprints recorded;
+            for (const StoredFileFingerprint &stored : readFingerprints()) {
+                if (!playlistSources || playlistSources->contains(stored.audioSource)) {
+                    recorded.emplace(SongPlayer::QtAdapter::toLocalFilePath(stored.audioSource),
+                                     stored.fingerprint);
+                }
+            }
+            return recorded;
+        })};
+    if (batchId != 0) {
+        m_folderImportBatches.insert(batchId);
+    }
+    return batchId;
 }
 
 void PlayerController::cancelAudioImport()
@@ -289,6 +444,11 @@ void PlayerController::cancelAudioImport()
     m_audioImporter->cancelImport();
 }
 
+void PlayerController::cancelAudioImportBatch(int batchId)
+{
+    m_audioImporter->cancelImportBatch(batchId);
+}
+
 void PlayerController::addNetworkAudio(const QString &title, const QString &authorName,
                                        const QUrl &audioSource, const QUrl &imageSource)
 {
@@ -308,19 +468,104 @@ PlaylistModel *PlayerController::playlistModel() const
 void PlayerController::onAudioSourceChangeRequested(const QUrl &source)
 {
     qDebug() << "PlayerController: Setting audio source to:" << source.fileName();
-    m_audioPlayer->setSource(source);
+    m_audioPlayer->setSource(source, qMax<qint64>(0, std::exchange(m_pendingStartPositionMs, -1)));
     emit positionChanged();
 }
 
-void PlayerController::onAudioImported(const QString &title, const QString &authorName,
-                                       const QUrl &audioSource, const QUrl &imageSource)
+void PlayerController::onAudioImported(const QList<SongPlayer::ImportedTrack> &tracks)
+{
+    qDebug() << "PlayerController: Imported a chunk of" << tracks.size() << "audio files";
+    const int runningBatch{m_audioImporter->importBatchId()};
+    const bool refreshingProperties{m_propertyRefreshBatches.contains(runningBatch)};
+    const bool folderImport{m_folderImportBatches.contains(runningBatch)};
+    std::vector<SongPlayer::Core::AudioTrack> added;
+    added.reserve(static_cast<std::size_t>(tracks.size()));
+    for (const SongPlayer::ImportedTrack &imported : tracks) {
+        m_lyricsService->storeEmbeddedLyrics(imported.audioSource.toLocalFile(), imported.embeddedLyrics);
+        m_lyricAssociationSources.insert(imported.audioSource);
+        // Its embedded lyrics may be new even when its sidecar association stays.
+        m_lyricSearchSources.insert(imported.audioSource);
+        if (imported.fingerprint) {
+            m_importedFingerprints.push_back(StoredFileFingerprint{
+                .audioSource = imported.audioSource,
+                .fingerprint = *imported.fingerprint,
+            });
+        }
+        if (refreshingProperties) {
+            // Every playlist listing the track gets the properties, not only this one.
+            m_refreshedProperties.push_back(StoredAudioProperties{
+                .audioSource = imported.audioSource,
+                .properties = imported.properties,
+            });
+            m_playlistModel->updateAudio(imported.title, imported.authorName, imported.audioSource,
+                                         imported.imageSource, imported.properties);
+            continue;
+        }
+        if (folderImport
+            && m_playlistModel->updateAudio(imported.title, imported.authorName, imported.audioSource,
+                                            imported.imageSource, imported.properties)) {
+            continue;
+        }
+        SongPlayer::Core::AudioTrack track{SongPlayer::QtAdapter::makeCoreTrack(
+            imported.title, imported.authorName, imported.audioSource, imported.imageSource)};
+        track.properties = imported.properties;
+        added.push_back(std::move(track));
+    }
+    // One row insertion for the whole chunk.
+    m_playlistModel->addTracks(added);
+}
+
+void PlayerController::onAudioRemoved(const QUrl &audioSource)
+{
+    qDebug() << "PlayerController: Audio file is gone -" << audioSource;
+    const int runningBatch{m_audioImporter->importBatchId()};
+    if (m_folderImportBatches.contains(runningBatch) && !m_userImportBatches.contains(runningBatch)) {
+        // Nobody asked for this walk: the library forgets the file, but playlists keep
+        // their entries, which may only point at a folder that was renamed or moved.
+        m_forgottenLibraryFiles.push_back(audioSource);
+        return;
+    }
+    const int index{m_playlistModel->indexOfAudio(audioSource)};
+    if (index >= 0) {
+        m_playlistOperations->removeAudio(index);
+    }
+    m_removedLibraryFiles.push_back(audioSource);
+}
+
+void PlayerController::onLibraryRescanRequested(const QUrl &directoryUrl, bool recursive)
 {
-    qDebug() << "PlayerController: Audio imported successfully -" << title << "by" << authorName;
-    addAudio(title, authorName, audioSource, imageSource);
+    // Removed in the meantime; the watcher rescans its parent instead.
+    if (!QFileInfo{directoryUrl.toLocalFile()}.isDir()) {
+        return;
+    }
+    // Joins a queued rescan of the same directory if there is one.
+    startFolderRescan(directoryUrl, recursive, false);
+
+    // A sidecar added, renamed or removed here changes the associations of the tracks
+    // next to it, which a rescan alone does not touch.
+    const QString prefix{QDir::cleanPath(directoryUrl.toLocalFile()) + u'/'};
+    for (int row{0}; row < m_playlistModel->rowCount(); ++row) {
+        const QUrl source{m_playlistModel->getAudioInfoAtIndex(row)->audioSource()};
+        if (!source.isLocalFile()) {
+            continue;
+        }
+        const QString path{source.toLocalFile()};
+        if (path.startsWith(prefix) && (recursive || !path.mid(prefix.size()).contains(u'/'))) {
+            m_lyricAssociationSources.insert(source);
+        }
+    }
+    refreshLyricAssociations();
 }
 
 void PlayerController::onCurrentSongChanged()
 {
+    // Any lookup still running belongs to a song that is no longer current. Canceling
+    // stops it at the next stage and aborts its network request, if it has one; the
+    // generation check drops a result already in flight.
+    const quint64 generation{++m_lyricsGeneration};
+    m_pendingLyrics.cancel();
+    m_lyricsPrefetched = false;
+
     // Manages the state of the audio player and lyrics display based on the currently selected song.
     // If no song is selected, playback is stopped and lyrics are cleared to ensure a clean state.
     if (m_currentSongManager->currentSong() == nullptr) {
@@ -329,28 +574,136 @@ void PlayerController::onCurrentSongChanged()
         return;
     }
 
+    // Never leave the previous song's lyrics on screen while the new lookup runs.
+    m_lyricsModel->clearLyrics();
+
+    m_coverCacheManager->markUsed(m_currentSongManager->currentSong()->imageSource());
+
     // If a song is selected, attempt to load and display its lyrics.
-    // Lyrics are parsed from the audio file's local path, if available.
+    // Lyrics are looked up from the audio file's local path, if available, on the
+    // lyrics worker pool so slow storage never blocks the GUI thread.
     AudioInfo *currentSong{m_currentSongManager->currentSong()};
-    if (currentSong) {
-        const QString audioFilePath{currentSong->audioSource().toLocalFile()};
-        if (!audioFilePath.isEmpty()) {
-            auto lyrics{m_lyricsService->parseLrcFile(audioFilePath)};
-            m_lyricsModel->setLyrics(std::move(lyrics));
-        } else {
-            // Clear lyrics if the audio source is not a local file (e.g., network stream) or path is empty.
-            m_lyricsModel->clearLyrics();
+    const QString audioFilePath{currentSong->audioSource().toLocalFile()};
+    if (audioFilePath.isEmpty() && !m_remoteLyricsProvider) {
+        // Network streams have no local LRC or embedded lyric cache to consult.
+        return;
+    }
+
+    m_pendingLyrics = m_lyricsService->loadLyrics(
+        audioFilePath,
+        m_playlistStorageService->lyricAssociation(currentSong->audioSource()),
+        lyricsQueryFor(*currentSong));
+    if (m_pendingLyrics.isFinished()) {
+        // A prefetched result is applied in the same call so the first frame of the
+        // new song already shows its lyrics.
+        if (m_pendingLyrics.resultCount() > 0) {
+            m_lyricsModel->setLyrics(m_pendingLyrics.takeResult());
         }
-    } else {
-        // Fallback to clear lyrics if currentSong somehow becomes null after initial check.
-        m_lyricsModel->clearLyrics();
+        return;
     }
+
+    m_pendingLyrics.then(this, [this, generation](std::vector<SongPlayer::Core::LyricLine> lyrics) {
+        if (generation == m_lyricsGeneration) {
+            m_lyricsModel->setLyrics(std::move(lyrics));
+        }
+    });
 }
 
 void PlayerController::onPositionChanged()
 {
     const qint64 currentPosition{m_audioPlayer->position()};
     m_lyricsModel->updatePosition(currentPosition);
+
+    // Once per song, past the threshold, resolve the lyrics of the song that
+    // switchToNextSong() will pick so the track change finds them ready.
+    const qint64 totalDuration{m_audioPlayer->duration()};
+    if (m_lyricsPrefetched || totalDuration <= 0 ||
+        currentPosition < static_cast<qint64>(m_lyricsPrefetchThreshold * static_cast<double>(totalDuration))) {
+        return;
+    }
+    m_lyricsPrefetched = true;
+
+    AudioInfo *upcomingSong{m_currentSongManager->upcomingSong()};
+    if (upcomingSong && upcomingSong != m_currentSongManager->currentSong()) {
+        m_lyricsService->prefetchLyrics(
+            upcomingSong->audioSource().toLocalFile(),
+            m_playlistStorageService->lyricAssociation(upcomingSong->audioSource()),
+            lyricsQueryFor(*upcomingSong));
+    }
+}
+
+double PlayerController::lyricsPrefetchThreshold() const
+{
+    return m_lyricsPrefetchThreshold;
+}
+
+void PlayerController::setLyricsPrefetchThreshold(double threshold)
+{
+    threshold = std::clamp(threshold, 0.0, 1.0);
+    if (m_lyricsPrefetchThreshold == threshold) {
+        return;
+    }
+    m_lyricsPrefetchThreshold = threshold;
+    emit lyricsPrefetchThresholdChanged();
+}
+
+QUrl PlayerController::remoteLyricsEndpoint() const
+{
+    return m_remoteLyricsProvider ? m_remoteLyricsProvider->endpoint() : QUrl{};
+}
+
+void PlayerController::setRemoteLyricsEndpoint(const QUrl &endpoint)
+{
+    if (remoteLyricsEndpoint() == endpoint) {
+        return;
+    }
+
+    // Detach before deleting: lookups in flight cancel with the old provider.
+    m_lyricsService->setLyricsProvider(nullptr);
+    delete m_remoteLyricsProvider;
+    m_remoteLyricsProvider = nullptr;
+    if (endpoint.isValid() && !endpoint.isEmpty()) {
+        m_remoteLyricsProvider = new HttpLyricsProvider{endpoint, this};
+        m_lyricsService->setLyricsProvider(m_remoteLyricsProvider);
+    }
+    emit remoteLyricsEndpointChanged();
+}
+
+qint64 PlayerController::coverCacheMaxBytes() const
+{
+    return static_cast<qint64>(m_coverCacheManager->maxBytes());
+}
+
+void PlayerController::setCoverCacheMaxBytes(qint64 maxBytes)
+{
+    maxBytes = std::max<qint64>(maxBytes, 0);
+    if (coverCacheMaxBytes() == maxBytes) {
+        return;
+    }
+    m_coverCacheManager->setMaxBytes(static_cast<std::uint64_t>(maxBytes));
+    emit coverCacheMaxBytesChanged();
+}
+
+void PlayerController::collectCoverCache()
+{
+    // Covers of tracks that are only in the unsaved playlist count as referenced too.
+    std::vector<QUrl> playlistCovers;
+    for (int row{0}; row < m_playlistModel->rowCount(); ++row) {
+        if (const AudioInfo *song{m_playlistModel->getAudioInfoAtIndex(row)}) {
+            playlistCovers.push_back(song->imageSource());
+        }
+    }
+    // The library's covers are read off the GUI thread; a large library takes a while.
+    m_playlistStorageService->coverImageSourcesAsync().then(
+        this, [this, playlistCovers = std::move(playlistCovers)](std::vector<QUrl> referenced) {
+            // An import started meanwhile may write covers the list does not know yet;
+            // becoming idle again schedules the next collection.
+            if (importing()) {
+                return;
+            }
+            referenced.insert(referenced.end(), playlistCovers.begin(), playlistCovers.end());
+            m_coverCacheManager->collect(referenced);
+        });
 }
 
 LyricsModel* PlayerController::lyricsModel() const
@@ -373,6 +726,16 @@ int PlayerController::importTotal() const
     return m_audioImporter->importTotal();
 }
 
+bool PlayerController::importTotalKnown() const
+{
+    return m_audioImporter->importTotalKnown();
+}
+
+int PlayerController::queuedImportCount() const
+{
+    return m_audioImporter->queuedImportCount();
+}
+
 void PlayerController::onPlaylistChanged()
 {
     if (importing()) {
@@ -384,13 +747,34 @@ void PlayerController::onPlaylistChanged()
 
 void PlayerController::onImportStarted()
 {
-    m_playlistDirtyDuringImport = m_saveTimer->isActive();
+    // Later batches of a queue run keep what the earlier ones left unsaved.
+    m_playlistDirtyDuringImport = m_playlistDirtyDuringImport || m_saveTimer->isActive();
     m_saveTimer->stop();
 }
 
-void PlayerController::onImportFinished()
+void PlayerController::onImportFinished(int batchId)
 {
-    if (m_playlistDirtyDuringImport) {
+    m_folderImportBatches.remove(batchId);
+    m_userImportBatches.remove(batchId);
+    m_propertyRefreshBatches.remove(batchId);
+    if (!m_playlistStorageService->storeAudioProperties(m_refreshedProperties)) {
+        qWarning() << "PlayerController: Failed to store re-read audio properties:"
+                   << m_playlistStorageService->lastError();
+    }
+    m_refreshedProperties.clear();
+    if (!m_playlistStorageService->storeFileFingerprints(m_importedFingerprints) ||
+        !m_playlistStorageService->removeLibraryFiles(m_removedLibraryFiles) ||
+        !m_playlistStorageService->removeLibraryFiles(m_forgottenLibraryFiles, true)) {
+        qWarning() << "PlayerController: Failed to update the library fingerprints:"
+                   << m_playlistStorageService->lastError();
+    }
+    m_importedFingerprints.clear();
+    m_removedLibraryFiles.clear();
+    m_forgottenLibraryFiles.clear();
+
+    // The importer is already idle when its last queued batch reports, so a queue of
+    // batches ends in a single save.
+    if (m_playlistDirtyDuringImport && !importing()) {
         m_saveTimer->start();
         m_playlistDirtyDuringImport = false;
     }
@@ -411,5 +795,146 @@ void PlayerController::loadDefaultPlaylistOnStartup()
         } else {
             qDebug() << "Default playlist not found or empty, will create new default playlist";
         }
+        // Sidecars may have changed anywhere while the player was closed.
+        m_lyricAssociationsFullPass = true;
+        refreshLyricAssociations();
+
+        // Catch up with changes made while the player was closed, then keep watching.
+        for (const QUrl &folderUrl : m_playlistStorageService->libraryFolders()) {
+            m_libraryWatcher->watchFolder(folderUrl);
+            onLibraryRescanRequested(folderUrl, true);
+        }
+        refreshMissingAudioProperties();
+        m_coverCacheManager->scheduleCollection();
+    });
+}
+
+void PlayerController::refreshMissingAudioProperties()
+{
+    // Tracks imported before audio properties were read show no duration until their
+    // files are read once more. The batch only updates entries and never adds any.
+    m_playlistStorageService->tracksWithoutPropertiesAsync().then(this, [this](std::vector<QUrl> sources) {
+        if (sources.empty()) {
+            return;
+        }
+        qInfo() << "PlayerController: Reading audio properties of" << sources.size() << "older tracks";
+        const int batchId{m_audioImporter->importLocalAudio(QList<QUrl>(sources.cbegin(), sources.cend()))};
+        if (batchId != 0) {
+            m_propertyRefreshBatches.insert(batchId);
+        }
+    });
+}
+
+void PlayerController::refreshLyricAssociations()
+{
+    // One pass at a time; sources arriving meanwhile wait for a single follow-up.
+    if (m_lyricAssociationJob.isRunning()) {
+        return;
+    }
+
+    // Only the stored associations are read here, through indexed lookups; checking
+    // them against the file system happens on the lyrics pool.
+    std::vector<LyricsService::LyricAssociationEntry> entries;
+    if (m_lyricAssociationsFullPass) {
+        m_lyricSearchFullPass = true;
+        for (StoredLyricAssociation &stored : m_playlistStorageService->libraryLyricAssociations()) {
+            entries.push_back(LyricsService::LyricAssociationEntry{
+                .audioFilePath = stored.audioSource.toLocalFile(),
+                .association = std::move(stored.association),
+            });
+        }
+    } else {
+        entries.reserve(static_cast<std::size_t>(m_lyricAssociationSources.size()));
+        for (const QUrl &source : std::as_const(m_lyricAssociationSources)) {
+            if (source.isLocalFile()) {
+                entries.push_back(LyricsService::LyricAssociationEntry{
+                    .audioFilePath = source.toLocalFile(),
+                    .association = m_playlistStorageService->lyricAssociation(source),
+                });
+            }
+        }
+    }
+    m_lyricAssociationsFullPass = false;
+    m_lyricAssociationSources.clear();
+    if (entries.empty()) {
+        return;
+    }
+
+    m_lyricAssociationJob = m_lyricsService->resolveLyricAssociations(std::move(entries));
+    m_lyricAssociationJob.then(this, [this](std::vector<LyricsService::LyricAssociationEntry> changed) {
+        std::vector<StoredLyricAssociation> resolved;
+        resolved.reserve(changed.size());
+        for (LyricsService::LyricAssociationEntry &entry : changed) {
+            const QUrl audioSource{QUrl::fromLocalFile(entry.audioFilePath)};
+            m_lyricSearchSources.insert(audioSource);
+            resolved.push_back(StoredLyricAssociation{
+                .audioSource = audioSource,
+                .association = std::move(entry.association),
+            });
+        }
+        if (!resolved.empty() && !m_playlistStorageService->storeLyricAssociations(resolved)) {
+            qWarning() << "PlayerController: Failed to store lyric associations:"
+                       << m_playlistStorageService->lastError();
+        }
+        // Index lyrics only against settled associations.
+        if (m_lyricAssociationsFullPass || !m_lyricAssociationSources.isEmpty()) {
+            refreshLyricAssociations();
+        } else {
+            refreshLyricSearchIndex();
+        }
+    });
+}
+
+void PlayerController::refreshLyricSearchIndex()
+{
+    // Like the associations: one pass at a time, and only the tracks whose association
+    // changed or that were imported again, unless a whole-library pass is due.
+    if (m_lyricSearchJob.isRunning()) {
+        return;
+    }
+
+    std::vector<StoredLyricSearchSource> sources;
+    if (m_lyricSearchFullPass) {
+        sources = m_playlistStorageService->lyricSearchSources();
+    } else if (!m_lyricSearchSources.isEmpty()) {
+        const std::vector<QUrl> pending(m_lyricSearchSources.cbegin(), m_lyricSearchSources.cend());
+        sources = m_playlistStorageService->lyricSearchSources(pending);
+    }
+    m_lyricSearchFullPass = false;
+    m_lyricSearchSources.clear();
+
+    std::vector<LyricsService::LyricTextEntry> entries;
+    entries.reserve(sources.size());
+    for (StoredLyricSearchSource &stored : sources) {
+        entries.push_back(LyricsService::LyricTextEntry{
+            .audioFilePath = stored.audioSource.toLocalFile(),
+            .association = std::move(stored.association),
+            .indexed = stored.indexed,
+            .source = std::move(stored.indexedSource),
+            .lyrics = {},
+        });
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    m_lyricSearchJob = m_lyricsService->collectLyricText(std::move(entries));
+    m_lyricSearchJob.then(this, [this](std::vector<LyricsService::LyricTextEntry> changed) {
+        std::vector<IndexedLyricText> indexed;
+        indexed.reserve(changed.size());
+        for (LyricsService::LyricTextEntry &entry : changed) {
+            indexed.push_back(IndexedLyricText{
+                .audioSource = QUrl::fromLocalFile(entry.audioFilePath),
+                .source = std::move(entry.source),
+                .lyrics = std::move(entry.lyrics),
+            });
+        }
+        if (!indexed.empty() && !m_playlistStorageService->storeLyricSearchText(indexed)) {
+            qWarning() << "PlayerController: Failed to update the lyric search index:"
+                       << m_playlistStorageService->lastError();
+        }
+        if (m_lyricSearchFullPass || !m_lyricSearchSources.isEmpty()) {
+            refreshLyricSearchIndex();
+        }
     });
 }
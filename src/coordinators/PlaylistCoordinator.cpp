@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <optional>
+#include <utility>
 #include <vector>
 
 using std::nullopt;
@@ -30,16 +31,6 @@ optional<size_t> randomShuffleIndex(const PlaylistModel &playlistModel)
     return static_cast<size_t>(QRandomGenerator::global()->bounded(playlistModel.rowCount()));
 }
 
-bool addCoreTrack(PlaylistModel &playlistModel, const SongPlayer::Core::AudioTrack &track)
-{
-    return playlistModel.addAudio(
-        SongPlayer::QtAdapter::fromUtf8String(track.title),
-        SongPlayer::QtAdapter::fromUtf8String(track.authorName),
-        QUrl{SongPlayer::QtAdapter::fromUtf8String(track.audioSource)},
-        QUrl{SongPlayer::QtAdapter::fromUtf8String(track.imageSource)},
-        QUrl{SongPlayer::QtAdapter::fromUtf8String(track.videoSource)});
-}
-
 } // namespace
 
 PlaylistCoordinator::PlaylistCoordinator(PlaylistModel *playlistModel, PlaylistStorageService *storageService, QObject *parent)
@@ -52,6 +43,12 @@ PlaylistCoordinator::PlaylistCoordinator(PlaylistModel *playlistModel, PlaylistS
     // These connections are fundamental for updating the UI and managing playback flow.
     connect(m_playlistModel, &PlaylistModel::currentSongChanged,
             this, &PlaylistCoordinator::onCurrentSongChanged);
+    // A pending shuffle pick is an index, so any structural change or mode switch invalidates it.
+    const auto dropPendingShuffle{[this] { m_pendingShuffleIndex.reset(); }};
+    connect(m_playlistModel, &PlaylistModel::rowsInserted, this, dropPendingShuffle);
+    connect(m_playlistModel, &PlaylistModel::rowsRemoved, this, dropPendingShuffle);
+    connect(m_playlistModel, &PlaylistModel::modelReset, this, dropPendingShuffle);
+    connect(m_playlistModel, &PlaylistModel::playModeChanged, this, dropPendingShuffle);
     if (m_storageService) {
         // Connect signals from the storage service to react to playlist save, delete, and rename events.
         // This ensures that the coordinator's internal state and UI are synchronized with persistent storage changes.
@@ -81,14 +78,38 @@ void PlaylistCoordinator::setCurrentSong(AudioInfo *newCurrentSong)
 {
     m_playlistModel->setCurrentSong(newCurrentSong);
 }
+
+optional<size_t> PlaylistCoordinator::nextShuffleIndex()
+{
+    if (!m_pendingShuffleIndex) {
+        m_pendingShuffleIndex = randomShuffleIndex(*m_playlistModel);
+    }
+    return m_pendingShuffleIndex;
+}
+
+AudioInfo* PlaylistCoordinator::upcomingSong()
+{
+    if (!m_playlistModel) {
+        return nullptr;
+    }
+
+    // Reuse the shuffle pick for the actual switch so that whatever was prepared
+    // for the upcoming song (for example prefetched lyrics) is what gets played.
+    const optional<size_t> nextIndex{m_playlistModel->nextSongIndex(nextShuffleIndex())};
+    if (!nextIndex) {
+        return nullptr;
+    }
+    return m_playlistModel->getAudioInfoAtIndex(static_cast<int>(*nextIndex));
+}
+
 void PlaylistCoordinator::switchToNextSong()
 {
     if (!m_playlistModel) {
         return;
     }
 
-    const optional<size_t> nextIndex{m_playlistModel->nextSongIndex(
-        randomShuffleIndex(*m_playlistModel))};
+    const optional<size_t> nextIndex{m_playlistModel->nextSongIndex(nextShuffleIndex())};
+    m_pendingShuffleIndex.reset();
     if (!nextIndex) {
         return;
     }
@@ -183,9 +204,11 @@ bool PlaylistCoordinator::saveCurrentPlaylist(const QString &playlistName)
         if (!audioInfo) {
             continue;
         }
-        audioItems.push_back(SongPlayer::QtAdapter::makeCoreTrack(
+        SongPlayer::Core::AudioTrack track{SongPlayer::QtAdapter::makeCoreTrack(
             audioInfo->title(), audioInfo->authorName(), audioInfo->audioSource(),
-            audioInfo->imageSource(), audioInfo->videoSource()));
+            audioInfo->imageSource(), audioInfo->videoSource())};
+        track.properties = audioInfo->audioProperties();
+        audioItems.push_back(std::move(track));
     }
 
     // Determine the current playback mode and the index of the currently playing song.
@@ -231,7 +254,7 @@ bool PlaylistCoordinator::loadPlaylist(const QString &playlistName)
     // Add each audio item from the loaded playlist data to the playlist model.
     // This populates the UI with the songs from the loaded playlist.
     for (const SongPlayer::Core::AudioTrack &track : playlistInfo.audioItems) {
-        addCoreTrack(*m_playlistModel, track);
+        m_playlistModel->addTrack(track);
     }
 
     // Restore the saved play mode to ensure consistent playback behavior.
@@ -306,6 +329,7 @@ void PlaylistCoordinator::handlePlayFinished()
 
 void PlaylistCoordinator::onCurrentSongChanged()
 {
+    m_pendingShuffleIndex.reset();
     if (m_loadingPlaylist) {
         return;
     }
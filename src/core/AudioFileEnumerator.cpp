@@ -0,0 +1,63 @@
+#include "core/AudioFileEnumerator.h"
+
+#include "core/AudioImport.h"
+
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <utility>
+
+using std::nullopt;
+using std::optional;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer::Core {
+
+AudioFileEnumerator::AudioFileEnumerator(fs::path root, bool recursive)
+    : m_recursive{recursive}
+{
+    m_directories.push_back(std::move(root));
+}
+
+optional<fs::path> AudioFileEnumerator::next()
+{
+    while (m_files.empty()) {
+        if (m_directories.empty()) {
+            return nullopt;
+        }
+        const fs::path directory{std::move(m_directories.back())};
+        m_directories.pop_back();
+        list(directory);
+    }
+
+    fs::path file{std::move(m_files.back())};
+    m_files.pop_back();
+    return file;
+}
+
+void AudioFileEnumerator::list(const fs::path& directory)
+{
+    std::error_code error;
+    fs::directory_iterator entries{directory, fs::directory_options::skip_permission_denied, error};
+    vector<fs::path> subdirectories;
+    for (; !error && entries != fs::directory_iterator{}; entries.increment(error)) {
+        const fs::directory_entry& entry{*entries};
+        std::error_code statusError;
+        if (entry.is_directory(statusError)) {
+            if (m_recursive && !entry.is_symlink(statusError)) {
+                subdirectories.push_back(entry.path());
+            }
+        } else if (entry.is_regular_file(statusError) && isImportableAudioFile(entry.path())) {
+            m_files.push_back(entry.path());
+        }
+    }
+
+    std::ranges::sort(m_files, std::greater{});
+    std::ranges::sort(subdirectories, std::greater{});
+    m_directories.insert(m_directories.end(),
+                         std::make_move_iterator(subdirectories.begin()),
+                         std::make_move_iterator(subdirectories.end()));
+}
+
+} // namespace SongPlayer::Core
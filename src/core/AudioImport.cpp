@@ -1,9 +1,11 @@
 #include "core/AudioImport.h"
 
+#include "core/Hash.h"
+
 #include <array>
 #include <cctype>
 #include <charconv>
-#include <cstdint>
+#include <string>
 
 namespace SongPlayer::Core {
 namespace {
@@ -15,19 +17,9 @@ constexpr std::string_view kMimeUnknown = "image/unknown";
 constexpr std::string_view kExtensionJpeg = "jpg";
 constexpr std::string_view kExtensionPng = "png";
 constexpr std::string_view kExtensionUnknown = "img";
-
-constexpr std::uint64_t fnv1a(std::string_view value) noexcept
-{
-    constexpr std::uint64_t offsetBasis = 14695981039346656037ULL;
-    constexpr std::uint64_t prime = 1099511628211ULL;
-
-    std::uint64_t hash = offsetBasis;
-    for (const unsigned char byte : value) {
-        hash ^= byte;
-        hash *= prime;
-    }
-    return hash;
-}
+constexpr std::array<std::string_view, 7> kImportableAudioExtensions{
+    ".mp3", ".flac", ".ogg", ".opus", ".m4a", ".wav", ".wv",
+};
 
 bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept
 {
@@ -48,6 +40,17 @@ bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept
 
 } // namespace
 
+bool isImportableAudioFile(const std::filesystem::path& file)
+{
+    const std::string extension = file.extension().string();
+    for (const std::string_view importable : kImportableAudioExtensions) {
+        if (equalsIgnoreCase(extension, importable)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::string coverFileNameForAudioStem(std::string_view audioStem)
 {
     std::string result;
@@ -57,27 +60,48 @@ std::string coverFileNameForAudioStem(std::string_view audioStem)
     return result;
 }
 
-std::string coverFileNameForAudio(
-    std::string_view audioStem,
-    std::string_view sourceIdentity,
+std::string coverFileNameForImage(
+    std::string_view imageBytes,
     std::string_view extension)
 {
+    // The byte count next to the 64-bit hash keeps accidental collisions out of reach
+    // for any realistic library.
     std::array<char, 16> hashBuffer{};
-    const auto [hashEnd, error] = std::to_chars(
-        hashBuffer.data(), hashBuffer.data() + hashBuffer.size(), fnv1a(sourceIdentity), 16);
+    const auto [hashEnd, hashError] = std::to_chars(
+        hashBuffer.data(), hashBuffer.data() + hashBuffer.size(), fnv1a64(imageBytes), 16);
+    std::array<char, 20> sizeBuffer{};
+    const auto [sizeEnd, sizeError] = std::to_chars(
+        sizeBuffer.data(), sizeBuffer.data() + sizeBuffer.size(), imageBytes.size());
 
     std::string result;
-    result.reserve(audioStem.size() + hashBuffer.size() + extension.size() + 2);
-    result.append(audioStem);
-    result.push_back('_');
-    if (error == std::errc{}) {
+    result.reserve(hashBuffer.size() + sizeBuffer.size() + extension.size() + 2);
+    if (hashError == std::errc{}) {
         result.append(hashBuffer.data(), hashEnd);
     }
+    result.push_back('-');
+    if (sizeError == std::errc{}) {
+        result.append(sizeBuffer.data(), sizeEnd);
+    }
     result.push_back('.');
     result.append(extension.empty() ? kExtensionJpeg : extension);
     return result;
 }
 
+std::string coverThumbnailFileName(std::string_view coverFileName, int size)
+{
+    const std::size_t extension = coverFileName.rfind('.');
+    const std::string_view coverExtension = extension == std::string_view::npos
+        ? std::string_view{}
+        : coverFileName.substr(extension + 1);
+    const bool opaque = equalsIgnoreCase(coverExtension, kExtensionJpeg) || equalsIgnoreCase(coverExtension, "jpeg");
+
+    std::string result{coverFileName.substr(0, extension)};
+    result.push_back('@');
+    result.append(std::to_string(size));
+    result.append(opaque ? ".jpg" : ".png");
+    return result;
+}
+
 std::string_view imageMimeTypeForExtension(std::string_view extension) noexcept
 {
     if (equalsIgnoreCase(extension, "jpg") || equalsIgnoreCase(extension, "jpeg")) {
@@ -103,4 +127,15 @@ std::string_view imageExtensionForMimeType(std::string_view mimeType) noexcept
     return kExtensionUnknown;
 }
 
+std::string_view imageMimeTypeForData(std::string_view bytes) noexcept
+{
+    if (bytes.starts_with("\xFF\xD8\xFF")) {
+        return kMimeJpeg;
+    }
+    if (bytes.starts_with("\x89PNG\r\n\x1A\n")) {
+        return kMimePng;
+    }
+    return kMimeUnknown;
+}
+
 } // namespace SongPlayer::Core
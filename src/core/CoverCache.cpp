@@ -0,0 +1,163 @@
+#include "core/CoverCache.h"
+
+#include "core/AudioImport.h"
+#include "core/ThumbnailAtlas.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+using std::int64_t;
+using std::map;
+using std::size_t;
+using std::set;
+using std::string;
+using std::string_view;
+using std::uint64_t;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer::Core {
+namespace {
+
+int64_t toClockNs(fs::file_time_type time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+bool isTemporary(string_view fileName)
+{
+    return fileName.ends_with(".tmp");
+}
+
+// "<cover name>@<size>.jpg|png" -> "<cover name>"; anything else is its own entry.
+string thumbnailEntryName(const string& fileName)
+{
+    const size_t at{fileName.rfind('@')};
+    if (isTemporary(fileName) || at == string::npos
+        || !(fileName.ends_with(".jpg") || fileName.ends_with(".png"))) {
+        return fileName;
+    }
+    return fileName.substr(0, at);
+}
+
+void addFiles(map<string, CoverCacheEntry>& entries, const fs::path& directory, bool thumbnails)
+{
+    std::error_code error;
+    fs::directory_iterator files{directory, fs::directory_options::skip_permission_denied, error};
+    for (; !error && files != fs::directory_iterator{}; files.increment(error)) {
+        const fs::directory_entry& file{*files};
+        std::error_code statusError;
+        if (!file.is_regular_file(statusError)) {
+            continue;
+        }
+        const string fileName{file.path().filename().string()};
+        // The atlas, its temporary and its pending successor belong to the atlas.
+        if (!thumbnails && fileName.starts_with(kThumbnailAtlasFileName)) {
+            continue;
+        }
+        const uint64_t size{file.file_size(statusError)};
+        if (statusError) {
+            continue;
+        }
+        const fs::file_time_type modified{file.last_write_time(statusError)};
+        if (statusError) {
+            continue;
+        }
+
+        const string name{thumbnails ? thumbnailEntryName(fileName)
+                                     : isTemporary(fileName) ? fileName
+                                                             : coverCacheEntryName(file.path())};
+        CoverCacheEntry& entry{entries[name]};
+        entry.name = name;
+        entry.files.push_back(file.path());
+        entry.bytes += size;
+        entry.lastUsedNs = std::max(entry.lastUsedNs, toClockNs(modified));
+    }
+}
+
+} // namespace
+
+vector<CoverCacheEntry> scanCoverCache(const fs::path& directory)
+{
+    map<string, CoverCacheEntry> entries;
+    addFiles(entries, directory, false);
+    addFiles(entries, directory / string{kCoverThumbnailDirectoryName}, true);
+
+    vector<CoverCacheEntry> result;
+    result.reserve(entries.size());
+    for (auto& [name, entry] : entries) {
+        result.push_back(std::move(entry));
+    }
+    return result;
+}
+
+vector<CoverCacheEntry> planCoverCacheCollection(
+    vector<CoverCacheEntry> entries,
+    const set<string>& referenced,
+    uint64_t maxBytes,
+    int64_t orphanCutoffNs)
+{
+    // Oldest first, so eviction below takes the least recently used entries.
+    std::ranges::sort(entries, {}, &CoverCacheEntry::lastUsedNs);
+
+    vector<CoverCacheEntry> doomed;
+    vector<CoverCacheEntry> kept;
+    uint64_t keptBytes{0};
+    for (CoverCacheEntry& entry : entries) {
+        if (entry.lastUsedNs < orphanCutoffNs && !referenced.contains(entry.name)) {
+            doomed.push_back(std::move(entry));
+        } else {
+            keptBytes += entry.bytes;
+            kept.push_back(std::move(entry));
+        }
+    }
+
+    // Only orphans used within the grace period are left to evict; a track still
+    // showing a cover must not lose it to the cap.
+    for (CoverCacheEntry& entry : kept) {
+        if (keptBytes <= maxBytes) {
+            break;
+        }
+        if (referenced.contains(entry.name)) {
+            continue;
+        }
+        keptBytes -= entry.bytes;
+        doomed.push_back(std::move(entry));
+    }
+    return doomed;
+}
+
+uint64_t removeCoverCacheEntry(const CoverCacheEntry& entry) noexcept
+{
+    uint64_t freed{0};
+    for (const fs::path& file : entry.files) {
+        std::error_code error;
+        const uint64_t size{fs::file_size(file, error)};
+        if (!error && fs::remove(file, error)) {
+            freed += size;
+        }
+    }
+    return freed;
+}
+
+string coverCacheEntryName(const fs::path& coverFile)
+{
+    return coverFile.stem().string();
+}
+
+void markCoverUsed(const fs::path& coverFile) noexcept
+{
+    std::error_code error;
+    fs::last_write_time(coverFile, fs::file_time_type::clock::now(), error);
+}
+
+int64_t coverCacheClockNs() noexcept
+{
+    return toClockNs(fs::file_time_type::clock::now());
+}
+
+} // namespace SongPlayer::Core
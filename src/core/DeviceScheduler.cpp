@@ -0,0 +1,73 @@
+#include "core/DeviceScheduler.h"
+
+#include <algorithm>
+#include <numeric>
+
+using std::max;
+using std::nullopt;
+using std::optional;
+using std::size_t;
+
+namespace SongPlayer::Core {
+
+size_t DeviceScheduler::addDevice(int limit)
+{
+    m_limits.push_back(max(limit, 1));
+    m_running.push_back(0);
+    m_pending.emplace_back();
+    return m_limits.size() - 1;
+}
+
+void DeviceScheduler::append(size_t device)
+{
+    while (device >= m_limits.size()) {
+        static_cast<void>(addDevice(1));
+    }
+    m_pending[device].push_back(m_deviceOfItem.size());
+    m_deviceOfItem.push_back(device);
+    ++m_unclaimed;
+}
+
+optional<size_t> DeviceScheduler::claim(size_t endIndex)
+{
+    optional<size_t> selectedDevice;
+    for (size_t device{0}; device < m_pending.size(); ++device) {
+        const std::deque<size_t>& pending{m_pending[device]};
+        if (pending.empty() || m_running[device] >= m_limits[device] || pending.front() >= endIndex) {
+            continue;
+        }
+        if (!selectedDevice || pending.front() < m_pending[*selectedDevice].front()) {
+            selectedDevice = device;
+        }
+    }
+    if (!selectedDevice) {
+        return nullopt;
+    }
+
+    std::deque<size_t>& pending{m_pending[*selectedDevice]};
+    const size_t item{pending.front()};
+    pending.pop_front();
+    ++m_running[*selectedDevice];
+    --m_unclaimed;
+    return item;
+}
+
+void DeviceScheduler::release(size_t item)
+{
+    if (item < m_deviceOfItem.size()) {
+        int& running{m_running[m_deviceOfItem[item]]};
+        running = max(running - 1, 0);
+    }
+}
+
+bool DeviceScheduler::exhausted() const noexcept
+{
+    return m_unclaimed == 0;
+}
+
+int DeviceScheduler::usefulConcurrency() const noexcept
+{
+    return std::accumulate(m_limits.begin(), m_limits.end(), 0);
+}
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,40 @@
+#include "core/DirectoryTree.h"
+
+#include <system_error>
+
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer::Core {
+
+optional<vector<fs::path>> collectDirectoryTree(const fs::path& root, size_t limit)
+{
+    std::error_code error;
+    if (limit == 0 || !fs::is_directory(root, error)) {
+        return nullopt;
+    }
+
+    vector<fs::path> directories{root};
+    // directories doubles as the work list: everything past next is still unlisted.
+    for (size_t next{0}; next < directories.size(); ++next) {
+        fs::directory_iterator entries{directories[next], fs::directory_options::skip_permission_denied, error};
+        for (; !error && entries != fs::directory_iterator{}; entries.increment(error)) {
+            const fs::directory_entry& entry{*entries};
+            std::error_code statusError;
+            if (!entry.is_directory(statusError) || entry.is_symlink(statusError)) {
+                continue;
+            }
+            if (directories.size() == limit) {
+                return nullopt;
+            }
+            directories.push_back(entry.path());
+        }
+        error.clear();
+    }
+    return directories;
+}
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,62 @@
+#include "core/FileFingerprint.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+using std::optional;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer::Core {
+namespace {
+
+bool isInside(const fs::path& file, const fs::path& directory, bool recursive)
+{
+    if (!recursive) {
+        return file.parent_path() == directory;
+    }
+    // Component-wise, so "/music/a" does not contain "/music/ab/01.mp3".
+    const auto [directoryEnd, fileEnd] = std::mismatch(
+        directory.begin(), directory.end(), file.begin(), file.end());
+    return directoryEnd == directory.end() && fileEnd != file.end();
+}
+
+} // namespace
+
+LibraryRescan::LibraryRescan(const fs::path& root, bool recursive, FileFingerprints recorded)
+    : m_unseen{std::move(recorded)}
+{
+    // "/music/" iterates to a trailing empty component that no file path has.
+    const fs::path directory{root.has_filename() ? root : root.parent_path()};
+    std::erase_if(m_unseen, [&directory, recursive](const FileFingerprints::value_type& entry) {
+        return !isInside(entry.first, directory, recursive);
+    });
+}
+
+bool LibraryRescan::needsRead(const fs::path& file, const optional<FileFingerprint>& current)
+{
+    const auto recorded{m_unseen.find(file)};
+    if (recorded == m_unseen.end()) {
+        return true;
+    }
+    const bool unchanged{current && *current == recorded->second};
+    m_unseen.erase(recorded);
+    return !unchanged;
+}
+
+vector<fs::path> LibraryRescan::missingFiles() const
+{
+    vector<fs::path> missing;
+    for (const FileFingerprints::value_type& entry : m_unseen) {
+        // not_found covers ENOENT and ENOTDIR (a directory on the way became a file);
+        // EACCES or EIO say nothing about whether the file is still there.
+        std::error_code error;
+        if (fs::symlink_status(entry.first, error).type() == fs::file_type::not_found) {
+            missing.push_back(entry.first);
+        }
+    }
+    return missing;
+}
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,226 @@
+#include "core/LyricCache.h"
+
+#include "core/Hash.h"
+
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+using std::array;
+using std::int64_t;
+using std::memcpy;
+using std::numeric_limits;
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::span;
+using std::string;
+using std::string_view;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace SongPlayer::Core {
+namespace {
+
+constexpr array<char, 8> kMagic{'M', 'S', 'P', 'L', 'R', 'C', '\0', '\0'};
+constexpr uint32_t kFormatVersion{1};
+constexpr string_view kCacheExtension{".lrcbin"};
+
+// Native byte order: the cache lives in the per-user cache directory and is
+// never shared between machines.
+struct Header {
+    array<char, 8> magic{};
+    uint32_t version{0};
+    uint32_t lineCount{0};
+    uint64_t sourceSize{0};
+    int64_t sourceModifiedMs{0};
+    uint64_t pathBytes{0};
+    uint64_t textBytes{0};
+};
+
+static_assert(sizeof(Header) == 48);
+
+constexpr size_t alignedSize(size_t size) noexcept
+{
+    return (size + 7U) & ~size_t{7U};
+}
+
+template <typename T>
+void appendValue(string& output, const T& value)
+{
+    const auto* bytes{reinterpret_cast<const char*>(&value)};
+    output.append(bytes, sizeof(T));
+}
+
+void padToAlignment(string& output)
+{
+    output.resize(alignedSize(output.size()), '\0');
+}
+
+void appendFoldedKey(string& output, string_view value)
+{
+    const auto isBlank{[](char character) {
+        return std::isspace(static_cast<unsigned char>(character)) != 0;
+    }};
+    while (!value.empty() && isBlank(value.front())) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && isBlank(value.back())) {
+        value.remove_suffix(1);
+    }
+    for (const char character : value) {
+        output.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(character))));
+    }
+}
+
+template <typename T>
+T readValue(string_view bytes, size_t offset) noexcept
+{
+    T value{};
+    memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+string lyricCacheFileName(string_view sourcePath)
+{
+    array<char, 16> hashBuffer{};
+    const auto [hashEnd, error]{std::to_chars(
+        hashBuffer.data(), hashBuffer.data() + hashBuffer.size(), fnv1a64(sourcePath), 16)};
+
+    string result;
+    result.reserve(hashBuffer.size() + kCacheExtension.size());
+    if (error == std::errc{}) {
+        result.append(hashBuffer.data(), hashEnd);
+    }
+    result.append(kCacheExtension);
+    return result;
+}
+
+string encodeLyricCache(const LyricSourceIdentity& source, span<const LyricLine> lyrics)
+{
+    uint64_t textBytes{0};
+    for (const LyricLine& line : lyrics) {
+        textBytes += line.text.size();
+    }
+
+    if (lyrics.size() >= numeric_limits<uint32_t>::max() ||
+        textBytes > numeric_limits<uint32_t>::max()) {
+        return {};
+    }
+
+    const Header header{
+        .magic = kMagic,
+        .version = kFormatVersion,
+        .lineCount = static_cast<uint32_t>(lyrics.size()),
+        .sourceSize = source.size,
+        .sourceModifiedMs = source.modifiedMs,
+        .pathBytes = source.path.size(),
+        .textBytes = textBytes,
+    };
+
+    string output;
+    output.reserve(sizeof(Header) + alignedSize(source.path.size()) +
+                   lyrics.size() * (sizeof(int64_t) + sizeof(uint32_t)) +
+                   sizeof(uint64_t) + static_cast<size_t>(textBytes));
+    appendValue(output, header);
+    output.append(source.path);
+    padToAlignment(output);
+
+    for (const LyricLine& line : lyrics) {
+        appendValue(output, line.timestampMs);
+    }
+
+    uint32_t offset{0};
+    appendValue(output, offset);
+    for (const LyricLine& line : lyrics) {
+        offset += static_cast<uint32_t>(line.text.size());
+        appendValue(output, offset);
+    }
+    padToAlignment(output);
+
+    for (const LyricLine& line : lyrics) {
+        output.append(line.text);
+    }
+    return output;
+}
+
+optional<vector<LyricLine>> decodeLyricCache(
+    string_view bytes,
+    const LyricSourceIdentity& expectedSource)
+{
+    if (bytes.size() < sizeof(Header)) {
+        return nullopt;
+    }
+
+    const Header header{readValue<Header>(bytes, 0)};
+    if (header.magic != kMagic || header.version != kFormatVersion ||
+        header.sourceSize != expectedSource.size ||
+        header.sourceModifiedMs != expectedSource.modifiedMs ||
+        header.pathBytes != expectedSource.path.size() ||
+        header.textBytes > bytes.size()) {
+        return nullopt;
+    }
+
+    const size_t lineCount{header.lineCount};
+    if (lineCount > bytes.size() / sizeof(int64_t)) {
+        return nullopt;
+    }
+
+    const size_t pathOffset{sizeof(Header)};
+    const size_t timestampsOffset{pathOffset + alignedSize(expectedSource.path.size())};
+    const size_t offsetsOffset{timestampsOffset + lineCount * sizeof(int64_t)};
+    const size_t textOffset{offsetsOffset + alignedSize((lineCount + 1) * sizeof(uint32_t))};
+    if (textOffset > bytes.size() || bytes.size() - textOffset != header.textBytes) {
+        return nullopt;
+    }
+
+    if (bytes.substr(pathOffset, expectedSource.path.size()) != expectedSource.path) {
+        return nullopt;
+    }
+
+    const string_view text{bytes.substr(textOffset)};
+    vector<LyricLine> lyrics;
+    lyrics.reserve(lineCount);
+
+    uint32_t begin{readValue<uint32_t>(bytes, offsetsOffset)};
+    for (size_t index{0}; index < lineCount; ++index) {
+        const uint32_t end{readValue<uint32_t>(bytes, offsetsOffset + (index + 1) * sizeof(uint32_t))};
+        if (end < begin || end > text.size()) {
+            return nullopt;
+        }
+
+        lyrics.push_back(LyricLine{
+            .timestampMs = readValue<int64_t>(bytes, timestampsOffset + index * sizeof(int64_t)),
+            .text = string{text.substr(begin, end - begin)},
+        });
+        begin = end;
+    }
+
+    return lyrics;
+}
+
+LyricSourceIdentity remoteLyricSource(string_view artist, string_view title)
+{
+    // The scheme prefix keeps these keys apart from every absolute file path.
+    LyricSourceIdentity source{.path = "remote:", .size = 0, .modifiedMs = 0};
+    appendFoldedKey(source.path, artist);
+    source.path.push_back('\x1f');
+    appendFoldedKey(source.path, title);
+    return source;
+}
+
+bool lyricAssociationIsCurrent(
+    const LyricAssociation& stored,
+    int64_t currentDirectoryModifiedMs,
+    const optional<LyricSourceIdentity>& currentLrcFile) noexcept
+{
+    return stored.directoryModifiedMs == currentDirectoryModifiedMs &&
+           stored.lrcFile == currentLrcFile;
+}
+
+} // namespace SongPlayer::Core
@@ -1,11 +1,15 @@
 #include "core/Lyrics.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <charconv>
+#include <cstdio>
 #include <iterator>
 #include <string_view>
+#include <utility>
 
+using std::array;
 using std::distance;
 using std::errc;
 using std::find_if;
@@ -13,6 +17,7 @@ using std::from_chars;
 using std::int64_t;
 using std::isspace;
 using std::max;
+using std::min;
 using std::nullopt;
 using std::optional;
 using std::prev;
@@ -21,6 +26,7 @@ using std::span;
 using std::string;
 using std::string_view;
 using std::tolower;
+using std::uint16_t;
 using std::vector;
 namespace ranges = std::ranges;
 
@@ -203,6 +209,53 @@ vector<LyricLine> parseLrcContent(string_view content)
     return lyrics;
 }
 
+vector<LyricLine> parseEmbeddedLyrics(string_view content)
+{
+    vector<LyricLine> lyrics{parseLrcContent(content)};
+    if (!lyrics.empty()) {
+        return lyrics;
+    }
+
+    for (string_view rawLine : splitLines(content)) {
+        string text{trim(rawLine)};
+        if (!text.empty()) {
+            lyrics.push_back(LyricLine{.timestampMs = kUnsyncedLyricTimestamp, .text = std::move(text)});
+        }
+    }
+    return lyrics;
+}
+
+string formatLrcTimestamp(int64_t timestampMs)
+{
+    const int64_t clamped{max(timestampMs, int64_t{0})};
+    const int64_t minutes{clamped / 60000};
+    const int64_t seconds{(clamped / 1000) % 60};
+    const int64_t centiseconds{(clamped % 1000) / 10};
+
+    array<char, 32> buffer{};
+    const int written{std::snprintf(buffer.data(), buffer.size(), "[%02lld:%02lld.%02lld]",
+                                    static_cast<long long>(minutes),
+                                    static_cast<long long>(seconds),
+                                    static_cast<long long>(centiseconds))};
+    if (written <= 0) {
+        return {};
+    }
+    return {buffer.data(), static_cast<size_t>(written)};
+}
+
+string formatLrcContent(span<const LyricLine> lyrics)
+{
+    string content;
+    for (const LyricLine& line : lyrics) {
+        if (line.timestampMs != kUnsyncedLyricTimestamp) {
+            content.append(formatLrcTimestamp(line.timestampMs));
+        }
+        content.append(line.text);
+        content.push_back('\n');
+    }
+    return content;
+}
+
 optional<size_t> lyricIndexAtPosition(span<const LyricLine> lyrics, int64_t positionMs)
 {
     const auto iterator{ranges::upper_bound(
@@ -211,13 +264,50 @@ optional<size_t> lyricIndexAtPosition(span<const LyricLine> lyrics, int64_t posi
         {},
         &LyricLine::timestampMs)};
 
-    if (iterator == lyrics.begin()) {
+    // Unsynchronized lines sort first and are never treated as the active line.
+    if (iterator == lyrics.begin() || prev(iterator)->timestampMs < 0) {
         return nullopt;
     }
 
     return static_cast<size_t>(distance(lyrics.begin(), prev(iterator)));
 }
 
+string lyricSearchExpression(string_view text)
+{
+    string expression;
+    size_t cursor{0};
+    while (cursor < text.size()) {
+        while (cursor < text.size() && isspace(static_cast<unsigned char>(text[cursor]))) {
+            ++cursor;
+        }
+        const size_t wordStart{cursor};
+        while (cursor < text.size() && !isspace(static_cast<unsigned char>(text[cursor]))) {
+            ++cursor;
+        }
+        if (wordStart == cursor) {
+            break;
+        }
+
+        if (!expression.empty()) {
+            expression.push_back(' ');
+        }
+        expression.push_back('"');
+        for (const char character : text.substr(wordStart, cursor - wordStart)) {
+            if (character == '"') {
+                expression.push_back('"');
+            }
+            expression.push_back(character);
+        }
+        expression.push_back('"');
+    }
+
+    // Search-as-you-type: the word still being typed matches every completion of it.
+    if (!expression.empty()) {
+        expression.push_back('*');
+    }
+    return expression;
+}
+
 string normalizeLyricFileName(string_view fileName)
 {
     string result;
@@ -237,10 +327,33 @@ string normalizeLyricFileName(string_view fileName)
     return trim(result);
 }
 
+LyricFileName prepareLyricFileName(string_view fileName)
+{
+    LyricFileName result{.normalized = normalizeLyricFileName(fileName), .bigrams = {}};
+    const string& text{result.normalized};
+    if (text.size() < 2) {
+        return result;
+    }
+
+    result.bigrams.reserve(text.size() - 1);
+    for (size_t index{0}; index + 1 < text.size(); ++index) {
+        const auto high{static_cast<unsigned char>(text[index])};
+        const auto low{static_cast<unsigned char>(text[index + 1])};
+        result.bigrams.push_back(static_cast<uint16_t>((high << 8U) | low));
+    }
+    ranges::sort(result.bigrams);
+    return result;
+}
+
 double lyricFileMatchScore(string_view audioName, string_view lrcName)
 {
-    const string cleanAudio{normalizeLyricFileName(audioName)};
-    const string cleanLrc{normalizeLyricFileName(lrcName)};
+    return lyricFileMatchScore(prepareLyricFileName(audioName), prepareLyricFileName(lrcName));
+}
+
+double lyricFileMatchScore(const LyricFileName& audioName, const LyricFileName& lrcName) noexcept
+{
+    const string& cleanAudio{audioName.normalized};
+    const string& cleanLrc{lrcName.normalized};
 
     if (cleanAudio.empty() || cleanLrc.empty()) {
         return 0.0;
@@ -252,7 +365,7 @@ double lyricFileMatchScore(string_view audioName, string_view lrcName)
 
     if (cleanLrc.find(cleanAudio) != string::npos) {
         const double lengthRatio{static_cast<double>(cleanAudio.size()) /
-                                 static_cast<double>(lrcName.size())};
+                                 static_cast<double>(cleanLrc.size())};
         return 80.0 + (lengthRatio * 15.0);
     }
 
@@ -262,15 +375,56 @@ double lyricFileMatchScore(string_view audioName, string_view lrcName)
         return 75.0 + (lengthRatio * 10.0);
     }
 
-    int commonCharacters{0};
-    const size_t maxLength{max(cleanAudio.size(), cleanLrc.size())};
-    for (char character : cleanAudio) {
-        if (cleanLrc.find(character) != string::npos) {
-            ++commonCharacters;
+    const vector<uint16_t>& lhs{audioName.bigrams};
+    const vector<uint16_t>& rhs{lrcName.bigrams};
+    if (lhs.empty() || rhs.empty()) {
+        return 0.0;
+    }
+
+    // Sorensen-Dice over sorted bigram multisets: one linear merge per candidate.
+    size_t shared{0};
+    auto left{lhs.begin()};
+    auto right{rhs.begin()};
+    while (left != lhs.end() && right != rhs.end()) {
+        if (*left < *right) {
+            ++left;
+        } else if (*right < *left) {
+            ++right;
+        } else {
+            ++shared;
+            ++left;
+            ++right;
+        }
+    }
+
+    const double dice{(2.0 * static_cast<double>(shared)) /
+                      static_cast<double>(lhs.size() + rhs.size())};
+    // A fuzzy match never outranks a name that contains the other one outright.
+    return min(dice * 100.0, 74.0);
+}
+
+optional<LyricFileMatch> bestLyricFileMatch(
+    string_view audioName,
+    span<const LyricFileName> candidates,
+    double threshold)
+{
+    const LyricFileName preparedAudio{prepareLyricFileName(audioName)};
+    if (preparedAudio.normalized.empty()) {
+        return nullopt;
+    }
+
+    optional<LyricFileMatch> best;
+    for (size_t index{0}; index < candidates.size(); ++index) {
+        const double score{lyricFileMatchScore(preparedAudio, candidates[index])};
+        if (score >= threshold && (!best || score > best->score)) {
+            best = LyricFileMatch{.candidateIndex = index, .score = score};
+            if (score >= 100.0) {
+                break;
+            }
         }
     }
 
-    return (static_cast<double>(commonCharacters) / static_cast<double>(maxLength)) * 60.0;
+    return best;
 }
 
 } // namespace SongPlayer::Core
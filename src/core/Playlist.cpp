@@ -82,6 +82,16 @@ bool Playlist::removeTrack(size_t index)
     return true;
 }
 
+bool Playlist::replaceTrack(size_t index, AudioTrack track)
+{
+    if (index >= m_tracks.size() || track.audioSource != m_tracks[index].audioSource) {
+        return false;
+    }
+
+    m_tracks[index] = std::move(track);
+    return true;
+}
+
 void Playlist::clear()
 {
     m_tracks.clear();
@@ -112,11 +122,27 @@ span<const AudioTrack> Playlist::tracks() const noexcept
     return m_tracks;
 }
 
+std::int64_t Playlist::totalDurationMs() const noexcept
+{
+    std::int64_t total{0};
+    for (const AudioTrack& track : m_tracks) {
+        total += track.properties.durationMs;
+    }
+    return total;
+}
+
 bool Playlist::containsSource(string_view audioSource) const
 {
-    return ranges::any_of(m_tracks, [audioSource](const AudioTrack& track) {
-        return track.audioSource == audioSource;
-    });
+    return indexOfSource(audioSource).has_value();
+}
+
+optional<size_t> Playlist::indexOfSource(string_view audioSource) const
+{
+    const auto found{ranges::find(m_tracks, audioSource, &AudioTrack::audioSource)};
+    if (found == m_tracks.end()) {
+        return nullopt;
+    }
+    return static_cast<size_t>(found - m_tracks.begin());
 }
 
 PlayMode Playlist::playMode() const noexcept
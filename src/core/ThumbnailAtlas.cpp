@@ -0,0 +1,217 @@
+#include "core/ThumbnailAtlas.h"
+
+#include "core/Hash.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using std::array;
+using std::memcpy;
+using std::numeric_limits;
+using std::nullopt;
+using std::optional;
+using std::ostream;
+using std::size_t;
+using std::span;
+using std::string_view;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace SongPlayer::Core {
+namespace {
+
+constexpr array<char, 8> kMagic{'M', 'S', 'P', 'T', 'H', 'M', 'B', '1'};
+constexpr uint32_t kFormatVersion{1};
+constexpr uint32_t kMaxTileSize{1024};
+constexpr size_t kBytesPerPixel{4};
+// The pixel area starts on a cache line; with 64px tiles every tile does too.
+constexpr size_t kPixelAlignment{64};
+
+// Native byte order: the atlas lives in the per-user cache directory and is
+// never shared between machines.
+struct Header {
+    array<char, 8> magic{};
+    uint32_t version{0};
+    uint32_t tileSize{0};
+    uint64_t tileCount{0};
+};
+
+struct IndexEntry {
+    uint64_t key{0};
+    uint32_t width{0};
+    uint32_t height{0};
+};
+
+static_assert(sizeof(Header) == 24);
+static_assert(sizeof(IndexEntry) == 16);
+
+constexpr size_t pixelOffset(size_t tileCount) noexcept
+{
+    const size_t indexEnd{sizeof(Header) + tileCount * sizeof(IndexEntry)};
+    return (indexEnd + kPixelAlignment - 1) & ~(kPixelAlignment - 1);
+}
+
+constexpr size_t tileBytes(uint32_t tileSize) noexcept
+{
+    return size_t{tileSize} * tileSize * kBytesPerPixel;
+}
+
+template <typename T>
+void writeValue(ostream& output, const T& value)
+{
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeZeros(ostream& output, size_t count)
+{
+    constexpr array<char, 4096> zeros{};
+    while (count > 0) {
+        const size_t chunk{std::min(count, zeros.size())};
+        output.write(zeros.data(), static_cast<std::streamsize>(chunk));
+        count -= chunk;
+    }
+}
+
+template <typename T>
+T readValue(string_view bytes, size_t offset) noexcept
+{
+    T value{};
+    memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+bool tileFits(const ThumbnailTile& tile, uint32_t tileSize) noexcept
+{
+    return tile.width > 0 && tile.height > 0 && tile.width <= tileSize && tile.height <= tileSize &&
+           tile.pixels.size() >= size_t{tile.height} * tileSize * kBytesPerPixel;
+}
+
+} // namespace
+
+uint64_t thumbnailAtlasKey(string_view coverFileName) noexcept
+{
+    return fnv1a64(coverFileName.substr(0, coverFileName.rfind('.')));
+}
+
+bool writeThumbnailAtlas(ostream& output, uint32_t tileSize, span<const ThumbnailTile> tiles)
+{
+    if (tileSize == 0 || tileSize > kMaxTileSize) {
+        return false;
+    }
+
+    vector<const ThumbnailTile*> ordered;
+    ordered.reserve(tiles.size());
+    for (const ThumbnailTile& tile : tiles) {
+        if (tileFits(tile, tileSize)) {
+            ordered.push_back(&tile);
+        }
+    }
+    std::ranges::stable_sort(ordered, {}, &ThumbnailTile::key);
+    // Keep the last tile of each run of equal keys.
+    vector<const ThumbnailTile*> unique;
+    unique.reserve(ordered.size());
+    for (const ThumbnailTile* tile : ordered) {
+        if (!unique.empty() && unique.back()->key == tile->key) {
+            unique.back() = tile;
+        } else {
+            unique.push_back(tile);
+        }
+    }
+
+    const Header header{
+        .magic = kMagic,
+        .version = kFormatVersion,
+        .tileSize = tileSize,
+        .tileCount = unique.size(),
+    };
+    const size_t rowBytes{size_t{tileSize} * kBytesPerPixel};
+
+    writeValue(output, header);
+    for (const ThumbnailTile* tile : unique) {
+        writeValue(output, IndexEntry{.key = tile->key, .width = tile->width, .height = tile->height});
+    }
+    writeZeros(output, pixelOffset(unique.size()) - sizeof(Header) - unique.size() * sizeof(IndexEntry));
+
+    for (const ThumbnailTile* tile : unique) {
+        const size_t used{size_t{tile->height} * rowBytes};
+        output.write(tile->pixels.data(), static_cast<std::streamsize>(used));
+        writeZeros(output, tileBytes(tileSize) - used);
+    }
+    return static_cast<bool>(output);
+}
+
+optional<ThumbnailAtlasView> ThumbnailAtlasView::open(string_view bytes)
+{
+    if (bytes.size() < sizeof(Header)) {
+        return nullopt;
+    }
+    const auto header{readValue<Header>(bytes, 0)};
+    if (header.magic != kMagic || header.version != kFormatVersion ||
+        header.tileSize == 0 || header.tileSize > kMaxTileSize ||
+        header.tileCount > (numeric_limits<size_t>::max() - kPixelAlignment) / sizeof(IndexEntry)) {
+        return nullopt;
+    }
+
+    const auto tileCount{static_cast<size_t>(header.tileCount)};
+    const size_t offset{pixelOffset(tileCount)};
+    if (offset > bytes.size() ||
+        (bytes.size() - offset) / tileBytes(header.tileSize) < tileCount) {
+        return nullopt;
+    }
+
+    uint64_t previousKey{0};
+    for (size_t index{0}; index < tileCount; ++index) {
+        const auto entry{readValue<IndexEntry>(bytes, sizeof(Header) + index * sizeof(IndexEntry))};
+        if ((index > 0 && entry.key <= previousKey) ||
+            entry.width == 0 || entry.height == 0 ||
+            entry.width > header.tileSize || entry.height > header.tileSize) {
+            return nullopt;
+        }
+        previousKey = entry.key;
+    }
+    return ThumbnailAtlasView{bytes, header.tileSize, tileCount};
+}
+
+ThumbnailAtlasView::ThumbnailAtlasView(string_view bytes, uint32_t tileSize, size_t tileCount) noexcept
+    : m_bytes{bytes}
+    , m_tileSize{tileSize}
+    , m_tileCount{tileCount}
+{
+}
+
+ThumbnailTile ThumbnailAtlasView::tileAt(size_t index) const noexcept
+{
+    const auto entry{readValue<IndexEntry>(m_bytes, sizeof(Header) + index * sizeof(IndexEntry))};
+    const size_t size{tileBytes(m_tileSize)};
+    return ThumbnailTile{
+        .key = entry.key,
+        .width = entry.width,
+        .height = entry.height,
+        .pixels = m_bytes.substr(pixelOffset(m_tileCount) + index * size, size),
+    };
+}
+
+optional<ThumbnailTile> ThumbnailAtlasView::find(uint64_t key) const noexcept
+{
+    size_t low{0};
+    size_t high{m_tileCount};
+    while (low < high) {
+        const size_t middle{low + (high - low) / 2};
+        const auto middleKey{readValue<uint64_t>(m_bytes, sizeof(Header) + middle * sizeof(IndexEntry))};
+        if (middleKey == key) {
+            return tileAt(middle);
+        }
+        if (middleKey < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return nullopt;
+}
+
+} // namespace SongPlayer::Core
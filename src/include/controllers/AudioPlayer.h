@@ -30,7 +30,8 @@ public:
     void playPause();
     void stop();
     void setPosition(qint64 newPosition);
-    void setSource(const QUrl &source);
+    // Playback of the new source starts at startPosition once the media has loaded.
+    void setSource(const QUrl &source, qint64 startPosition = 0);
 
 signals:
     void playingChanged();
@@ -51,6 +52,7 @@ private:
     QAudioOutput *m_audioOutput;
     bool m_playing = false;
     bool m_isNewMedia = false;
+    qint64 m_startPosition = 0;
     float m_volume = 0.5f; // Initial volume set to 50%
     bool m_muted = false;
 };
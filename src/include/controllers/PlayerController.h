@@ -1,26 +1,32 @@
 #pragma once
 
+#include <QFuture>
 #include <QList>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QVariantList>
 #include <QtQml/qqmlregistration.h>
 
 #include "models/LyricsModel.h"
 #include "models/PlaylistModel.h"
+#include "services/AudioImporter.h"
+#include "services/LyricsService.h"
+#include "services/PlaylistStorageService.h"
 
 class AudioInfo;
 class AudioPlayer;
+class HttpLyricsProvider;
 class ICurrentSongManager;
 class IPlaylistOperations;
 class IPlaylistPersistence;
-class LyricsService;
-class PlaylistStorageService;
 class QTimer;
 
 namespace SongPlayer {
-class AudioImporter;
+class CoverCacheManager;
+class LibraryWatcher;
 }
 
 class PlayerController : public QObject
@@ -40,6 +46,14 @@ class PlayerController : public QObject
     Q_PROPERTY(bool importing READ importing NOTIFY importingChanged)
     Q_PROPERTY(int importCompleted READ importCompleted NOTIFY importProgressChanged)
     Q_PROPERTY(int importTotal READ importTotal NOTIFY importProgressChanged)
+    Q_PROPERTY(bool importTotalKnown READ importTotalKnown NOTIFY importProgressChanged)
+    Q_PROPERTY(int queuedImportCount READ queuedImportCount NOTIFY importQueueChanged)
+    Q_PROPERTY(double lyricsPrefetchThreshold READ lyricsPrefetchThreshold
+               WRITE setLyricsPrefetchThreshold NOTIFY lyricsPrefetchThresholdChanged)
+    Q_PROPERTY(QUrl remoteLyricsEndpoint READ remoteLyricsEndpoint
+               WRITE setRemoteLyricsEndpoint NOTIFY remoteLyricsEndpointChanged)
+    Q_PROPERTY(qint64 coverCacheMaxBytes READ coverCacheMaxBytes
+               WRITE setCoverCacheMaxBytes NOTIFY coverCacheMaxBytesChanged)
 
 public:
     explicit PlayerController(QObject *parent = nullptr);
@@ -66,12 +80,31 @@ public:
     bool importing() const;
     int importCompleted() const;
     int importTotal() const;
+    bool importTotalKnown() const;
+    int queuedImportCount() const;
+
+    // Fraction of the current track after which the next track's lyrics are prefetched.
+    double lyricsPrefetchThreshold() const;
+    void setLyricsPrefetchThreshold(double threshold);
+
+    // LRC-serving HTTP endpoint asked for tracks without local lyrics; empty disables it.
+    QUrl remoteLyricsEndpoint() const;
+    void setRemoteLyricsEndpoint(const QUrl &endpoint);
+
+    // Size the cover cache is trimmed to while the player is idle.
+    qint64 coverCacheMaxBytes() const;
+    void setCoverCacheMaxBytes(qint64 maxBytes);
 
     Q_INVOKABLE void playPause();
     Q_INVOKABLE void setPosition(qint64 newPosition);
     Q_INVOKABLE void switchToNextSong();
     Q_INVOKABLE void switchToPreviousSong();
     Q_INVOKABLE void switchToAudioByIndex(int index);
+    // Switches to the track and starts it at positionMs, e.g. at a lyric search hit.
+    Q_INVOKABLE void switchToAudioAtPosition(int index, qint64 positionMs);
+    // Full-text search over the indexed lyrics of the whole library, run off the GUI
+    // thread. lyricSearchFinished() delivers the matches of the latest search only.
+    Q_INVOKABLE void searchLyrics(const QString &text);
 
     Q_INVOKABLE bool addAudio(const QString &title,
                               const QString &authorName,
@@ -89,8 +122,14 @@ public:
     Q_INVOKABLE bool renamePlaylist(const QString &oldName, const QString &newName);
     Q_INVOKABLE QString currentPlaylistName() const;
 
-    Q_INVOKABLE void importLocalAudio(const QList<QUrl> &fileUrls);
+    // Both return the id of the queued import batch, 0 when it was rejected.
+    Q_INVOKABLE int importLocalAudio(const QList<QUrl> &fileUrls);
+    // With watchFolder the folder is also registered as a library folder: rescanned at
+    // every start and watched for changes until unwatchLibraryFolder().
+    Q_INVOKABLE int importAudioFolder(const QUrl &folderUrl, bool watchFolder = false);
+    Q_INVOKABLE void unwatchLibraryFolder(const QUrl &folderUrl);
     Q_INVOKABLE void cancelAudioImport();
+    Q_INVOKABLE void cancelAudioImportBatch(int batchId);
     Q_INVOKABLE void addNetworkAudio(const QString &title,
                                      const QString &authorName,
                                      const QUrl &audioSource,
@@ -108,30 +147,43 @@ signals:
     void duplicateAudioSkipped(const QString &title, const QString &reason);
     void importingChanged();
     void importProgressChanged();
-    void importStarted(int total);
-    void importFinished(int imported, int failed, bool canceled);
+    void importQueueChanged();
+    void lyricsPrefetchThresholdChanged();
+    void remoteLyricsEndpointChanged();
+    void coverCacheMaxBytesChanged();
+    void importStarted(int batchId, int total);
+    void importFinished(int batchId, int imported, int failed, bool canceled);
     void importRejected(const QString &reason);
     void importFailed(const QUrl &source, const QString &reason);
+    // Each match is a map with audioSource, timestampMs and lyricText.
+    void lyricSearchFinished(const QString &text, const QVariantList &matches);
 
 private slots:
     void onAudioSourceChangeRequested(const QUrl &source);
-    void onAudioImported(const QString &title,
-                         const QString &authorName,
-                         const QUrl &audioSource,
-                         const QUrl &imageSource);
+    void onAudioImported(const QList<SongPlayer::ImportedTrack> &tracks);
+    void onAudioRemoved(const QUrl &audioSource);
+    void onLibraryRescanRequested(const QUrl &directoryUrl, bool recursive);
     void onCurrentSongChanged();
     void onPositionChanged();
     void onPlaylistChanged();
     void onImportStarted();
-    void onImportFinished();
+    void onImportFinished(int batchId);
+    void refreshLyricAssociations();
+    void refreshLyricSearchIndex();
+    void collectCoverCache();
 
 private:
     void loadDefaultPlaylistOnStartup();
+    void refreshMissingAudioProperties();
+    int startFolderRescan(const QUrl &folderUrl, bool recursive, bool restoreRemovedTracks);
 
     AudioPlayer *m_audioPlayer{nullptr};
     PlaylistModel *m_playlistModel{nullptr};
     SongPlayer::AudioImporter *m_audioImporter{nullptr};
+    SongPlayer::LibraryWatcher *m_libraryWatcher{nullptr};
+    SongPlayer::CoverCacheManager *m_coverCacheManager{nullptr};
     LyricsService *m_lyricsService{nullptr};
+    HttpLyricsProvider *m_remoteLyricsProvider{nullptr};
     LyricsModel *m_lyricsModel{nullptr};
     PlaylistStorageService *m_playlistStorageService{nullptr};
     QTimer *m_saveTimer{nullptr};
@@ -140,4 +192,37 @@ private:
     IPlaylistOperations *m_playlistOperations{nullptr};
     IPlaylistPersistence *m_playlistPersistence{nullptr};
     bool m_playlistDirtyDuringImport{false};
+    // Queued import batches that walk a folder; while one runs, it refreshes entries whose
+    // files changed instead of skipping them as duplicates.
+    QSet<int> m_folderImportBatches;
+    // Queued import batches the user asked for; the rest are background rescans, which
+    // neither block playlist changes nor remove playlist entries.
+    QSet<int> m_userImportBatches;
+    // Queued batches that read the files of older library tracks again for their audio
+    // properties; they update entries and never add any.
+    QSet<int> m_propertyRefreshBatches;
+    // Recorded together when the import finishes.
+    std::vector<StoredFileFingerprint> m_importedFingerprints;
+    std::vector<QUrl> m_removedLibraryFiles;
+    std::vector<QUrl> m_forgottenLibraryFiles;
+    std::vector<StoredAudioProperties> m_refreshedProperties;
+    // Bumped on every song change; a lyric lookup only lands if its generation is still current.
+    quint64 m_lyricsGeneration{0};
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> m_pendingLyrics;
+    double m_lyricsPrefetchThreshold{0.8};
+    bool m_lyricsPrefetched{false};
+    QFuture<std::vector<LyricsService::LyricAssociationEntry>> m_lyricAssociationJob;
+    // Tracks whose lyrics sidecar may have changed since their association was stored;
+    // the next refresh checks only these, unless a whole-library pass is due.
+    QSet<QUrl> m_lyricAssociationSources;
+    bool m_lyricAssociationsFullPass{false};
+    QFuture<std::vector<LyricsService::LyricTextEntry>> m_lyricSearchJob;
+    // Bumped on every searchLyrics(); only the latest search reports its matches.
+    quint64 m_lyricSearchGeneration{0};
+    // Tracks whose association changed or that were imported since the last index
+    // refresh; the next one reads only these, unless a whole-library pass is due.
+    QSet<QUrl> m_lyricSearchSources;
+    bool m_lyricSearchFullPass{false};
+    // Start position for the next source change requested by switchToAudioAtPosition().
+    qint64 m_pendingStartPositionMs{-1};
 };
@@ -2,6 +2,9 @@
 
 #include <QObject>
 
+#include <cstddef>
+#include <optional>
+
 #include "interfaces/ICurrentSongManager.h"
 #include "interfaces/IPlaylistOperations.h"
 #include "interfaces/IPlaylistPersistence.h"
@@ -21,6 +24,7 @@ public:
     AudioInfo* currentSong() const override;
     void setCurrentSong(AudioInfo *newCurrentSong) override;
 
+    AudioInfo* upcomingSong() override;
     void switchToNextSong() override;
     void switchToPreviousSong() override;
     void switchToAudioByIndex(int index) override;
@@ -61,8 +65,12 @@ private slots:
     void onPlayFinished();
 
 private:
+    std::optional<std::size_t> nextShuffleIndex();
+
     PlaylistModel *m_playlistModel{nullptr};
     PlaylistStorageService *m_storageService{nullptr};
     QString m_currentPlaylistName{};
     bool m_loadingPlaylist{false};
+    // Shuffle pick announced through upcomingSong(); dropped whenever the playlist changes.
+    std::optional<std::size_t> m_pendingShuffleIndex{};
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// Lists the importable audio files below a directory one at a time, so a folder
+// import can start reading metadata before the walk is over. Files come in name
+// order, each directory's files before its subdirectories, which keeps an album's
+// tracks together. Only the directory being listed and the unvisited subdirectories
+// of its ancestors are held in memory. Unreadable entries are skipped and directory
+// symlinks are not followed, so a link cycle cannot trap the walk.
+class AudioFileEnumerator {
+public:
+    AudioFileEnumerator(std::filesystem::path root, bool recursive);
+
+    // The next audio file, or nullopt once the walk is complete.
+    [[nodiscard]] std::optional<std::filesystem::path> next();
+
+private:
+    void list(const std::filesystem::path& directory);
+
+    bool m_recursive{true};
+    // Both kept in reverse order so the next entry is popped from the back.
+    std::vector<std::filesystem::path> m_files;
+    std::vector<std::filesystem::path> m_directories;
+};
+
+} // namespace SongPlayer::Core
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/AudioTrack.h"
+#include "core/FileFingerprint.h"
+
 #include <expected>
 #include <filesystem>
 #include <optional>
@@ -10,6 +13,11 @@ namespace SongPlayer::Core {
 
 inline constexpr std::string_view kUnknownArtistName = "Unknown Artist";
 inline constexpr std::string_view kCoverCacheDirectoryName = "covers";
+// Downscaled covers live in this subdirectory of the cover cache.
+inline constexpr std::string_view kCoverThumbnailDirectoryName = "thumbnails";
+// Edge lengths in pixels: list rows (2x a 32px icon) and the now-playing box.
+inline constexpr int kListThumbnailSize = 64;
+inline constexpr int kDetailThumbnailSize = 256;
 
 enum class AudioImportErrorCode {
     InvalidPath,
@@ -21,6 +29,12 @@ struct ImportedAudio {
     std::string artist;
     std::filesystem::path audioFile;
     std::optional<std::filesystem::path> coverFile;
+    // LRC text for synchronized tags, plain text otherwise; empty when the file has none.
+    std::string embeddedLyrics;
+    AudioProperties properties;
+    // Recorded so a later rescan can skip the file while it stays unchanged; set by
+    // the importer, not by metadata readers.
+    std::optional<FileFingerprint> fingerprint;
 };
 
 struct AudioImportError {
@@ -44,15 +58,27 @@ public:
         const AudioImportRequest& request) const noexcept = 0;
 };
 
+// Folder imports only pick up files with these extensions (case-insensitive):
+// mp3, flac, ogg, opus, m4a, wav and wv.
+[[nodiscard]] bool isImportableAudioFile(const std::filesystem::path& file);
+
 [[nodiscard]] std::string coverFileNameForAudioStem(std::string_view audioStem);
 
-[[nodiscard]] std::string coverFileNameForAudio(
-    std::string_view audioStem,
-    std::string_view sourceIdentity,
+// Content-addressed cover file name: identical image bytes always map to the same
+// file, so an album's tracks share one cached cover (and one decoded QML image).
+[[nodiscard]] std::string coverFileNameForImage(
+    std::string_view imageBytes,
     std::string_view extension);
 
 [[nodiscard]] std::string_view imageMimeTypeForExtension(std::string_view extension) noexcept;
 
 [[nodiscard]] std::string_view imageExtensionForMimeType(std::string_view mimeType) noexcept;
 
+// Name of a cover's thumbnail with the given edge length. JPEG covers get JPEG
+// thumbnails; any other format may carry alpha, so its thumbnails are PNG.
+[[nodiscard]] std::string coverThumbnailFileName(std::string_view coverFileName, int size);
+
+// MIME type from an image's leading bytes, for containers that store no usable type.
+[[nodiscard]] std::string_view imageMimeTypeForData(std::string_view bytes) noexcept;
+
 } // namespace SongPlayer::Core
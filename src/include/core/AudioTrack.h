@@ -1,9 +1,21 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace SongPlayer::Core {
 
+// Stream properties read from the file headers at import, so a track's length is
+// known without loading it into a media player. Zero means unknown.
+struct AudioProperties {
+    std::int64_t durationMs{0};
+    int bitrateKbps{0};
+    int sampleRateHz{0};
+    int channels{0};
+
+    friend bool operator==(const AudioProperties&, const AudioProperties&) = default;
+};
+
 struct AudioTrack {
     int songIndex{-1};
     std::string title;
@@ -11,6 +23,7 @@ struct AudioTrack {
     std::string audioSource;
     std::string imageSource;
     std::string videoSource;
+    AudioProperties properties;
 };
 
 } // namespace SongPlayer::Core
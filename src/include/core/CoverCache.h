@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// A cached cover together with its thumbnails. Covers are content-addressed, so the
+// cover file name without extension identifies the image (see coverFileNameForImage);
+// thumbnails whose cover is already gone are accounted for under the same name.
+struct CoverCacheEntry {
+    std::string name;
+    std::vector<std::filesystem::path> files;
+    std::uint64_t bytes{0};
+    // Latest use of any of the files on the coverCacheClockNs() clock; see markCoverUsed.
+    std::int64_t lastUsedNs{0};
+};
+
+// Lists the cover cache below directory, thumbnails included. The thumbnail atlas is
+// left out. Leftover temporary files from interrupted writes are entries of their own
+// that no track refers to, so they age out like orphans.
+[[nodiscard]] std::vector<CoverCacheEntry> scanCoverCache(const std::filesystem::path& directory);
+
+// The entries to delete, in order: those not in referenced and not used since
+// orphanCutoffNs, then, while the rest exceed maxBytes, the least recently used of the
+// unreferenced ones left. Referenced entries are never deleted, so the cap is only
+// met when the orphans are enough; a library whose own covers exceed it keeps them.
+[[nodiscard]] std::vector<CoverCacheEntry> planCoverCacheCollection(
+    std::vector<CoverCacheEntry> entries,
+    const std::set<std::string>& referenced,
+    std::uint64_t maxBytes,
+    std::int64_t orphanCutoffNs);
+
+// Deletes the files of an entry; returns the bytes freed.
+std::uint64_t removeCoverCacheEntry(const CoverCacheEntry& entry) noexcept;
+
+// The name a cover file is accounted for under in CoverCacheEntry.
+[[nodiscard]] std::string coverCacheEntryName(const std::filesystem::path& coverFile);
+
+// Stamps a cached cover as used now. The cache keeps its LRU clock in the file's
+// modification time because access times are unreliable (relatime, noatime).
+void markCoverUsed(const std::filesystem::path& coverFile) noexcept;
+
+[[nodiscard]] std::int64_t coverCacheClockNs() noexcept;
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// Hands out work items in sequence order while keeping each storage device within
+// its own concurrency limit, so a spinning disk is read one file at a time while an
+// SSD in the same batch is read by several workers.
+class DeviceScheduler {
+public:
+    // Adds a device for items appended later and returns its index; limit is the
+    // number of its items that may run at once (values below 1 count as 1).
+    [[nodiscard]] std::size_t addDevice(int limit);
+
+    // Adds the next item in sequence order while items are being discovered; unknown
+    // devices get a limit of 1.
+    void append(std::size_t device);
+
+    // The lowest pending item below endIndex whose device has a free slot, or nullopt
+    // when every such device is busy or nothing below endIndex is pending.
+    [[nodiscard]] std::optional<std::size_t> claim(std::size_t endIndex);
+
+    // Frees the slot of a claimed item.
+    void release(std::size_t item);
+
+    // True once every item added so far has been claimed.
+    [[nodiscard]] bool exhausted() const noexcept;
+
+    // Sum of all device limits: more workers than this would only wait.
+    [[nodiscard]] int usefulConcurrency() const noexcept;
+
+private:
+    std::vector<std::size_t> m_deviceOfItem;
+    std::vector<std::deque<std::size_t>> m_pending;
+    std::vector<int> m_limits;
+    std::vector<int> m_running;
+    std::size_t m_unclaimed{0};
+};
+
+} // namespace SongPlayer::Core
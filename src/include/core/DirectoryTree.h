@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// The directories of the tree below root, root first, for watching a library folder.
+// Gives up with nullopt as soon as more than limit directories turn up, so a huge
+// tree costs at most limit + 1 listings. Unreadable directories are skipped and
+// directory symlinks are not followed, like AudioFileEnumerator does.
+[[nodiscard]] std::optional<std::vector<std::filesystem::path>> collectDirectoryTree(
+    const std::filesystem::path& root,
+    std::size_t limit);
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// What one stat reveals about a file without opening it. A file whose fingerprint
+// still matches the one recorded when it was imported has not been rewritten since,
+// so its metadata need not be read again.
+struct FileFingerprint {
+    std::uint64_t device{0};
+    std::uint64_t inode{0};
+    std::uint64_t size{0};
+    // Last modification in nanoseconds since the epoch.
+    std::int64_t modifiedNs{0};
+
+    friend bool operator==(const FileFingerprint&, const FileFingerprint&) = default;
+};
+
+using FileFingerprints = std::map<std::filesystem::path, FileFingerprint>;
+
+// Compares a folder walk with the fingerprints recorded at the last import. Only
+// recorded files inside the walked folder (directly inside it unless the walk is
+// recursive) take part, so files imported from elsewhere are never reported missing.
+class LibraryRescan {
+public:
+    LibraryRescan(const std::filesystem::path& root, bool recursive, FileFingerprints recorded);
+
+    // Marks the walked file as present. True when its metadata has to be read: it is
+    // new, it changed since it was recorded, or it could not be fingerprinted.
+    [[nodiscard]] bool needsRead(const std::filesystem::path& file,
+                                 const std::optional<FileFingerprint>& current);
+
+    // Recorded files the walk has not reached whose path no longer exists; once the
+    // walk is complete, the files that are gone. The walk skips directories it cannot
+    // read and stops listing one on an I/O error, so a file it did not reach is only
+    // reported when stat says it does not exist; any other stat failure keeps it.
+    [[nodiscard]] std::vector<std::filesystem::path> missingFiles() const;
+
+private:
+    FileFingerprints m_unseen;
+};
+
+} // namespace SongPlayer::Core
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace SongPlayer::Core {
+
+// Stable across runs and platforms; used for cache file names, never for security.
+[[nodiscard]] constexpr std::uint64_t fnv1a64(std::string_view value) noexcept
+{
+    constexpr std::uint64_t offsetBasis = 14695981039346656037ULL;
+    constexpr std::uint64_t prime = 1099511628211ULL;
+
+    std::uint64_t hash = offsetBasis;
+    for (const unsigned char byte : value) {
+        hash ^= byte;
+        hash *= prime;
+    }
+    return hash;
+}
+
+} // namespace SongPlayer::Core
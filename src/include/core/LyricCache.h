@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/Lyrics.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+inline constexpr std::string_view kLyricCacheDirectoryName = "lyrics";
+
+// Identity of the file a cache entry was parsed from. A cache entry is only
+// valid while path, size and modification time all still match the source.
+struct LyricSourceIdentity {
+    std::string path;
+    std::uint64_t size{0};
+    std::int64_t modifiedMs{0};
+
+    [[nodiscard]] bool operator==(const LyricSourceIdentity&) const = default;
+};
+
+// The sidecar LRC resolved for one audio file, persisted so that a track change
+// does not rescan the audio file's directory. The directory's modification time
+// changes whenever an LRC file is added, removed or renamed there.
+struct LyricAssociation {
+    // nullopt when no LRC file in the directory matches the audio file.
+    std::optional<LyricSourceIdentity> lrcFile;
+    bool exactMatch{false};
+    std::int64_t directoryModifiedMs{0};
+
+    [[nodiscard]] bool operator==(const LyricAssociation&) const = default;
+};
+
+// currentLrcFile is the present identity of the stored LRC path, or nullopt when
+// it no longer exists (or none was stored).
+[[nodiscard]] bool lyricAssociationIsCurrent(
+    const LyricAssociation& stored,
+    std::int64_t currentDirectoryModifiedMs,
+    const std::optional<LyricSourceIdentity>& currentLrcFile) noexcept;
+
+[[nodiscard]] std::string lyricCacheFileName(std::string_view sourcePath);
+
+// A cached "not found" answer from a remote lyrics provider is retried after this
+// long; lyrics that were found do not expire.
+inline constexpr std::int64_t kRemoteLyricsNotFoundTtlMs = 24LL * 60 * 60 * 1000;
+
+// Lyrics fetched from a remote provider are cached under a synthetic identity built
+// from the track's artist and title (case and surrounding blanks ignored). No file
+// backs such an entry, so its size and modification time are always zero.
+[[nodiscard]] LyricSourceIdentity remoteLyricSource(std::string_view artist, std::string_view title);
+
+// Encodes lyrics as a fixed header, the source path, an int64 timestamp array,
+// a uint32 text offset array and one UTF-8 text blob. Every section starts on an
+// 8-byte boundary so the file can be read straight from a memory mapping.
+[[nodiscard]] std::string encodeLyricCache(
+    const LyricSourceIdentity& source,
+    std::span<const LyricLine> lyrics);
+
+// Returns nullopt for truncated, foreign or stale data instead of throwing.
+[[nodiscard]] std::optional<std::vector<LyricLine>> decodeLyricCache(
+    std::string_view bytes,
+    const LyricSourceIdentity& expectedSource);
+
+} // namespace SongPlayer::Core
@@ -9,6 +9,9 @@
 
 namespace SongPlayer::Core {
 
+// Lines of unsynchronized lyrics carry this timestamp; they are displayed but never highlighted.
+inline constexpr std::int64_t kUnsyncedLyricTimestamp = -1;
+
 struct LyricLine {
     std::int64_t timestampMs{0};
     std::string text;
@@ -23,12 +26,48 @@ struct LyricLine {
 
 [[nodiscard]] std::optional<std::int64_t> parseLrcTimestamp(std::string_view timestamp);
 
+// Accepts LRC text or plain unsynchronized lyrics as found in embedded tags.
+[[nodiscard]] std::vector<LyricLine> parseEmbeddedLyrics(std::string_view content);
+
+[[nodiscard]] std::string formatLrcTimestamp(std::int64_t timestampMs);
+
+[[nodiscard]] std::string formatLrcContent(std::span<const LyricLine> lyrics);
+
 [[nodiscard]] std::optional<std::size_t> lyricIndexAtPosition(
     std::span<const LyricLine> lyrics,
     std::int64_t positionMs);
 
+// Turns free text typed by the user into a full-text MATCH expression: every word is
+// quoted so no input is read as query syntax, and the last one matches as a prefix.
+// Returns an empty string when the text holds no words.
+[[nodiscard]] std::string lyricSearchExpression(std::string_view text);
+
+inline constexpr double kLyricFileMatchThreshold = 60.0;
+
+struct LyricFileName {
+    std::string normalized;
+    std::vector<std::uint16_t> bigrams;
+};
+
+struct LyricFileMatch {
+    std::size_t candidateIndex{0};
+    double score{0.0};
+};
+
 [[nodiscard]] std::string normalizeLyricFileName(std::string_view fileName);
 
+[[nodiscard]] LyricFileName prepareLyricFileName(std::string_view fileName);
+
 [[nodiscard]] double lyricFileMatchScore(std::string_view audioName, std::string_view lrcName);
 
+[[nodiscard]] double lyricFileMatchScore(
+    const LyricFileName& audioName,
+    const LyricFileName& lrcName) noexcept;
+
+// Candidates are prepared once per directory listing; the audio name is prepared once per call.
+[[nodiscard]] std::optional<LyricFileMatch> bestLyricFileMatch(
+    std::string_view audioName,
+    std::span<const LyricFileName> candidates,
+    double threshold = kLyricFileMatchThreshold);
+
 } // namespace SongPlayer::Core
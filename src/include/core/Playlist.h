@@ -3,6 +3,7 @@
 #include "core/AudioTrack.h"
 #include "core/PlayMode.h"
 
+#include <cstdint>
 #include <optional>
 #include <span>
 #include <string>
@@ -28,14 +29,19 @@ class Playlist {
 public:
     bool addTrack(AudioTrack track);
     bool removeTrack(std::size_t index);
+    // Replaces the tags of the track at index; its source, and so its identity, stays.
+    bool replaceTrack(std::size_t index, AudioTrack track);
     void clear();
 
     [[nodiscard]] std::size_t size() const noexcept;
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] const AudioTrack* trackAt(std::size_t index) const noexcept;
     [[nodiscard]] std::span<const AudioTrack> tracks() const noexcept;
+    // Sum of the known track durations; tracks of unknown length count as zero.
+    [[nodiscard]] std::int64_t totalDurationMs() const noexcept;
 
     [[nodiscard]] bool containsSource(std::string_view audioSource) const;
+    [[nodiscard]] std::optional<std::size_t> indexOfSource(std::string_view audioSource) const;
 
     [[nodiscard]] PlayMode playMode() const noexcept;
     void setPlayMode(PlayMode mode) noexcept;
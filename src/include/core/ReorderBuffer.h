@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace SongPlayer::Core {
+
+// Restores sequence order for values produced out of order, e.g. by parallel
+// workers. Each index from 0 upwards must be pushed exactly once.
+template <typename T>
+class ReorderBuffer {
+public:
+    // Takes the value for `index` and returns every value that is now contiguous with
+    // the ones already released, in index order.
+    [[nodiscard]] std::vector<T> push(std::size_t index, T value)
+    {
+        std::vector<T> ready;
+        if (index != m_nextIndex) {
+            m_pending.emplace(index, std::move(value));
+            return ready;
+        }
+
+        ready.push_back(std::move(value));
+        ++m_nextIndex;
+        for (auto next = m_pending.find(m_nextIndex); next != m_pending.end();
+             next = m_pending.find(m_nextIndex)) {
+            ready.push_back(std::move(next->second));
+            m_pending.erase(next);
+            ++m_nextIndex;
+        }
+        return ready;
+    }
+
+    // The first index that has not been released yet.
+    [[nodiscard]] std::size_t nextIndex() const noexcept
+    {
+        return m_nextIndex;
+    }
+
+    [[nodiscard]] std::size_t bufferedCount() const noexcept
+    {
+        return m_pending.size();
+    }
+
+private:
+    std::size_t m_nextIndex{0};
+    std::map<std::size_t, T> m_pending;
+};
+
+} // namespace SongPlayer::Core
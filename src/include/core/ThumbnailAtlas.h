@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string_view>
+
+namespace SongPlayer::Core {
+
+// Lives in the cover cache directory beside the covers it was built from.
+inline constexpr std::string_view kThumbnailAtlasFileName = "thumbnail-atlas.bin";
+
+// Atlas key of a cached cover: its file name without extension, which already
+// identifies the image content (see coverFileNameForImage).
+[[nodiscard]] std::uint64_t thumbnailAtlasKey(std::string_view coverFileName) noexcept;
+
+// One pre-decoded thumbnail. pixels holds height rows of tileSize * 4 bytes, the
+// image occupying the first width pixels of each row. The pixel format is opaque to
+// the core; the writer and the reader of an atlas must agree on it.
+struct ThumbnailTile {
+    std::uint64_t key{0};
+    std::uint32_t width{0};
+    std::uint32_t height{0};
+    std::string_view pixels;
+};
+
+// Writes a fixed header, an index of (key, width, height) sorted by key and one
+// tileSize x tileSize x 4 byte slot per tile. The pixel area starts on a 64-byte
+// boundary so tiles can be handed out straight from a memory mapping. Later tiles
+// win over earlier ones with the same key; tiles that do not fit are dropped.
+// Streams the tiles so an atlas of many covers never exists twice in memory.
+[[nodiscard]] bool writeThumbnailAtlas(
+    std::ostream& output,
+    std::uint32_t tileSize,
+    std::span<const ThumbnailTile> tiles);
+
+// Read-only view over atlas bytes, typically a memory mapping; the bytes must outlive
+// the view and every tile returned by it.
+class ThumbnailAtlasView {
+public:
+    // Returns nullopt for truncated or foreign data instead of throwing.
+    [[nodiscard]] static std::optional<ThumbnailAtlasView> open(std::string_view bytes);
+
+    [[nodiscard]] std::uint32_t tileSize() const noexcept { return m_tileSize; }
+    [[nodiscard]] std::size_t tileCount() const noexcept { return m_tileCount; }
+
+    // Tiles in key order, for merging an atlas into its successor.
+    [[nodiscard]] ThumbnailTile tileAt(std::size_t index) const noexcept;
+
+    // Binary search over the index; no pixel data is touched until it is read.
+    [[nodiscard]] std::optional<ThumbnailTile> find(std::uint64_t key) const noexcept;
+
+private:
+    ThumbnailAtlasView(std::string_view bytes, std::uint32_t tileSize, std::size_t tileCount) noexcept;
+
+    std::string_view m_bytes;
+    std::uint32_t m_tileSize{0};
+    std::size_t m_tileCount{0};
+};
+
+} // namespace SongPlayer::Core
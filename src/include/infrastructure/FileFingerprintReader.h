@@ -0,0 +1,14 @@
+#pragma once
+
+#include "core/FileFingerprint.h"
+
+#include <filesystem>
+#include <optional>
+
+namespace SongPlayer::Infrastructure {
+
+// One stat, no open: cheap enough to run on every file of a large library rescan.
+// Returns nullopt when the file cannot be stat'ed.
+[[nodiscard]] std::optional<Core::FileFingerprint> readFileFingerprint(const std::filesystem::path& file);
+
+} // namespace SongPlayer::Infrastructure
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <taglib/tiostream.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace SongPlayer::Infrastructure {
+
+// Read-only TagLib stream that fetches the regions tags live in with a few large
+// reads instead of TagLib's many small seek-and-read pairs, which cost a round trip
+// each on HDDs and network mounts. On open, the head (the whole ID3v2 tag when there
+// is one, so an embedded cover comes in one read) and the tail (ID3v1, APE, trailing
+// MP4 atoms) are announced to the kernel with posix_fadvise(WILLNEED), so both
+// requests are queued before the first one is waited for, and then read whole. Other
+// reads go through a window of kWindowBytes.
+//
+// The file is read with pread rather than mapped: a file truncated while it is mapped
+// raises SIGBUS in the reader, and files still being copied are exactly what a
+// library rescan runs into.
+class ReadaheadFileStream final : public TagLib::IOStream {
+public:
+    static constexpr std::size_t kHeadBytes = 256 * 1024;
+    static constexpr std::size_t kMaxHeadBytes = 16 * 1024 * 1024;
+    static constexpr std::size_t kTailBytes = 64 * 1024;
+    static constexpr std::size_t kWindowBytes = 64 * 1024;
+
+    // nullptr when the file cannot be opened or the platform has no pread; callers
+    // then fall back to TagLib's own FileStream.
+    [[nodiscard]] static std::unique_ptr<ReadaheadFileStream> open(const std::filesystem::path& file);
+
+    ~ReadaheadFileStream() override;
+    ReadaheadFileStream(const ReadaheadFileStream&) = delete;
+    ReadaheadFileStream& operator=(const ReadaheadFileStream&) = delete;
+
+    TagLib::FileName name() const override;
+    TagLib::ByteVector readBlock(std::size_t length) override;
+    void writeBlock(const TagLib::ByteVector& data) override;
+    void insert(const TagLib::ByteVector& data, TagLib::offset_t start, std::size_t replace) override;
+    void removeBlock(TagLib::offset_t start, std::size_t length) override;
+    bool readOnly() const override;
+    bool isOpen() const override;
+    void seek(TagLib::offset_t offset, Position position) override;
+    TagLib::offset_t tell() const override;
+    TagLib::offset_t length() override;
+    void truncate(TagLib::offset_t length) override;
+
+    // Read calls issued against the file so far, for tests and benchmarks.
+    [[nodiscard]] std::size_t fileReads() const noexcept { return m_fileReads; }
+
+private:
+    struct Region {
+        TagLib::offset_t start{0};
+        std::vector<char> bytes;
+
+        [[nodiscard]] bool contains(TagLib::offset_t offset) const noexcept;
+    };
+
+    ReadaheadFileStream(std::filesystem::path file, int descriptor, TagLib::offset_t length);
+
+    void prefetch();
+    // Reads up to length bytes at offset; returns the number of bytes read.
+    std::size_t readAt(TagLib::offset_t offset, char* data, std::size_t length);
+    bool fill(Region& region, TagLib::offset_t start, std::size_t length);
+    [[nodiscard]] const Region* regionAt(TagLib::offset_t offset) const noexcept;
+
+    std::filesystem::path m_file;
+    int m_descriptor{-1};
+    TagLib::offset_t m_length{0};
+    TagLib::offset_t m_position{0};
+    Region m_head;
+    Region m_tail;
+    Region m_window;
+    std::size_t m_fileReads{0};
+};
+
+} // namespace SongPlayer::Infrastructure
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+
+namespace SongPlayer::Infrastructure {
+
+struct StorageDevice {
+    // st_dev of the file system holding the file; 0 when it cannot be determined.
+    std::uint64_t id{0};
+    // Rotational or removable media, where parallel reads cost more seek time than
+    // they save. Unknown devices are assumed to be solid state.
+    bool sequentialOnly{false};
+};
+
+// Identifies the storage device behind files, caching results per directory and per
+// device so a large import costs one stat per directory. Not thread-safe.
+class StorageDeviceProbe {
+public:
+    [[nodiscard]] StorageDevice deviceFor(const std::filesystem::path& file);
+
+private:
+    std::map<std::filesystem::path, StorageDevice> m_directories;
+    std::map<std::uint64_t, bool> m_sequentialDevices;
+};
+
+} // namespace SongPlayer::Infrastructure
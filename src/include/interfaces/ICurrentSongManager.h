@@ -8,6 +8,9 @@ public:
     virtual ~ICurrentSongManager() = default;
     virtual AudioInfo* currentSong() const = 0;
     virtual void setCurrentSong(AudioInfo *song) = 0;
+    // The song switchToNextSong() will select; in shuffle mode the random pick is
+    // made here and kept until that switch happens.
+    virtual AudioInfo* upcomingSong() = 0;
     virtual void switchToNextSong() = 0;
     virtual void switchToPreviousSong() = 0;
     virtual void switchToAudioByIndex(int index) = 0;
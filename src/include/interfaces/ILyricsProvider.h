@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QFuture>
+#include <QString>
+
+struct LyricsQuery {
+    QString artist;
+    QString title;
+};
+
+struct LyricsFetchResult {
+    enum class Status {
+        Found,
+        NotFound,
+        // Transient failure (network, server error): nothing should be cached.
+        Failed
+    };
+
+    Status status{Status::Failed};
+    // LRC text or plain lyrics when status is Found.
+    QString lyricsText;
+};
+
+// Source of lyrics for tracks without local ones. fetchLyrics() is called on the
+// GUI thread and may be called repeatedly for the same track; the returned future
+// either carries one result or is canceled.
+class ILyricsProvider
+{
+public:
+    virtual ~ILyricsProvider() = default;
+    virtual QFuture<LyricsFetchResult> fetchLyrics(const LyricsQuery &query) = 0;
+    // Withdraws one fetchLyrics() call for the query. Once no caller waits for it any
+    // more, the fetch is dropped and its future canceled.
+    virtual void cancelFetch(const LyricsQuery &query) = 0;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/AudioTrack.h"
+
 #include <QObject>
 #include <QString>
 #include <QUrl>
@@ -15,8 +17,18 @@ class AudioInfo : public QObject
     Q_PROPERTY(QString title READ title WRITE setTitle NOTIFY titleChanged)
     Q_PROPERTY(QString authorName READ authorName WRITE setAuthorName NOTIFY authorNameChanged)
     Q_PROPERTY(QUrl imageSource READ imageSource WRITE setImageSource NOTIFY imageSourceChanged)
+    // Downscaled covers generated at import; list rows read theirs from the thumbnail
+    // atlas. Either may be missing for older covers, in which case views fall back to
+    // imageSource.
+    Q_PROPERTY(QUrl listImageSource READ listImageSource NOTIFY imageSourceChanged)
+    Q_PROPERTY(QUrl detailImageSource READ detailImageSource NOTIFY imageSourceChanged)
     Q_PROPERTY(QUrl videoSource READ videoSource WRITE setVideoSource NOTIFY videoSourceChanged)
     Q_PROPERTY(QUrl audioSource READ audioSource WRITE setAudioSource NOTIFY audioSourceChanged REQUIRED)
+    // Read from the file headers at import; 0 while unknown (network or older entries).
+    Q_PROPERTY(qint64 durationMs READ durationMs NOTIFY audioPropertiesChanged)
+    Q_PROPERTY(int bitrateKbps READ bitrateKbps NOTIFY audioPropertiesChanged)
+    Q_PROPERTY(int sampleRateHz READ sampleRateHz NOTIFY audioPropertiesChanged)
+    Q_PROPERTY(int channels READ channels NOTIFY audioPropertiesChanged)
 
 public:
     explicit AudioInfo(QObject *parent = nullptr);
@@ -33,12 +45,22 @@ public:
     QUrl imageSource() const;
     void setImageSource(const QUrl &newImageSource);
 
+    QUrl listImageSource() const;
+    QUrl detailImageSource() const;
+
     QUrl videoSource() const;
     void setVideoSource(const QUrl &newVideoSource);
 
     QUrl audioSource() const;
     void setAudioSource(const QUrl &newAudioSource);
 
+    SongPlayer::Core::AudioProperties audioProperties() const;
+    void setAudioProperties(const SongPlayer::Core::AudioProperties &newProperties);
+    qint64 durationMs() const;
+    int bitrateKbps() const;
+    int sampleRateHz() const;
+    int channels() const;
+
 signals:
     void songIndexChanged();
     void titleChanged();
@@ -47,6 +69,7 @@ signals:
     void videoSourceChanged();
 
     void audioSourceChanged();
+    void audioPropertiesChanged();
 
 private:
     int m_songIndex = -1;
@@ -55,4 +78,5 @@ private:
     QUrl m_imageSource;
     QUrl m_videoSource;
     QUrl m_audioSource;
+    SongPlayer::Core::AudioProperties m_audioProperties;
 };
@@ -2,13 +2,15 @@
 
 #include "core/Lyrics.h"
 
-#include <QObject>
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
 #include <QString>
-#include <QStringList>
+#include <QVariant>
 #include <QtQml/qqmlregistration.h>
 #include <vector>
 
-class LyricsModel : public QObject
+class LyricsModel : public QAbstractListModel
 {
     Q_OBJECT
     QML_ELEMENT
@@ -17,16 +19,25 @@ class LyricsModel : public QObject
     Q_PROPERTY(bool hasLyrics READ hasLyrics NOTIFY hasLyricsChanged)
     Q_PROPERTY(QString currentLyric READ currentLyric NOTIFY currentLyricChanged)
     Q_PROPERTY(bool showLyrics READ showLyrics WRITE setShowLyrics NOTIFY showLyricsChanged)
-    Q_PROPERTY(QStringList allLyrics READ allLyrics NOTIFY allLyricsChanged)
     Q_PROPERTY(int currentLineIndex READ currentLineIndex NOTIFY currentLineIndexChanged)
 
 public:
+    enum Role {
+        LyricTextRole = Qt::UserRole + 1,
+        LyricTimestampRole,
+        LyricIsCurrentRole
+    };
+    Q_ENUM(Role)
+
     explicit LyricsModel(QObject *parent = nullptr);
 
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
     bool hasLyrics() const { return m_hasLyrics; }
     QString currentLyric() const { return m_currentLyric; }
     bool showLyrics() const { return m_showLyrics; }
-    QStringList allLyrics() const { return m_allLyrics; }
     int currentLineIndex() const { return m_currentLineIndex; }
 
     void setShowLyrics(bool show);
@@ -42,19 +53,17 @@ signals:
     void hasLyricsChanged();
     void currentLyricChanged();
     void showLyricsChanged();
-    void allLyricsChanged();
     void currentLineIndexChanged();
 
 private:
     std::vector<SongPlayer::Core::LyricLine> m_lyrics;
-    QStringList m_allLyrics;
 
     int m_currentLineIndex;
     QString m_currentLyric;
     bool m_hasLyrics;
     bool m_showLyrics;
 
-    void updateAllLyrics();
+    void notifyCurrentRowChanged(int row);
 
     int findLyricIndexByPosition(qint64 position);
 
@@ -5,6 +5,7 @@
 #include <QtQml/qqmlregistration.h>
 #include <cstddef>
 #include <optional>
+#include <span>
 #include "core/Playlist.h"
 #include "models/AudioInfo.h"
 
@@ -31,6 +32,7 @@ class PlaylistModel : public QAbstractListModel
     QML_ELEMENT
     QML_UNCREATABLE("PlaylistModel instances are provided by C++")
     Q_PROPERTY(AudioInfo* currentSong READ currentSong WRITE setCurrentSong NOTIFY currentSongChanged)
+    Q_PROPERTY(qint64 totalDurationMs READ totalDurationMs NOTIFY totalDurationChanged)
 
 public:
     enum Role {
@@ -38,7 +40,12 @@ public:
         AudioAuthorNameRole,
         AudioSourceRole,
         AudioImageSourceRole,
-        AudioVideoSourceRole
+        AudioVideoSourceRole,
+        AudioListImageSourceRole,
+        AudioDurationRole,
+        AudioBitrateRole,
+        AudioSampleRateRole,
+        AudioChannelsRole
     };
     Q_ENUM(Role)
 
@@ -57,17 +64,34 @@ public:
     PlayMode playMode() const;
     void setPlayMode(PlayMode newMode);
 
+    // Sum of the known track durations, for the playlist header.
+    qint64 totalDurationMs() const noexcept;
+
     Q_INVOKABLE bool addAudio(const QString& title,
                               const QString& authorName,
                               const QUrl& audioSource,
                               const QUrl& imageSource,
                               const QUrl& videoSource = QUrl());
+    // Adds a track together with its audio properties, as imports and loads do.
+    bool addTrack(const SongPlayer::Core::AudioTrack& track);
+    // Appends the tracks with one row insertion, skipping duplicates; returns how many
+    // were added.
+    int addTracks(std::span<const SongPlayer::Core::AudioTrack> tracks);
     Q_INVOKABLE void removeAudio(int index);
+    // Refreshes the tags of the entry playing audioSource, e.g. after its file was
+    // rewritten; false when the playlist has no such entry.
+    bool updateAudio(const QString& title,
+                     const QString& authorName,
+                     const QUrl& audioSource,
+                     const QUrl& imageSource,
+                     const SongPlayer::Core::AudioProperties& properties);
     Q_INVOKABLE void clearPlaylist();
 
     Q_INVOKABLE AudioInfo* getAudioInfoAtIndex(int index) const;
 
     bool isDuplicateAudio(const QUrl& audioSource) const;
+    // Row of the entry playing audioSource, or -1.
+    int indexOfAudio(const QUrl& audioSource) const;
     std::optional<std::size_t> nextSongIndex(
         std::optional<std::size_t> shuffleIndex = std::nullopt) const noexcept;
     std::optional<std::size_t> previousSongIndex(
@@ -77,6 +101,7 @@ signals:
     void currentSongChanged();
     void duplicateAudioSkipped(const QString& title, const QString& reason);
     void playModeChanged();
+    void totalDurationChanged();
 
 private:
     QList<AudioInfo *> m_audioList{};
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QString>
 #include <QtQml/qqmlregistration.h>
 
 #include "models/AudioInfo.h"
 
+#include <utility>
+
 class PlaylistSearchModel : public QAbstractListModel
 {
     Q_OBJECT
     QML_ELEMENT
     QML_SINGLETON
     Q_PROPERTY(bool isSearching READ isSearching NOTIFY isSearchingChanged)
+    Q_PROPERTY(SearchScope searchScope READ searchScope WRITE setSearchScope NOTIFY searchScopeChanged)
 
 public:
     enum Role {
@@ -18,10 +22,20 @@ public:
         AudioAuthorNameRole,
         AudioImageSourceRole,
         AudioSourceRole,
-        OriginalIndexRole
+        OriginalIndexRole,
+        MatchTimestampRole,
+        MatchedLyricRole
     };
     Q_ENUM(Role)
 
+    // TrackScope matches titles and artists; LyricsScope matches lyric lines and
+    // reports where in the track each matching line is sung.
+    enum SearchScope {
+        TrackScope,
+        LyricsScope
+    };
+    Q_ENUM(SearchScope)
+
     explicit PlaylistSearchModel(QObject *parent = nullptr);
     ~PlaylistSearchModel() override = default;
 
@@ -32,24 +46,36 @@ public:
     bool isSearching() const;
     void setIsSearching(bool newIsSearching);
 
+    SearchScope searchScope() const;
+    void setSearchScope(SearchScope newSearchScope);
+
 public slots:
     void clearSearch();
 
     void performSearch(const QVariantList &audioInfoList, const QString &searchText);
+    // lyricMatches is the result of PlayerController.searchLyrics(); matches of
+    // tracks outside audioInfoList are dropped.
+    void performLyricsSearch(const QVariantList &audioInfoList, const QVariantList &lyricMatches);
 
 signals:
     void isSearchingChanged();
+    void searchScopeChanged();
 
 private:
     struct SearchResult {
         AudioInfo *audioInfo{nullptr};
         int originalIndex{-1};
+        qint64 matchTimestampMs{-1};
+        QString matchedLyric{};
 
         SearchResult() = default;
         SearchResult(AudioInfo *info, int index) : audioInfo{info}, originalIndex{index} {}
+        SearchResult(AudioInfo *info, int index, qint64 timestampMs, QString lyric)
+            : audioInfo{info}, originalIndex{index}, matchTimestampMs{timestampMs}, matchedLyric{std::move(lyric)} {}
     };
 
     QList<SearchResult> m_searchResults{};
     bool m_isSearching{false};
+    SearchScope m_searchScope{TrackScope};
     QString m_currentSearchText{};
 };
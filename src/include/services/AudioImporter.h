@@ -1,22 +1,56 @@
 #pragma once
 
 #include "core/AudioImport.h"
+#include "core/FileFingerprint.h"
 
 #include <QList>
 #include <QObject>
 #include <QString>
 #include <QUrl>
 
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace SongPlayer {
 
+// One successfully imported file, converted for the GUI thread.
+struct ImportedTrack {
+    QString title;
+    QString authorName;
+    QUrl audioSource;
+    QUrl imageSource;
+    QString embeddedLyrics;
+    Core::AudioProperties properties;
+    // Absent when the file could not be stat'ed.
+    std::optional<Core::FileFingerprint> fingerprint;
+};
+
+// Imports run as batches, one at a time through a shared reader pool. A batch asked
+// for while another one runs waits in a FIFO queue; every batch gets an id that its
+// importStarted/importFinished carry and that cancels it alone. Within one run of the
+// queue a file is read at most once: a later batch skips the files an earlier one
+// already handled, before any of their metadata is read.
 class AudioImporter final : public QObject {
     Q_OBJECT
 
+    // True while a batch runs or waits in the queue.
     Q_PROPERTY(bool importing READ importing NOTIFY importingChanged)
+    // The progress properties describe the running batch only.
     Q_PROPERTY(int importCompleted READ importCompleted NOTIFY importProgressChanged)
     Q_PROPERTY(int importTotal READ importTotal NOTIFY importProgressChanged)
+    // False while a folder import is still discovering files; importTotal then counts
+    // the files found so far.
+    Q_PROPERTY(bool importTotalKnown READ importTotalKnown NOTIFY importProgressChanged)
+    Q_PROPERTY(int importWorkerCount READ importWorkerCount WRITE setImportWorkerCount
+                   NOTIFY importWorkerCountChanged)
+    // Id of the running batch, 0 when none runs.
+    Q_PROPERTY(int importBatchId READ importBatchId NOTIFY importQueueChanged)
+    Q_PROPERTY(int queuedImportCount READ queuedImportCount NOTIFY importQueueChanged)
 
 public:
     explicit AudioImporter(QObject* parent = nullptr);
@@ -28,35 +62,93 @@ public:
     [[nodiscard]] bool importing() const noexcept;
     [[nodiscard]] int importCompleted() const noexcept;
     [[nodiscard]] int importTotal() const noexcept;
+    [[nodiscard]] bool importTotalKnown() const noexcept;
+    [[nodiscard]] int importBatchId() const noexcept;
+    [[nodiscard]] int queuedImportCount() const noexcept;
+
+    // Metadata readers per solid-state device for the next batch; rotational and
+    // removable devices are always read one file at a time. A running batch keeps
+    // its width.
+    [[nodiscard]] int importWorkerCount() const noexcept;
+    void setImportWorkerCount(int workerCount);
+
+    static constexpr int kMaxImportWorkerCount = 16;
+    // Results reach the GUI thread in chunks: whatever arrived within kChunkInterval
+    // of the first pending result, at most kMaxChunkSize at a time.
+    static constexpr std::chrono::milliseconds kChunkInterval{16};
+    static constexpr std::size_t kMaxChunkSize = 256;
+
+    // Each returns the id of the queued batch, or 0 when the request was rejected.
+    // Inputs are validated when the batch starts, so their importFailed signals fall
+    // between its importStarted and importFinished.
+    Q_INVOKABLE int importLocalAudio(const QList<QUrl>& fileUrls);
+    // Imports the audio files below a local folder in name order. Files are found
+    // while earlier ones are already being read, so the first tracks arrive long
+    // before a large library has been walked.
+    Q_INVOKABLE int importDirectory(const QUrl& directoryUrl, bool recursive = true);
+    // Yields the fingerprints a folder rescan diffs against. Called once on the feeding
+    // task when the batch starts, so reading them from storage never blocks the GUI
+    // thread.
+    using RecordedFingerprints = std::function<Core::FileFingerprints()>;
 
-    Q_INVOKABLE void importLocalAudio(const QList<QUrl>& fileUrls);
+    // Folder import against the fingerprints recorded when the files were last
+    // imported: files that still match are only stat'ed, never opened, and recorded
+    // files below the folder that are gone are reported through audioRemoved once the
+    // walk completes. Asking again for a folder walk that is still queued returns the
+    // queued batch, which then trusts only the fingerprints both requests agree on.
+    int rescanDirectory(const QUrl& directoryUrl, bool recursive, RecordedFingerprints recorded);
+    // Cancels the running batch and drops every queued one.
     Q_INVOKABLE void cancelImport();
+    // Cancels one batch, running or queued; unknown ids are ignored.
+    Q_INVOKABLE void cancelImportBatch(int batchId);
 
 signals:
     void importingChanged();
+    void importWorkerCountChanged();
     void importProgressChanged();
-    void importStarted(int total);
-    void importFinished(int imported, int failed, bool canceled);
+    void importQueueChanged();
+    void importStarted(int batchId, int total);
+    // A queued batch that is canceled before it starts finishes without starting.
+    void importFinished(int batchId, int imported, int failed, bool canceled);
     void importRejected(const QString& reason);
     void importFailed(const QUrl& source, const QString& reason);
 
-    void audioImported(const QString& title,
-                       const QString& authorName,
-                       const QUrl& audioSource,
-                       const QUrl& imageSource);
+    // One chunk of imported files in selection order, followed by a single
+    // importProgressChanged for the chunk.
+    void audioImported(const QList<SongPlayer::ImportedTrack>& tracks);
+    // Emitted before importFinished of a completed rescan, once per missing file.
+    void audioRemoved(const QUrl& audioSource);
 
 private:
     struct ImportSession;
+    struct QueuedBatch;
 
-    void handleResult(int resultIndex);
+    int enqueue(QueuedBatch batch);
+    void startNextBatch();
+    void startSelection(const QList<QUrl>& fileUrls);
+    void startFolderWalk(const QUrl& directoryUrl, bool recursive, std::vector<RecordedFingerprints> recorded);
+    void startBatch(std::function<std::optional<std::filesystem::path>()> fileSource,
+                    std::function<std::optional<Core::LibraryRescan>()> rescanSource,
+                    std::optional<int> knownTotal,
+                    int readerCount);
+    void handleResultsReady(int beginIndex, int endIndex);
+    void deliverPendingResults();
+    void handleProgressRange(int minimum, int maximum);
     void handleFinished();
-    void resetProgress(int total, int initialFailures);
+    void finishBatch(bool canceled);
+    // Leaves the busy state once no batch runs and none is queued.
+    void settleIfDrained();
+    void resetProgress(int total, int initialFailures, bool totalKnown);
 
     std::shared_ptr<const Core::IAudioMetadataReader> m_metadataReader;
     std::unique_ptr<ImportSession> m_session;
     bool m_importing{false};
+    int m_importBatchId{0};
+    int m_lastBatchId{0};
     int m_importCompleted{0};
     int m_importTotal{0};
+    bool m_importTotalKnown{true};
+    int m_importWorkerCount{1};
     int m_importedCount{0};
     int m_failedCount{0};
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace SongPlayer {
+
+// Keeps the cover cache bounded. Once the player has been idle for kIdleDelay, a
+// collection deletes the covers (and their thumbnails) that no library track refers
+// to any more, then, while the cache exceeds maxBytes, the least recently used of the
+// other unreferenced ones. Referenced covers are never deleted, so a library whose
+// own covers exceed maxBytes keeps the cache above it. Scanning and deleting run on
+// the thread pool; the owner only hands over the cover names that are referenced.
+//
+// Below the cap, unreferenced covers used within kOrphanGracePeriod are kept, so the
+// covers of an import whose tracks are not saved yet survive.
+class CoverCacheManager final : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::uint64_t kDefaultMaxBytes = std::uint64_t{512} * 1024 * 1024;
+    static constexpr std::chrono::seconds kIdleDelay{30};
+    static constexpr std::chrono::hours kOrphanGracePeriod{1};
+
+    explicit CoverCacheManager(std::filesystem::path coverCacheDirectory, QObject* parent = nullptr);
+    ~CoverCacheManager() override;
+
+    [[nodiscard]] std::uint64_t maxBytes() const;
+    void setMaxBytes(std::uint64_t maxBytes);
+
+    void setIdleDelay(std::chrono::milliseconds delay);
+    void setOrphanGracePeriod(std::chrono::milliseconds period);
+
+    // No collection starts while busy (an import is running), and a running one stops
+    // before its next deletion. Becoming idle schedules a collection.
+    void setBusy(bool busy);
+
+    // Emits collectionDue once the player has been idle for the idle delay.
+    void scheduleCollection();
+
+    // Collects on the thread pool, keeping the covers among referencedImages; image
+    // URLs outside the cover cache are ignored. A collection already running makes
+    // this a no-op.
+    void collect(const std::vector<QUrl>& referencedImages);
+    [[nodiscard]] bool isCollecting() const;
+
+    // Stamps a cached cover as used now, off the GUI thread.
+    void markUsed(const QUrl& imageSource);
+
+signals:
+    // The owner answers with collect() and the library's cover images.
+    void collectionDue();
+    void collected(int removedCovers, qint64 freedBytes);
+
+private:
+    struct Collection {
+        int removedCovers{0};
+        std::uint64_t freedBytes{0};
+    };
+
+    std::filesystem::path m_directory;
+    std::uint64_t m_maxBytes{kDefaultMaxBytes};
+    std::chrono::milliseconds m_orphanGracePeriod{kOrphanGracePeriod};
+    QTimer m_idleTimer;
+    bool m_busy{false};
+    // Shared with the running collection, which checks it before every deletion.
+    std::shared_ptr<std::atomic_bool> m_stopCollection;
+    QFuture<Collection> m_collection;
+};
+
+} // namespace SongPlayer
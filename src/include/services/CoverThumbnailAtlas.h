@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QFuture>
+#include <QQuickImageProvider>
+#include <QTimer>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+
+namespace SongPlayer {
+
+// Serves list-size cover thumbnails to QML (image://coverthumbs/<cover file name>)
+// from one memory-mapped atlas of pre-decoded tiles, so scrolling a long playlist
+// neither opens nor decodes image files. A cover missing from the atlas is decoded
+// from its thumbnail file once, and a debounced rebuild on the thread pool appends
+// it to the atlas. Images handed out keep their mapping alive, so an atlas swap
+// never invalidates pixels that QML still holds.
+class CoverThumbnailAtlas final : public QQuickImageProvider {
+    Q_OBJECT
+
+public:
+    explicit CoverThumbnailAtlas(std::filesystem::path coverCacheDirectory);
+    ~CoverThumbnailAtlas() override;
+
+    // Called by QML on its image reader thread.
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+
+    // Packs every list thumbnail that is not in the atlas yet and maps the result.
+    // New tiles are appended as a delta file; the base is rewritten only to drop
+    // tiles whose thumbnail file is gone or to merge too many deltas. Runs on the
+    // global thread pool; the future finishes once the new tiles serve requests.
+    QFuture<void> rebuild();
+
+private:
+    struct State;
+
+    void scheduleRebuild();
+
+    std::shared_ptr<State> m_state;
+    QTimer m_rebuildTimer;
+    QFuture<void> m_rebuild;
+    std::atomic_bool m_missReported{false};
+};
+
+} // namespace SongPlayer
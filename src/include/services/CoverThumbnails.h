@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QUrl>
+
+#include <filesystem>
+
+namespace SongPlayer::CoverThumbnails {
+
+// Image provider id under which the thumbnail atlas is registered with the engine.
+inline constexpr char kAtlasProviderId[] = "coverthumbs";
+
+// The cover cache in the per-user cache location, shared by importer and atlas.
+[[nodiscard]] std::filesystem::path coverCacheDirectory();
+
+// Writes the list and detail thumbnails of a cached cover into the thumbnail
+// directory beside it, skipping sizes that already exist. The cover is decoded once,
+// already downscaled by the image reader. Uses no QObject, so import workers may
+// call it; concurrent calls for the same cover are safe.
+void ensureForCover(const std::filesystem::path& coverFile) noexcept;
+
+// The thumbnail URL for a cover in the cover cache, or imageSource unchanged for any
+// other image (bundled icons, remote URLs). The file may not exist yet for covers
+// cached before thumbnails were introduced, so views fall back to imageSource.
+[[nodiscard]] QUrl thumbnailUrl(const QUrl& imageSource, int size);
+
+// image://coverthumbs/<cover file name> for a cover in the cover cache, imageSource
+// unchanged otherwise. Views fall back to imageSource when no atlas is registered.
+[[nodiscard]] QUrl atlasUrl(const QUrl& imageSource);
+
+} // namespace SongPlayer::CoverThumbnails
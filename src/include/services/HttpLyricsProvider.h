@@ -0,0 +1,66 @@
+#pragma once
+
+#include "interfaces/ILyricsProvider.h"
+
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QPointer>
+#include <QPromise>
+#include <QString>
+#include <QUrl>
+
+#include <deque>
+#include <memory>
+
+class QNetworkReply;
+
+// Fetches lyrics with GET <endpoint>?artist_name=…&track_name=…. The reply may be
+// the LRC text itself, a JSON object with "syncedLyrics" or "plainLyrics", or a
+// JSON array of such objects; HTTP 404 and empty answers mean "not found".
+class HttpLyricsProvider : public QObject, public ILyricsProvider
+{
+    Q_OBJECT
+
+public:
+    explicit HttpLyricsProvider(QUrl endpoint, QObject *parent = nullptr);
+    // Test seam: network tests inject a controlled access manager.
+    HttpLyricsProvider(QNetworkAccessManager *networkManager,
+                       QUrl endpoint,
+                       QObject *parent = nullptr);
+    ~HttpLyricsProvider() override;
+
+    // Requests for a track already being fetched share that fetch's future. At most
+    // maxConcurrentFetches() requests are on the network; the rest wait in order.
+    QFuture<LyricsFetchResult> fetchLyrics(const LyricsQuery &query) override;
+    // The last caller withdrawing aborts the request, or takes it out of the queue.
+    void cancelFetch(const LyricsQuery &query) override;
+
+    int maxConcurrentFetches() const;
+    void setMaxConcurrentFetches(int maxFetches);
+
+    QUrl endpoint() const;
+
+    static constexpr int kDefaultMaxConcurrentFetches = 2;
+
+private:
+    struct Fetch {
+        LyricsQuery query;
+        std::shared_ptr<QPromise<LyricsFetchResult>> promise;
+        QPointer<QNetworkReply> reply;
+        // Callers sharing the fetch that have not withdrawn.
+        int waiters{1};
+    };
+
+    void startQueuedFetches();
+    void handleReply(const QString &key, const QPointer<QNetworkReply> &reply);
+
+    QNetworkAccessManager m_ownedNetworkManager{};
+    QPointer<QNetworkAccessManager> m_networkManager{};
+    QUrl m_endpoint{};
+    // Queued and running fetches by track key; m_queue holds the keys not started yet.
+    QHash<QString, Fetch> m_fetches{};
+    std::deque<QString> m_queue{};
+    int m_runningFetches{0};
+    int m_maxConcurrentFetches{kDefaultMaxConcurrentFetches};
+};
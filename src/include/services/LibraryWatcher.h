@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+
+#include <chrono>
+#include <cstddef>
+
+namespace SongPlayer {
+
+// Watches the registered library folders and asks for rescans when files appear,
+// change or disappear. Directory events are collected until the folders have been
+// quiet for a while, so an album being copied in becomes one rescan of its folder
+// once the copy is done. Directory trees are listed on the thread pool.
+//
+// Watches are bounded by kMaxWatchedDirectories. A folder whose tree does not fit,
+// or that the platform refuses to watch (e.g. the inotify watch limit is reached),
+// is rescanned every kPollInterval instead; rescans compare file fingerprints, so
+// polling a quiet folder reads no metadata. Every poll also tries to watch the folders
+// that exist again, so a remounted drive goes back to change events.
+class LibraryWatcher final : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t kMaxWatchedDirectories = 4096;
+    static constexpr std::chrono::milliseconds kSettleDelay{2000};
+    static constexpr std::chrono::minutes kPollInterval{10};
+
+    explicit LibraryWatcher(QObject* parent = nullptr);
+
+    // Starts watching a local folder and everything below it; registering a folder
+    // again is a no-op.
+    void watchFolder(const QUrl& folderUrl);
+    // Stops watching or polling a registered folder; unknown folders are ignored.
+    void unwatchFolder(const QUrl& folderUrl);
+
+    [[nodiscard]] bool isPolled(const QUrl& folderUrl) const;
+    [[nodiscard]] int watchedDirectoryCount() const;
+
+    void setSettleDelay(std::chrono::milliseconds delay);
+    void setPollInterval(std::chrono::milliseconds interval);
+
+signals:
+    // The files of directory (and of its whole tree when recursive) may have changed.
+    // A subdirectory that disappeared may only have been renamed or moved, so it is
+    // reported as a recursive rescan of the closest directory that is still watched.
+    void rescanRequested(const QUrl& directory, bool recursive);
+    // The folder could not be watched and is polled from now on.
+    void folderPolled(const QUrl& folderUrl);
+
+private:
+    void addTree(const QString& root, const QString& folder);
+    void handleDirectoryChanged(const QString& path);
+    void settle();
+    void poll();
+    void pollFolder(const QString& folder);
+    // The registered folder path lies in, or an empty string.
+    [[nodiscard]] QString folderOf(const QString& path) const;
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_settleTimer;
+    QTimer m_pollTimer;
+    // Local paths of the registered folders and of those among them that are polled.
+    QSet<QString> m_folders;
+    QSet<QString> m_polledFolders;
+    QSet<QString> m_changedDirectories;
+};
+
+} // namespace SongPlayer
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/Lyrics.h"
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class QThreadPool;
+
+// Keeps the LRC file names of recently used directories, with each candidate name
+// already normalized for fuzzy matching. Watched directories are updated from file
+// system events, so a lookup never rescans a directory it has already seen.
+class LrcDirectoryIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Listing {
+        QStringList filePaths;
+        std::vector<SongPlayer::Core::LyricFileName> names;
+    };
+
+    // Rescans triggered by file system events run on workerPool, which must outlive
+    // the index's pending work.
+    explicit LrcDirectoryIndex(QThreadPool *workerPool, QObject *parent = nullptr);
+
+    // Thread-safe. The first lookup of a directory scans it on the calling thread and
+    // starts watching it; later lookups return the current snapshot without I/O.
+    std::shared_ptr<const Listing> listing(const QString& dirPath);
+
+    // Reads one directory without indexing or watching it.
+    static std::shared_ptr<const Listing> scan(const QString& dirPath);
+
+    static constexpr std::size_t kMaxWatchedDirectories = 64;
+
+private:
+    struct Entry {
+        std::shared_ptr<const Listing> listing;
+        quint64 lastUsed{0};
+        // Set when the watcher refused the directory (for example on a file system
+        // without change notifications); such listings expire instead.
+        qint64 unwatchedScannedAt{-1};
+    };
+
+    void watch(const QString& dirPath, const QString& evictedDirPath);
+    void scheduleRescan(const QString& dirPath);
+    void installRescan(const QString& dirPath, std::shared_ptr<const Listing> listing, bool exists);
+
+    QThreadPool *m_workerPool{nullptr};
+    QFileSystemWatcher m_watcher;
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    quint64 m_useCounter{0};
+
+    // GUI-thread only: directories with a rescan running, and those that changed again
+    // while it ran and therefore need one more pass.
+    QSet<QString> m_rescanning;
+    QSet<QString> m_rescanAgain;
+
+    static constexpr qint64 kUnwatchedExpireMs = 30000;
+};
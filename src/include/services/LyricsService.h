@@ -1,11 +1,21 @@
 #pragma once
 
+#include "core/LyricCache.h"
 #include "core/Lyrics.h"
+#include "interfaces/ILyricsProvider.h"
+#include "services/LrcDirectoryIndex.h"
 
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QHash>
 #include <QObject>
+#include <QPromise>
 #include <QString>
-#include <QStringList>
+#include <QThreadPool>
+
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 class LyricsService : public QObject
@@ -16,18 +26,123 @@ public:
     using LyricLine = SongPlayer::Core::LyricLine;
 
     explicit LyricsService(QObject *parent = nullptr);
+    ~LyricsService() override;
+
+    // Looks up and parses the lyrics for an audio file on the service's worker pool.
+    // Canceling the returned future abandons the lookup at the next stage boundary
+    // and withdraws its request from the lyrics provider.
+    // A prefetched lookup for the same file is handed over instead of starting a new
+    // one, so the returned future may already be finished.
+    // A stored association that is still current replaces the sidecar search.
+    // When no local lyrics exist and remoteQuery is given, the lyrics provider is
+    // asked last; audioFilePath may then be empty (network streams).
+    QFuture<std::vector<LyricLine>> loadLyrics(
+        const QString& audioFilePath,
+        std::optional<SongPlayer::Core::LyricAssociation> association = std::nullopt,
+        std::optional<LyricsQuery> remoteQuery = std::nullopt);
+
+    // Starts a background lookup whose result is kept in a small cache until
+    // loadLyrics() asks for the same file.
+    void prefetchLyrics(const QString& audioFilePath,
+                        std::optional<SongPlayer::Core::LyricAssociation> association = std::nullopt,
+                        std::optional<LyricsQuery> remoteQuery = std::nullopt);
+
+    // Not owned; nullptr disables remote lookups. Fetched lyrics and "not found"
+    // answers go into the lyric cache, the latter for kRemoteLyricsNotFoundTtlMs.
+    void setLyricsProvider(ILyricsProvider *provider);
+
+    struct LyricAssociationEntry {
+        QString audioFilePath;
+        std::optional<SongPlayer::Core::LyricAssociation> association;
+    };
+
+    // Checks every entry's stored association against the file system and resolves
+    // the missing or stale ones. Only entries whose association changed are returned.
+    QFuture<std::vector<LyricAssociationEntry>> resolveLyricAssociations(
+        std::vector<LyricAssociationEntry> entries);
+
+    struct LyricTextEntry {
+        QString audioFilePath;
+        std::optional<SongPlayer::Core::LyricAssociation> association;
+        // What the search index last saw for the track: whether it was indexed at all
+        // and from which source (nullopt for a track without lyrics).
+        bool indexed{false};
+        std::optional<SongPlayer::Core::LyricSourceIdentity> source;
+        std::vector<LyricLine> lyrics;
+    };
 
-    std::vector<LyricLine> parseLrcFile(const QString& audioFilePath);
+    // Resolves every entry's lyrics the same way playback does and returns the
+    // entries whose lyric source differs from the indexed one, with source and
+    // lyrics replaced by the current ones.
+    QFuture<std::vector<LyricTextEntry>> collectLyricText(std::vector<LyricTextEntry> entries);
+
+    // Keeps lyrics found in the audio file's own tags so playback can show them
+    // without reopening the audio file when no sidecar LRC exists.
+    QFuture<void> storeEmbeddedLyrics(const QString& audioFilePath, const QString& lyricsText);
 
 private:
-    QString findLrcFile(const QString& audioFilePath);
+    struct ResolvedLyrics {
+        // The LRC file, or the audio file itself for embedded lyrics.
+        std::optional<SongPlayer::Core::LyricSourceIdentity> source;
+        std::vector<LyricLine> lyrics;
+    };
 
-    QString findBestLrcMatch(const QString& audioFilePath);
+    template <typename T>
+    ResolvedLyrics resolveLyrics(const QString& audioFilePath,
+                                 const std::optional<SongPlayer::Core::LyricAssociation>& association,
+                                 const QPromise<T>& promise);
+    bool associationIsCurrent(const QString& audioFilePath,
+                              const SongPlayer::Core::LyricAssociation& association) const;
+    std::optional<SongPlayer::Core::LyricAssociation> resolveAssociation(
+        const QString& audioFilePath,
+        QHash<QString, std::shared_ptr<const LrcDirectoryIndex::Listing>>& listings) const;
+    std::optional<ResolvedLyrics> loadEmbeddedLyrics(const QString& audioFilePath) const;
+    ResolvedLyrics loadLrcFile(const QString& lrcFilePath);
+    // The provider request behind one loadLyrics() call, so canceling the call can
+    // withdraw it. GUI-thread only.
+    struct RemoteFetch {
+        LyricsQuery query;
+        // Invalid until the provider is asked.
+        QFuture<LyricsFetchResult> request;
+        bool canceled{false};
+    };
+
+    QFuture<std::vector<LyricLine>> loadRemoteLyrics(const std::shared_ptr<RemoteFetch>& fetch);
+    // Continuations do not pass a cancel back up the chain, so the lookup's own
+    // future is watched and both the local search and the provider told directly.
+    void withdrawOnCancel(const QFuture<std::vector<LyricLine>>& lyrics,
+                          const std::shared_ptr<RemoteFetch>& fetch,
+                          QFuture<std::vector<LyricLine>> local = {});
+    std::optional<std::vector<LyricLine>> loadRemoteCachedLyrics(
+        const SongPlayer::Core::LyricSourceIdentity& source) const;
+    std::optional<SongPlayer::Core::LyricSourceIdentity> sourceIdentity(const QString& filePath) const;
+    std::optional<std::vector<LyricLine>> loadCachedLyrics(
+        const SongPlayer::Core::LyricSourceIdentity& source) const;
+    void storeCachedLyrics(const SongPlayer::Core::LyricSourceIdentity& source,
+                           std::span<const LyricLine> lyrics) const;
+    QString cacheFilePath(const SongPlayer::Core::LyricSourceIdentity& source) const;
 
-    QStringList scanDirectoryForLrcFiles(const QString& dirPath);
+    QString findExactLrcFile(const QString& audioFilePath) const;
+
+    QString findBestLrcMatch(const QString& audioFilePath);
+    static QString bestLrcMatch(const QString& audioBaseName, const LrcDirectoryIndex::Listing& listing);
 
 private:
-    QHash<QString, QStringList> m_directoryCache;
-    QHash<QString, qint64> m_cacheTimestamp;
-    static constexpr qint64 CACHE_EXPIRE_TIME = 30000;
+    const QString m_cacheDirectory;
+    QThreadPool m_pool;
+    LrcDirectoryIndex m_lrcIndex{&m_pool};
+    // GUI-thread only.
+    ILyricsProvider *m_lyricsProvider{nullptr};
+
+    // GUI-thread only. Most recently prefetched first; bounded by kPrefetchCapacity.
+    struct PrefetchedLyrics {
+        QString audioFilePath;
+        QFuture<std::vector<LyricLine>> lyrics;
+        QElapsedTimer age;
+    };
+    std::vector<PrefetchedLyrics> m_prefetched;
+    static constexpr std::size_t kPrefetchCapacity = 4;
+    // Long enough to span the tail of a long track, short enough that an LRC edit
+    // made meanwhile is not masked for the rest of the session.
+    static constexpr qint64 kPrefetchMaxAgeMs = 5 * 60 * 1000;
 };
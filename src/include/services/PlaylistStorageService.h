@@ -1,15 +1,21 @@
 #pragma once
 
 #include "core/AudioTrack.h"
+#include "core/FileFingerprint.h"
+#include "core/LyricCache.h"
+#include "core/Lyrics.h"
 #include "core/PlayMode.h"
 
 #include <QDateTime>
+#include <QFuture>
 #include <QObject>
 #include <QSqlQuery>
 #include <QString>
 #include <QStringList>
+#include <QUrl>
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <span>
@@ -32,6 +38,63 @@ struct PlaylistInfo {
     std::vector<SongPlayer::Core::AudioTrack> audioItems{};
 };
 
+/**
+ * @brief Lyric association of one library track
+ *
+ * association is empty for tracks that were never resolved.
+ */
+struct StoredLyricAssociation {
+    QUrl audioSource{};
+    std::optional<SongPlayer::Core::LyricAssociation> association{};
+};
+
+/**
+ * @brief Lyric search index state of one library track
+ *
+ * indexedSource is only meaningful when indexed is set; an indexed track without a
+ * source has no lyrics.
+ */
+struct StoredLyricSearchSource {
+    QUrl audioSource{};
+    std::optional<SongPlayer::Core::LyricAssociation> association{};
+    bool indexed{false};
+    std::optional<SongPlayer::Core::LyricSourceIdentity> indexedSource{};
+};
+
+/**
+ * @brief Lyric lines to put into the search index for one library track
+ */
+struct IndexedLyricText {
+    QUrl audioSource{};
+    std::optional<SongPlayer::Core::LyricSourceIdentity> source{};
+    std::vector<SongPlayer::Core::LyricLine> lyrics{};
+};
+
+/**
+ * @brief One lyric line matching a full-text search
+ */
+struct LyricSearchMatch {
+    QUrl audioSource{};
+    qint64 timestampMs{0};
+    QString lineText{};
+};
+
+/**
+ * @brief Fingerprint an imported local file had when its metadata was read
+ */
+struct StoredFileFingerprint {
+    QUrl audioSource{};
+    SongPlayer::Core::FileFingerprint fingerprint{};
+};
+
+/**
+ * @brief Audio properties read again for a track already in the library
+ */
+struct StoredAudioProperties {
+    QUrl audioSource{};
+    SongPlayer::Core::AudioProperties properties{};
+};
+
 /**
  * @brief Playlist storage service class
  *
@@ -66,6 +129,53 @@ public:
     bool deletePlaylist(const QString& playlistName);
     bool renamePlaylist(const QString& oldName, const QString& newName);
 
+    // One indexed lookup used on every track change.
+    std::optional<SongPlayer::Core::LyricAssociation> lyricAssociation(const QUrl& audioSource);
+    // Every audio item in the library with its stored association, if any.
+    std::vector<StoredLyricAssociation> libraryLyricAssociations();
+    bool storeLyricAssociations(std::span<const StoredLyricAssociation> associations);
+
+    bool lyricSearchAvailable() const;
+    // Every local library track with its association and what it was last indexed from.
+    std::vector<StoredLyricSearchSource> lyricSearchSources();
+    // The same for the given tracks only; sources outside the library are skipped.
+    std::vector<StoredLyricSearchSource> lyricSearchSources(std::span<const QUrl> audioSources);
+    // Replaces the indexed lines of each given track.
+    bool storeLyricSearchText(std::span<const IndexedLyricText> entries);
+    // Best-ranked matching lines first.
+    std::vector<LyricSearchMatch> searchLyrics(const QString& text, int limit = 100);
+    // The same search on the thread pool, over a read-only connection of its own.
+    QFuture<std::vector<LyricSearchMatch>> searchLyricsAsync(const QString& text, int limit = 100);
+
+    // Every recorded fingerprint.
+    std::vector<StoredFileFingerprint> fileFingerprints();
+    // Reads the fingerprints recorded below a folder, for a rescan of it to diff
+    // against. The reader may run on any thread; like searchLyricsAsync() it uses a
+    // read-only connection of its own.
+    std::function<std::vector<StoredFileFingerprint>()> folderFingerprintsReader(const QUrl& folderUrl) const;
+    // Replaces the fingerprints of the given files in one batch.
+    bool storeFileFingerprints(std::span<const StoredFileFingerprint> fingerprints);
+    // Local tracks whose audio properties were never read: duration 0 and no recorded
+    // fingerprint, as imports from before properties were stored left them. Read on the
+    // thread pool, like searchLyricsAsync().
+    QFuture<std::vector<QUrl>> tracksWithoutPropertiesAsync();
+    // Writes re-read properties into the audio items of those files in one batch.
+    bool storeAudioProperties(std::span<const StoredAudioProperties> properties);
+    // Forgets files that no longer exist: their fingerprints, their audio items and
+    // everything attached to those (playlist entries, lyric associations and index).
+    // With keepPlaylistEntries, audio items that a playlist still lists stay as they are.
+    bool removeLibraryFiles(std::span<const QUrl> audioSources, bool keepPlaylistEntries = false);
+
+    // Folders the user chose to watch, rescanned at start and watched while the player runs.
+    std::vector<QUrl> libraryFolders();
+    bool addLibraryFolder(const QUrl& folderUrl);
+    bool removeLibraryFolder(const QUrl& folderUrl);
+
+    // Every distinct cover image the library refers to, for the cover cache collection.
+    std::vector<QUrl> coverImageSources();
+    // The same list read on the thread pool, like searchLyricsAsync().
+    QFuture<std::vector<QUrl>> coverImageSourcesAsync();
+
     QString lastError() const;
 
 signals:
@@ -26,9 +26,16 @@ public:
     bool initializeDatabase();
     void closeDatabase();
     bool createTables();
+    // False when the SQLite build lacks FTS5; lyric search is then disabled.
+    bool lyricSearchAvailable() const;
+    // The SQLite file, for reads that run over a connection of their own.
+    QString databasePath() const;
 
     QSqlQuery executeQuery(const QString &queryString, const QVariantList &values = QVariantList());
     bool executeNonQuery(const QString &queryString, const QVariantList &values = QVariantList());
+    // Prepares once and runs the statement for every row; each element of columns is
+    // the QVariantList of one placeholder's values.
+    bool executeBatch(const QString &queryString, const QVariantList &columns);
 
 
     bool beginTransaction();
@@ -49,11 +56,19 @@ private:
     QSqlDatabase m_database{};
     QString m_databasePath{};
     QString m_lastError{};
+    bool m_lyricSearchAvailable{false};
+    // Set when this start added the audio property columns to an existing table.
+    bool m_audioPropertiesAdded{false};
 
     QString getDatabasePath();
     bool createPlaylistsTable();
     bool createAudioItemsTable();
+    bool addAudioPropertyColumns();
     bool createPlaylistItemsTable();
+    bool createLyricAssociationsTable();
+    bool createLyricSearchTables();
+    bool createFileFingerprintsTable();
+    bool createLibraryFoldersTable();
     bool createIndexes();
 };
 
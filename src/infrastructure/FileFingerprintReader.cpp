@@ -0,0 +1,53 @@
+#include "infrastructure/FileFingerprintReader.h"
+
+#include <chrono>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+namespace SongPlayer::Infrastructure {
+
+std::optional<Core::FileFingerprint> readFileFingerprint(const std::filesystem::path& file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status {};
+    if (::stat(file.c_str(), &status) != 0) {
+        return std::nullopt;
+    }
+#if defined(__APPLE__)
+    const struct timespec& modified = status.st_mtimespec;
+#else
+    const struct timespec& modified = status.st_mtim;
+#endif
+    return Core::FileFingerprint{
+        .device = static_cast<std::uint64_t>(status.st_dev),
+        .inode = static_cast<std::uint64_t>(status.st_ino),
+        .size = static_cast<std::uint64_t>(status.st_size),
+        .modifiedNs = static_cast<std::int64_t>(modified.tv_sec) * 1'000'000'000 + modified.tv_nsec,
+    };
+#else
+    // Without inode numbers a file replaced by one of the same size and time goes
+    // unnoticed, which only costs a missed metadata refresh.
+    std::error_code error;
+    const std::uintmax_t size = std::filesystem::file_size(file, error);
+    if (error) {
+        return std::nullopt;
+    }
+    const auto modified = std::filesystem::last_write_time(file, error);
+    if (error) {
+        return std::nullopt;
+    }
+    return Core::FileFingerprint{
+        .device = 0,
+        .inode = 0,
+        .size = static_cast<std::uint64_t>(size),
+        .modifiedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          modified.time_since_epoch()).count(),
+    };
+#endif
+}
+
+} // namespace SongPlayer::Infrastructure
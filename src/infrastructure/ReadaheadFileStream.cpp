@@ -0,0 +1,252 @@
+#include "infrastructure/ReadaheadFileStream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SongPlayer::Infrastructure {
+namespace {
+
+constexpr std::size_t kId3v2HeaderBytes = 10;
+// Room after the ID3v2 tag for the first MPEG frame and its Xing/VBRI header.
+constexpr std::size_t kFirstFrameBytes = 4096;
+
+// Sizes the head read after the ID3v2 tag, whose header states its length as a
+// synchsafe integer, so a large embedded cover does not fall out of the head.
+std::size_t headBytesFor(const char* header, std::size_t available)
+{
+    if (available < kId3v2HeaderBytes || std::memcmp(header, "ID3", 3) != 0) {
+        return ReadaheadFileStream::kHeadBytes;
+    }
+    std::size_t tagBytes = 0;
+    for (std::size_t index = 6; index < kId3v2HeaderBytes; ++index) {
+        tagBytes = (tagBytes << 7) | (static_cast<unsigned char>(header[index]) & 0x7f);
+    }
+    // A footer repeats the header at the end of the tag.
+    const bool hasFooter = (static_cast<unsigned char>(header[5]) & 0x10) != 0;
+    const std::size_t wanted = kId3v2HeaderBytes * (hasFooter ? 2 : 1) + tagBytes + kFirstFrameBytes;
+    return std::clamp(wanted, ReadaheadFileStream::kHeadBytes, ReadaheadFileStream::kMaxHeadBytes);
+}
+
+} // namespace
+
+bool ReadaheadFileStream::Region::contains(TagLib::offset_t offset) const noexcept
+{
+    return offset >= start && offset - start < static_cast<TagLib::offset_t>(bytes.size());
+}
+
+std::unique_ptr<ReadaheadFileStream> ReadaheadFileStream::open(const std::filesystem::path& file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    const int descriptor = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return nullptr;
+    }
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+        ::close(descriptor);
+        return nullptr;
+    }
+    std::unique_ptr<ReadaheadFileStream> stream(
+        new ReadaheadFileStream(file, descriptor, static_cast<TagLib::offset_t>(status.st_size)));
+    stream->prefetch();
+    return stream;
+#else
+    static_cast<void>(file);
+    return nullptr;
+#endif
+}
+
+ReadaheadFileStream::ReadaheadFileStream(std::filesystem::path file, int descriptor, TagLib::offset_t length)
+    : m_file(std::move(file))
+    , m_descriptor(descriptor)
+    , m_length(length)
+{
+}
+
+ReadaheadFileStream::~ReadaheadFileStream()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (m_descriptor >= 0) {
+        ::close(m_descriptor);
+    }
+#endif
+}
+
+void ReadaheadFileStream::prefetch()
+{
+    char header[kId3v2HeaderBytes] = {};
+    const std::size_t headerBytes = readAt(0, header, sizeof(header));
+    const auto length = static_cast<std::uint64_t>(m_length);
+    const std::size_t headBytes = static_cast<std::size_t>(
+        std::min<std::uint64_t>(headBytesFor(header, headerBytes), length));
+    const std::size_t tailBytes = static_cast<std::size_t>(
+        std::min<std::uint64_t>(kTailBytes, length - headBytes));
+    const TagLib::offset_t tailStart = m_length - static_cast<TagLib::offset_t>(tailBytes);
+
+#if defined(POSIX_FADV_WILLNEED)
+    // Both regions are requested before either is waited for, so a disk can serve
+    // them in one sweep and a network mount can fetch them concurrently.
+    ::posix_fadvise(m_descriptor, 0, static_cast<off_t>(headBytes), POSIX_FADV_WILLNEED);
+    if (tailBytes > 0) {
+        ::posix_fadvise(m_descriptor, static_cast<off_t>(tailStart), static_cast<off_t>(tailBytes),
+                        POSIX_FADV_WILLNEED);
+    }
+#endif
+    fill(m_head, 0, headBytes);
+    if (tailBytes > 0) {
+        fill(m_tail, tailStart, tailBytes);
+    }
+}
+
+std::size_t ReadaheadFileStream::readAt(TagLib::offset_t offset, char* data, std::size_t length)
+{
+    std::size_t total = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    while (total < length) {
+        ++m_fileReads;
+        const ssize_t count = ::pread(m_descriptor, data + total, length - total,
+                                      static_cast<off_t>(offset) + static_cast<off_t>(total));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        total += static_cast<std::size_t>(count);
+    }
+#else
+    static_cast<void>(offset);
+    static_cast<void>(data);
+    static_cast<void>(length);
+#endif
+    return total;
+}
+
+bool ReadaheadFileStream::fill(Region& region, TagLib::offset_t start, std::size_t length)
+{
+    region.start = start;
+    region.bytes.resize(length);
+    region.bytes.resize(readAt(start, region.bytes.data(), length));
+    return !region.bytes.empty();
+}
+
+const ReadaheadFileStream::Region* ReadaheadFileStream::regionAt(TagLib::offset_t offset) const noexcept
+{
+    for (const Region* region : {&m_head, &m_tail, &m_window}) {
+        if (region->contains(offset)) {
+            return region;
+        }
+    }
+    return nullptr;
+}
+
+TagLib::FileName ReadaheadFileStream::name() const
+{
+    return m_file.c_str();
+}
+
+TagLib::ByteVector ReadaheadFileStream::readBlock(std::size_t length)
+{
+    if (m_position < 0 || m_position >= m_length) {
+        return {};
+    }
+    const auto remaining = static_cast<std::uint64_t>(m_length - m_position);
+    const auto wanted = static_cast<unsigned int>(std::min<std::uint64_t>(
+        {static_cast<std::uint64_t>(length), remaining, std::numeric_limits<unsigned int>::max()}));
+
+    TagLib::ByteVector result(wanted, '\0');
+    std::size_t copied = 0;
+    while (copied < wanted) {
+        const TagLib::offset_t offset = m_position + static_cast<TagLib::offset_t>(copied);
+        const std::size_t missing = wanted - copied;
+        const Region* region = regionAt(offset);
+        if (!region) {
+            // Large reads (audio payload, covers outside the head) go straight to
+            // the file; small ones pull in a whole window for the reads that follow.
+            if (missing >= kWindowBytes) {
+                const std::size_t count = readAt(offset, result.data() + copied, missing);
+                copied += count;
+                if (count < missing) {
+                    break;
+                }
+                continue;
+            }
+            if (!fill(m_window, offset, kWindowBytes)) {
+                break;
+            }
+            region = &m_window;
+        }
+        const std::size_t available = region->bytes.size() - static_cast<std::size_t>(offset - region->start);
+        const std::size_t count = std::min(missing, available);
+        std::memcpy(result.data() + copied, region->bytes.data() + (offset - region->start), count);
+        copied += count;
+    }
+
+    result.resize(static_cast<unsigned int>(copied));
+    m_position += static_cast<TagLib::offset_t>(copied);
+    return result;
+}
+
+void ReadaheadFileStream::writeBlock(const TagLib::ByteVector&)
+{
+}
+
+void ReadaheadFileStream::insert(const TagLib::ByteVector&, TagLib::offset_t, std::size_t)
+{
+}
+
+void ReadaheadFileStream::removeBlock(TagLib::offset_t, std::size_t)
+{
+}
+
+bool ReadaheadFileStream::readOnly() const
+{
+    return true;
+}
+
+bool ReadaheadFileStream::isOpen() const
+{
+    return m_descriptor >= 0;
+}
+
+void ReadaheadFileStream::seek(TagLib::offset_t offset, Position position)
+{
+    switch (position) {
+    case Beginning:
+        m_position = offset;
+        break;
+    case Current:
+        m_position += offset;
+        break;
+    case End:
+        m_position = m_length + offset;
+        break;
+    }
+    m_position = std::max<TagLib::offset_t>(m_position, 0);
+}
+
+TagLib::offset_t ReadaheadFileStream::tell() const
+{
+    return m_position;
+}
+
+TagLib::offset_t ReadaheadFileStream::length()
+{
+    return m_length;
+}
+
+void ReadaheadFileStream::truncate(TagLib::offset_t)
+{
+}
+
+} // namespace SongPlayer::Infrastructure
@@ -0,0 +1,86 @@
+#include "infrastructure/StorageDeviceProbe.h"
+
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#include <sys/sysmacros.h>
+#endif
+
+namespace SongPlayer::Infrastructure {
+namespace {
+
+#if defined(__linux__)
+bool readFlag(const std::filesystem::path& file, bool& value)
+{
+    std::ifstream stream(file);
+    int flag = 0;
+    if (!(stream >> flag)) {
+        return false;
+    }
+    value = flag != 0;
+    return true;
+}
+
+// /sys/dev/block/<major>:<minor> resolves to the disk or to a partition below it;
+// the queue and removable attributes only exist on the whole disk.
+bool sysfsFlag(const std::filesystem::path& device, const char* attribute)
+{
+    bool value = false;
+    if (readFlag(device / attribute, value)) {
+        return value;
+    }
+    std::error_code error;
+    const std::filesystem::path resolved = std::filesystem::canonical(device, error);
+    return !error && readFlag(resolved.parent_path() / attribute, value) && value;
+}
+
+bool deviceIsSequentialOnly(std::uint64_t id)
+{
+    const auto rawId = static_cast<dev_t>(id);
+    const std::filesystem::path device = std::filesystem::path("/sys/dev/block") /
+        (std::to_string(major(rawId)) + ':' + std::to_string(minor(rawId)));
+    // Network and virtual file systems have no block device entry and stay parallel.
+    return sysfsFlag(device, "queue/rotational") || sysfsFlag(device, "removable");
+}
+#else
+bool deviceIsSequentialOnly(std::uint64_t)
+{
+    return false;
+}
+#endif
+
+} // namespace
+
+StorageDevice StorageDeviceProbe::deviceFor(const std::filesystem::path& file)
+{
+    const std::filesystem::path directory = file.parent_path();
+    if (const auto known = m_directories.find(directory); known != m_directories.end()) {
+        return known->second;
+    }
+
+    StorageDevice device;
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status {};
+    if (::stat(directory.c_str(), &status) == 0) {
+        device.id = static_cast<std::uint64_t>(status.st_dev);
+    }
+#endif
+
+    if (device.id != 0) {
+        auto [sequential, inserted] = m_sequentialDevices.try_emplace(device.id, false);
+        if (inserted) {
+            sequential->second = deviceIsSequentialOnly(device.id);
+        }
+        device.sequentialOnly = sequential->second;
+    }
+
+    m_directories.emplace(directory, device);
+    return device;
+}
+
+} // namespace SongPlayer::Infrastructure
@@ -1,21 +1,40 @@
 #include "infrastructure/TagLibAudioMetadataReader.h"
 
 #include "core/AudioImport.h"
+#include "core/Lyrics.h"
+#include "infrastructure/ReadaheadFileStream.h"
 
+#include <taglib/apetag.h>
+#include <taglib/audioproperties.h>
 #include <taglib/attachedpictureframe.h>
 #include <taglib/fileref.h>
+#include <taglib/flacfile.h>
+#include <taglib/flacpicture.h>
 #include <taglib/id3v2tag.h>
+#include <taglib/mp4coverart.h>
+#include <taglib/mp4file.h>
+#include <taglib/mp4tag.h>
 #include <taglib/mpegfile.h>
+#include <taglib/wavpackfile.h>
+#include <taglib/xiphcomment.h>
+#include <taglib/synchronizedlyricsframe.h>
 #include <taglib/tag.h>
+#include <taglib/tpropertymap.h>
 
 #include <algorithm>
-#include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace SongPlayer::Infrastructure {
 namespace {
@@ -25,6 +44,11 @@ struct EmbeddedPicture {
     std::string mimeType;
 };
 
+struct EmbeddedExtras {
+    std::optional<EmbeddedPicture> cover;
+    std::string syncedLyrics;
+};
+
 std::string pathToUtf8(const std::filesystem::path& path)
 {
     const std::u8string value = path.generic_u8string();
@@ -42,55 +66,222 @@ std::string tagText(const TagLib::String& value)
     return value.to8Bit(true);
 }
 
-std::optional<EmbeddedPicture> embeddedMpegCover(const std::filesystem::path& audioFile)
+std::optional<EmbeddedPicture> frontCover(const TagLib::ID3v2::Tag& tag)
 {
-    std::string extension = pathToUtf8(audioFile.extension());
-    std::ranges::transform(extension, extension.begin(), [](unsigned char character) {
-        return static_cast<char>(std::tolower(character));
-    });
-    if (extension != ".mp3") {
+    const TagLib::ID3v2::FrameList frames = tag.frameList("APIC");
+    if (frames.isEmpty()) {
         return std::nullopt;
     }
 
-    TagLib::MPEG::File file(audioFile.c_str(), false);
-    if (!file.isValid()) {
+    // Encrypted or compressed frames come back as UnknownFrame, hence dynamic_cast.
+    const TagLib::ID3v2::AttachedPictureFrame* selected = nullptr;
+    for (const TagLib::ID3v2::Frame* frame : frames) {
+        const auto* picture = dynamic_cast<const TagLib::ID3v2::AttachedPictureFrame*>(frame);
+        if (!picture) {
+            continue;
+        }
+        if (picture->type() == TagLib::ID3v2::AttachedPictureFrame::FrontCover) {
+            selected = picture;
+            break;
+        }
+        if (!selected) {
+            selected = picture;
+        }
+    }
+    if (!selected || selected->picture().isEmpty()) {
         return std::nullopt;
     }
 
-    const TagLib::ID3v2::Tag* tag = file.ID3v2Tag(false);
-    if (!tag) {
-        return std::nullopt;
+    return EmbeddedPicture{
+        .bytes = selected->picture(),
+        .mimeType = tagText(selected->mimeType()),
+    };
+}
+
+std::string synchronizedLyrics(const TagLib::ID3v2::Tag& tag)
+{
+    // SYLT frames timed in MPEG frames cannot be converted without decoding the
+    // stream, so only millisecond-timed lyric frames are used.
+    for (const TagLib::ID3v2::Frame* frame : tag.frameList("SYLT")) {
+        // An encrypted or compressed SYLT frame is an UnknownFrame.
+        const auto* lyrics = dynamic_cast<const TagLib::ID3v2::SynchronizedLyricsFrame*>(frame);
+        if (!lyrics ||
+            lyrics->type() != TagLib::ID3v2::SynchronizedLyricsFrame::Lyrics ||
+            lyrics->timestampFormat() !=
+                TagLib::ID3v2::SynchronizedLyricsFrame::AbsoluteMilliseconds) {
+            continue;
+        }
+
+        std::vector<Core::LyricLine> lines;
+        for (const auto& synchedText : lyrics->synchedText()) {
+            std::string text = tagText(synchedText.text);
+            if (!text.empty()) {
+                lines.push_back(Core::LyricLine{
+                    .timestampMs = static_cast<std::int64_t>(synchedText.time),
+                    .text = std::move(text),
+                });
+            }
+        }
+        if (!lines.empty()) {
+            std::ranges::stable_sort(lines, {}, &Core::LyricLine::timestampMs);
+            return Core::formatLrcContent(lines);
+        }
     }
+    return {};
+}
 
-    const TagLib::ID3v2::FrameList frames = tag->frameList("APIC");
-    if (frames.isEmpty()) {
-        return std::nullopt;
+// Falls back to sniffing the image bytes when the container's type is missing or
+// not one the cover cache understands.
+std::string pictureMimeType(const TagLib::ByteVector& bytes, std::string declared)
+{
+    if (Core::imageExtensionForMimeType(declared) != Core::imageExtensionForMimeType("")) {
+        return declared;
     }
+    return std::string(Core::imageMimeTypeForData(
+        std::string_view(bytes.data(), std::min<std::size_t>(bytes.size(), 16))));
+}
 
-    const TagLib::ID3v2::AttachedPictureFrame* selected = nullptr;
-    for (const TagLib::ID3v2::Frame* frame : frames) {
-        const auto* picture = static_cast<const TagLib::ID3v2::AttachedPictureFrame*>(frame);
-        if (picture && picture->type() == TagLib::ID3v2::AttachedPictureFrame::FrontCover) {
+// FLAC PICTURE blocks and Vorbis/Opus METADATA_BLOCK_PICTURE comments share one type.
+std::optional<EmbeddedPicture> frontCover(const TagLib::List<TagLib::FLAC::Picture*>& pictures)
+{
+    const TagLib::FLAC::Picture* selected = nullptr;
+    for (const TagLib::FLAC::Picture* picture : pictures) {
+        if (!picture || picture->data().isEmpty()) {
+            continue;
+        }
+        if (picture->type() == TagLib::FLAC::Picture::FrontCover) {
             selected = picture;
             break;
         }
+        if (!selected) {
+            selected = picture;
+        }
     }
-
     if (!selected) {
-        selected = static_cast<const TagLib::ID3v2::AttachedPictureFrame*>(frames.front());
+        return std::nullopt;
     }
-    if (!selected || selected->picture().isEmpty()) {
+
+    return EmbeddedPicture{
+        .bytes = selected->data(),
+        .mimeType = pictureMimeType(selected->data(), tagText(selected->mimeType())),
+    };
+}
+
+// MP4 covr atoms carry no picture type; the first one is the front cover by convention.
+std::optional<EmbeddedPicture> frontCover(const TagLib::MP4::Tag& tag)
+{
+    if (!tag.contains("covr")) {
+        return std::nullopt;
+    }
+
+    for (const TagLib::MP4::CoverArt& cover : tag.item("covr").toCoverArtList()) {
+        if (cover.data().isEmpty()) {
+            continue;
+        }
+        std::string mimeType;
+        if (cover.format() == TagLib::MP4::CoverArt::JPEG) {
+            mimeType = "image/jpeg";
+        } else if (cover.format() == TagLib::MP4::CoverArt::PNG) {
+            mimeType = "image/png";
+        }
+        return EmbeddedPicture{
+            .bytes = cover.data(),
+            .mimeType = pictureMimeType(cover.data(), std::move(mimeType)),
+        };
+    }
+    return std::nullopt;
+}
+
+// APE binary items store "<file name>\0<image bytes>".
+std::optional<EmbeddedPicture> frontCover(const TagLib::APE::Tag& tag)
+{
+    const TagLib::APE::ItemListMap& items = tag.itemListMap();
+    const auto item = items.find("COVER ART (FRONT)");
+    if (item == items.end()) {
+        return std::nullopt;
+    }
+
+    const TagLib::ByteVector value = item->second.binaryData();
+    const int separator = value.find(TagLib::ByteVector(1, '\0'));
+    if (separator < 0 || static_cast<unsigned int>(separator) + 1 >= value.size()) {
         return std::nullopt;
     }
 
+    const std::string fileName(value.data(), static_cast<std::size_t>(separator));
+    const std::size_t dot = fileName.rfind('.');
+    const std::string_view extension = dot == std::string::npos
+        ? std::string_view{}
+        : std::string_view(fileName).substr(dot + 1);
+    const TagLib::ByteVector bytes = value.mid(static_cast<unsigned int>(separator) + 1);
     return EmbeddedPicture{
-        .bytes = selected->picture(),
-        .mimeType = tagText(selected->mimeType()),
+        .bytes = bytes,
+        .mimeType = pictureMimeType(bytes, std::string(Core::imageMimeTypeForExtension(extension))),
     };
 }
 
+// Format-specific data that the unified FileRef API does not expose. It is taken
+// from the already parsed file, so no file is opened or parsed twice.
+EmbeddedExtras readEmbeddedExtras(TagLib::File& file)
+{
+    if (auto* mpegFile = dynamic_cast<TagLib::MPEG::File*>(&file)) {
+        const TagLib::ID3v2::Tag* tag = mpegFile->ID3v2Tag(false);
+        if (!tag) {
+            return {};
+        }
+        return EmbeddedExtras{
+            .cover = frontCover(*tag),
+            .syncedLyrics = synchronizedLyrics(*tag),
+        };
+    }
+
+    if (auto* flacFile = dynamic_cast<TagLib::FLAC::File*>(&file)) {
+        // pictureList() holds the PICTURE metadata blocks; some taggers write the
+        // cover into the Vorbis comment instead.
+        std::optional<EmbeddedPicture> cover = frontCover(flacFile->pictureList());
+        if (!cover && flacFile->hasXiphComment()) {
+            cover = frontCover(flacFile->xiphComment()->pictureList());
+        }
+        return EmbeddedExtras{.cover = std::move(cover), .syncedLyrics = {}};
+    }
+
+    if (auto* mp4File = dynamic_cast<TagLib::MP4::File*>(&file)) {
+        if (!mp4File->hasMP4Tag()) {
+            return {};
+        }
+        return EmbeddedExtras{.cover = frontCover(*mp4File->tag()), .syncedLyrics = {}};
+    }
+
+    if (auto* wavPackFile = dynamic_cast<TagLib::WavPack::File*>(&file)) {
+        const TagLib::APE::Tag* tag = wavPackFile->APETag(false);
+        if (!tag) {
+            return {};
+        }
+        return EmbeddedExtras{.cover = frontCover(*tag), .syncedLyrics = {}};
+    }
+
+    // Ogg Vorbis, Opus, Speex and Ogg FLAC all keep their tags in a Xiph comment.
+    if (auto* xiphComment = dynamic_cast<TagLib::Ogg::XiphComment*>(file.tag())) {
+        return EmbeddedExtras{.cover = frontCover(xiphComment->pictureList()), .syncedLyrics = {}};
+    }
+
+    return {};
+}
+
+std::string unsynchronizedLyrics(const TagLib::FileRef& file)
+{
+    // The unified property map already folds ID3v2 USLT, Xiph LYRICS, MP4 \xa9lyr
+    // and APE Lyrics into a single LYRICS key.
+    const TagLib::PropertyMap properties = file.properties();
+    const auto lyrics = properties.find("LYRICS");
+    if (lyrics == properties.end() || lyrics->second.isEmpty()) {
+        return {};
+    }
+    return tagText(lyrics->second.front());
+}
+
+// Covers are content-addressed: a cover that is already cached, for example by
+// another track of the same album, is reused without writing anything.
 std::optional<std::filesystem::path> cachePicture(
-    const std::filesystem::path& audioFile,
     const std::filesystem::path& cacheDirectory,
     const EmbeddedPicture& picture)
 {
@@ -100,19 +291,19 @@ std::optional<std::filesystem::path> cachePicture(
         return std::nullopt;
     }
 
-    const std::string stem = pathToUtf8(audioFile.stem());
-    const std::string sourceIdentity = pathToUtf8(audioFile.lexically_normal());
     const std::string_view extension = Core::imageExtensionForMimeType(picture.mimeType);
-    const std::filesystem::path target = cacheDirectory / pathFromUtf8(
-        Core::coverFileNameForAudio(stem, sourceIdentity, extension));
+    const std::filesystem::path target = cacheDirectory / pathFromUtf8(Core::coverFileNameForImage(
+        std::string_view(picture.bytes.data(), picture.bytes.size()), extension));
 
     if (std::filesystem::is_regular_file(target, error) && !error) {
         return target;
     }
     error.clear();
 
+    // Parallel import workers may cache the same cover at once, so each writer needs
+    // its own temporary file.
     std::filesystem::path temporary = target;
-    temporary += ".tmp";
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
     {
         std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
         if (!output) {
@@ -160,22 +351,51 @@ Core::AudioImportResult TagLibAudioMetadataReader::read(
             .artist = std::string(Core::kUnknownArtistName),
             .audioFile = request.audioFile,
             .coverFile = std::nullopt,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
         };
 
-        TagLib::FileRef file(request.audioFile.c_str(), false);
-        if (!file.isNull() && file.tag()) {
-            const TagLib::Tag* tag = file.tag();
+        // One open and one parse per file: FileRef picks the concrete format, and
+        // format-specific frames are read from that same object. Fast audio properties
+        // come from the stream headers the parse reads anyway; for VBR MP3 without a
+        // Xing/VBRI header the duration is estimated from the first frame's bitrate.
+        // The parse reads through a stream that fetches the tag regions in a few large
+        // reads; the stream must outlive the FileRef.
+        const std::unique_ptr<ReadaheadFileStream> stream = ReadaheadFileStream::open(request.audioFile);
+        TagLib::FileRef file = stream
+            ? TagLib::FileRef(stream.get(), true, TagLib::AudioProperties::Fast)
+            : TagLib::FileRef(request.audioFile.c_str(), true, TagLib::AudioProperties::Fast);
+        if (file.isNull()) {
+            return imported;
+        }
+
+        if (const TagLib::AudioProperties* properties = file.audioProperties()) {
+            imported.properties = Core::AudioProperties{
+                .durationMs = properties->lengthInMilliseconds(),
+                .bitrateKbps = properties->bitrate(),
+                .sampleRateHz = properties->sampleRate(),
+                .channels = properties->channels(),
+            };
+        }
+
+        if (const TagLib::Tag* tag = file.tag()) {
             if (!tag->title().isEmpty()) {
                 imported.title = tagText(tag->title());
             }
             if (!tag->artist().isEmpty()) {
                 imported.artist = tagText(tag->artist());
             }
+            imported.embeddedLyrics = unsynchronizedLyrics(file);
         }
 
-        if (const auto picture = embeddedMpegCover(request.audioFile)) {
-            imported.coverFile = cachePicture(
-                request.audioFile, request.coverCacheDirectory, *picture);
+        EmbeddedExtras extras = readEmbeddedExtras(*file.file());
+        if (extras.cover) {
+            imported.coverFile = cachePicture(request.coverCacheDirectory, *extras.cover);
+        }
+        // Synchronized lyrics win over plain text; plain USLT content may itself be LRC.
+        if (!extras.syncedLyrics.empty()) {
+            imported.embeddedLyrics = std::move(extras.syncedLyrics);
         }
 
         return imported;
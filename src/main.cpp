@@ -1,3 +1,6 @@
+#include "services/CoverThumbnailAtlas.h"
+#include "services/CoverThumbnails.h"
+
 #include <QGuiApplication>
 #include <QIcon>
 #include <QQmlApplicationEngine>
@@ -9,6 +12,9 @@ int main(int argc, char *argv[])
     app.setWindowIcon(QIcon(":/qt/qml/MySongPlayer/assets/icons/app_icon.ico"));
 
     QQmlApplicationEngine engine;
+    // The engine takes ownership of the provider.
+    engine.addImageProvider(QString::fromLatin1(SongPlayer::CoverThumbnails::kAtlasProviderId),
+                            new SongPlayer::CoverThumbnailAtlas(SongPlayer::CoverThumbnails::coverCacheDirectory()));
 
     QObject::connect(
       &engine,
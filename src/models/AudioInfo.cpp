@@ -1,5 +1,8 @@
 #include "models/AudioInfo.h"
 
+#include "core/AudioImport.h"
+#include "services/CoverThumbnails.h"
+
 AudioInfo::AudioInfo(QObject *parent)
     : QObject{parent}
 {}
@@ -56,6 +59,16 @@ void AudioInfo::setImageSource(const QUrl &newImageSource)
     emit imageSourceChanged();
 }
 
+QUrl AudioInfo::listImageSource() const
+{
+    return SongPlayer::CoverThumbnails::atlasUrl(m_imageSource);
+}
+
+QUrl AudioInfo::detailImageSource() const
+{
+    return SongPlayer::CoverThumbnails::thumbnailUrl(m_imageSource, SongPlayer::Core::kDetailThumbnailSize);
+}
+
 QUrl AudioInfo::videoSource() const
 {
     return m_videoSource;
@@ -81,3 +94,36 @@ void AudioInfo::setAudioSource(const QUrl &newAudioSource)
     m_audioSource = newAudioSource;
     emit audioSourceChanged();
 }
+
+SongPlayer::Core::AudioProperties AudioInfo::audioProperties() const
+{
+    return m_audioProperties;
+}
+
+void AudioInfo::setAudioProperties(const SongPlayer::Core::AudioProperties &newProperties)
+{
+    if (m_audioProperties == newProperties)
+        return;
+    m_audioProperties = newProperties;
+    emit audioPropertiesChanged();
+}
+
+qint64 AudioInfo::durationMs() const
+{
+    return m_audioProperties.durationMs;
+}
+
+int AudioInfo::bitrateKbps() const
+{
+    return m_audioProperties.bitrateKbps;
+}
+
+int AudioInfo::sampleRateHz() const
+{
+    return m_audioProperties.sampleRateHz;
+}
+
+int AudioInfo::channels() const
+{
+    return m_audioProperties.channels;
+}
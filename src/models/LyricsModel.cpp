@@ -13,13 +13,51 @@ QString toQString(const std::string& value)
 } // namespace
 
 LyricsModel::LyricsModel(QObject *parent)
-    : QObject(parent)
+    : QAbstractListModel(parent)
     , m_currentLineIndex(-1)
     , m_hasLyrics(false)
     , m_showLyrics(false)
 {
 }
 
+int LyricsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_lyrics.size());
+}
+
+QVariant LyricsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || static_cast<std::size_t>(index.row()) >= m_lyrics.size()) {
+        return {};
+    }
+
+    const SongPlayer::Core::LyricLine &line = m_lyrics[static_cast<std::size_t>(index.row())];
+    switch (static_cast<Role>(role)) {
+    case LyricTextRole:
+        return toQString(line.text);
+    case LyricTimestampRole:
+        return QVariant::fromValue<qint64>(line.timestampMs);
+    case LyricIsCurrentRole:
+        return index.row() == m_currentLineIndex;
+    }
+
+    return {};
+}
+
+QHash<int, QByteArray> LyricsModel::roleNames() const
+{
+    QHash<int, QByteArray> result;
+
+    result[LyricTextRole] = "lyricText";
+    result[LyricTimestampRole] = "lyricTimestamp";
+    result[LyricIsCurrentRole] = "isCurrent";
+
+    return result;
+}
+
 void LyricsModel::setShowLyrics(bool show)
 {
     if (m_showLyrics != show) {
@@ -30,7 +68,12 @@ void LyricsModel::setShowLyrics(bool show)
 
 void LyricsModel::setLyrics(std::vector<SongPlayer::Core::LyricLine> lyrics)
 {
+    // Swapping the whole lyric is the one place that rebuilds every delegate.
+    const int previousIndex = m_currentLineIndex;
+    beginResetModel();
     m_lyrics = std::move(lyrics);
+    m_currentLineIndex = -1;
+    endResetModel();
 
     bool hasLyrics = !m_lyrics.empty();
     if (m_hasLyrics != hasLyrics) {
@@ -38,10 +81,7 @@ void LyricsModel::setLyrics(std::vector<SongPlayer::Core::LyricLine> lyrics)
         emit hasLyricsChanged();
     }
 
-    updateAllLyrics();
-
-    if (m_currentLineIndex != -1) {
-        m_currentLineIndex = -1;
+    if (previousIndex != -1) {
         emit currentLineIndexChanged();
     }
 
@@ -49,8 +89,6 @@ void LyricsModel::setLyrics(std::vector<SongPlayer::Core::LyricLine> lyrics)
         m_currentLyric.clear();
         emit currentLyricChanged();
     }
-
-    // Lyrics data updated - no debug output in production
 }
 
 void LyricsModel::updatePosition(qint64 position)
@@ -61,9 +99,13 @@ void LyricsModel::updatePosition(qint64 position)
 
     int newIndex = findLyricIndexByPosition(position);
 
-    // Update current line index
+    // Update current line index. Only the rows losing and gaining the highlight
+    // are refreshed, so a line change costs two delegate updates regardless of length.
     if (m_currentLineIndex != newIndex) {
+        const int previousIndex = m_currentLineIndex;
         m_currentLineIndex = newIndex;
+        notifyCurrentRowChanged(previousIndex);
+        notifyCurrentRowChanged(newIndex);
         emit currentLineIndexChanged();
 
         // Update current lyric text
@@ -81,27 +123,10 @@ void LyricsModel::updatePosition(qint64 position)
 
 void LyricsModel::clearLyrics()
 {
-    m_lyrics.clear();
-    m_allLyrics.clear();
-
-    if (m_hasLyrics) {
-        m_hasLyrics = false;
-        emit hasLyricsChanged();
-    }
-
-    if (m_currentLineIndex != -1) {
-        m_currentLineIndex = -1;
-        emit currentLineIndexChanged();
-    }
-
-    if (!m_currentLyric.isEmpty()) {
-        m_currentLyric.clear();
-        emit currentLyricChanged();
+    if (m_lyrics.empty() && m_currentLineIndex == -1) {
+        return;
     }
-
-    emit allLyricsChanged();
-
-    // Lyrics data cleared - no debug output in production
+    setLyrics({});
 }
 
 void LyricsModel::toggleDisplayMode()
@@ -110,15 +135,13 @@ void LyricsModel::toggleDisplayMode()
     // Toggle display mode called - no debug output in production
 }
 
-void LyricsModel::updateAllLyrics()
+void LyricsModel::notifyCurrentRowChanged(int row)
 {
-    m_allLyrics.clear();
-
-    for (const auto& lyricLine : m_lyrics) {
-        m_allLyrics.append(toQString(lyricLine.text));
+    if (row < 0 || row >= rowCount()) {
+        return;
     }
-
-    emit allLyricsChanged();
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {LyricIsCurrentRole});
 }
 
 int LyricsModel::findLyricIndexByPosition(qint64 position)
@@ -3,7 +3,10 @@
 
 #include <algorithm>
 #include <limits>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 using std::in_range;
 using std::min;
@@ -11,6 +14,10 @@ using std::numeric_limits;
 using std::nullopt;
 using std::optional;
 using std::size_t;
+using std::span;
+using std::string_view;
+using std::unordered_set;
+using std::vector;
 
 namespace {
 
@@ -75,6 +82,16 @@ QVariant PlaylistModel::data(const QModelIndex &index, int role) const
             return audioInfo->imageSource();
         case AudioVideoSourceRole:
             return audioInfo->videoSource();
+        case AudioListImageSourceRole:
+            return audioInfo->listImageSource();
+        case AudioDurationRole:
+            return audioInfo->durationMs();
+        case AudioBitrateRole:
+            return audioInfo->bitrateKbps();
+        case AudioSampleRateRole:
+            return audioInfo->sampleRateHz();
+        case AudioChannelsRole:
+            return audioInfo->channels();
         }
     }
 
@@ -90,6 +107,11 @@ QHash<int, QByteArray> PlaylistModel::roleNames() const
     result[AudioSourceRole] = "audioSource";
     result[AudioImageSourceRole] = "audioImageSource";
     result[AudioVideoSourceRole] = "audioVideoSource";
+    result[AudioListImageSourceRole] = "audioListImageSource";
+    result[AudioDurationRole] = "audioDurationMs";
+    result[AudioBitrateRole] = "audioBitrateKbps";
+    result[AudioSampleRateRole] = "audioSampleRateHz";
+    result[AudioChannelsRole] = "audioChannels";
 
     return result;
 }
@@ -139,44 +161,81 @@ void PlaylistModel::setPlayMode(PlayMode newMode)
     emit playModeChanged();
 }
 
+qint64 PlaylistModel::totalDurationMs() const noexcept
+{
+    return m_playlist.totalDurationMs();
+}
+
 bool PlaylistModel::addAudio(const QString &title, const QString &authorName,
                              const QUrl &audioSource, const QUrl &imageSource,
                              const QUrl &videoSource)
 {
-    const SongPlayer::Core::AudioTrack track{SongPlayer::QtAdapter::makeCoreTrack(
-        title, authorName, audioSource, imageSource, videoSource)};
-    if (track.audioSource.empty() || m_playlist.containsSource(track.audioSource)) {
-        emit duplicateAudioSkipped(title, QStringLiteral("Audio file already exists in playlist"));
-        return false;
+    return addTrack(SongPlayer::QtAdapter::makeCoreTrack(
+        title, authorName, audioSource, imageSource, videoSource));
+}
+
+bool PlaylistModel::addTrack(const SongPlayer::Core::AudioTrack &track)
+{
+    return addTracks(span{&track, 1}) == 1;
+}
+
+int PlaylistModel::addTracks(span<const SongPlayer::Core::AudioTrack> tracks)
+{
+    // Duplicates, also within tracks, are dropped up front so the remaining rows can
+    // be announced with a single insertion.
+    vector<const SongPlayer::Core::AudioTrack *> accepted;
+    accepted.reserve(tracks.size());
+    unordered_set<string_view> acceptedSources;
+    for (const SongPlayer::Core::AudioTrack &track : tracks) {
+        if (track.audioSource.empty() || m_playlist.containsSource(track.audioSource)
+            || !acceptedSources.insert(track.audioSource).second) {
+            emit duplicateAudioSkipped(SongPlayer::QtAdapter::fromUtf8String(track.title),
+                                       QStringLiteral("Audio file already exists in playlist"));
+            continue;
+        }
+        if (static_cast<size_t>(m_audioList.size()) + accepted.size()
+            >= static_cast<size_t>(numeric_limits<int>::max())) {
+            qWarning() << "Playlist has reached the model row limit";
+            break;
+        }
+        accepted.push_back(&track);
     }
-    if (m_audioList.size() >= numeric_limits<int>::max()) {
-        qWarning() << "Playlist has reached the model row limit";
-        return false;
+    if (accepted.empty()) {
+        return 0;
     }
 
-    const int insertionIndex{static_cast<int>(m_audioList.size())};
-    beginInsertRows(QModelIndex{}, insertionIndex, insertionIndex);
-    const bool trackAdded{m_playlist.addTrack(track)};
-    Q_ASSERT(trackAdded);
-
-    auto *audioInfo{new AudioInfo{this}};
+    const int firstIndex{static_cast<int>(m_audioList.size())};
+    const int lastIndex{firstIndex + static_cast<int>(accepted.size()) - 1};
+    const bool shouldBecomeCurrent{m_audioList.isEmpty()};
+    bool durationAdded{false};
 
-    audioInfo->setTitle(title);
-    audioInfo->setAuthorName(authorName);
-    audioInfo->setAudioSource(audioSource);
-    audioInfo->setImageSource(imageSource);
-    audioInfo->setVideoSource(videoSource);
+    beginInsertRows(QModelIndex{}, firstIndex, lastIndex);
+    m_audioList.reserve(lastIndex + 1);
+    for (const SongPlayer::Core::AudioTrack *track : accepted) {
+        const bool trackAdded{m_playlist.addTrack(*track)};
+        Q_ASSERT(trackAdded);
 
-    const bool shouldBecomeCurrent{m_audioList.isEmpty()};
+        auto *audioInfo{new AudioInfo{this}};
 
-    m_audioList << audioInfo;
+        audioInfo->setTitle(SongPlayer::QtAdapter::fromUtf8String(track->title));
+        audioInfo->setAuthorName(SongPlayer::QtAdapter::fromUtf8String(track->authorName));
+        audioInfo->setAudioSource(QUrl{SongPlayer::QtAdapter::fromUtf8String(track->audioSource)});
+        audioInfo->setImageSource(QUrl{SongPlayer::QtAdapter::fromUtf8String(track->imageSource)});
+        audioInfo->setVideoSource(QUrl{SongPlayer::QtAdapter::fromUtf8String(track->videoSource)});
+        audioInfo->setAudioProperties(track->properties);
+        durationAdded = durationAdded || track->properties.durationMs != 0;
 
+        m_audioList << audioInfo;
+    }
     endInsertRows();
 
+    if (durationAdded) {
+        emit totalDurationChanged();
+    }
     if (shouldBecomeCurrent) {
-        setCurrentSong(audioInfo);
+        setCurrentSong(m_audioList.first());
     }
-    return true;
+    return static_cast<int>(accepted.size());
 }
 
 void PlaylistModel::removeAudio(int index)
@@ -192,6 +251,9 @@ void PlaylistModel::removeAudio(int index)
     m_playlist.removeTrack(static_cast<size_t>(index));
     toRemove->deleteLater();
     endRemoveRows();
+    if (toRemove->durationMs() != 0) {
+        emit totalDurationChanged();
+    }
 
     if (m_currentSong != newCurrentSong) {
         setCurrentSong(newCurrentSong);
@@ -200,6 +262,35 @@ void PlaylistModel::removeAudio(int index)
     syncCoreCurrentSong();
 }
 
+bool PlaylistModel::updateAudio(const QString &title, const QString &authorName,
+                                const QUrl &audioSource, const QUrl &imageSource,
+                                const SongPlayer::Core::AudioProperties &properties)
+{
+    const int index{indexOfAudio(audioSource)};
+    if (index < 0) {
+        return false;
+    }
+
+    AudioInfo *audioInfo{m_audioList[index]};
+    SongPlayer::Core::AudioTrack track{SongPlayer::QtAdapter::makeCoreTrack(
+        title, authorName, audioSource, imageSource, audioInfo->videoSource())};
+    track.properties = properties;
+    const bool trackReplaced{m_playlist.replaceTrack(static_cast<size_t>(index), std::move(track))};
+    Q_ASSERT(trackReplaced);
+
+    const bool durationChanged{audioInfo->durationMs() != properties.durationMs};
+    audioInfo->setTitle(title);
+    audioInfo->setAuthorName(authorName);
+    audioInfo->setImageSource(imageSource);
+    audioInfo->setAudioProperties(properties);
+    const QModelIndex changed{createIndex(index, 0)};
+    emit dataChanged(changed, changed);
+    if (durationChanged) {
+        emit totalDurationChanged();
+    }
+    return true;
+}
+
 void PlaylistModel::clearPlaylist()
 {
     if (!m_audioList.isEmpty()) {
@@ -213,6 +304,7 @@ void PlaylistModel::clearPlaylist()
         m_audioList.clear();
 
         endRemoveRows();
+        emit totalDurationChanged();
     }
 }
 
@@ -229,6 +321,12 @@ bool PlaylistModel::isDuplicateAudio(const QUrl& audioSource) const
     return m_playlist.containsSource(SongPlayer::QtAdapter::toSourceKey(audioSource));
 }
 
+int PlaylistModel::indexOfAudio(const QUrl& audioSource) const
+{
+    const optional<size_t> index{m_playlist.indexOfSource(SongPlayer::QtAdapter::toSourceKey(audioSource))};
+    return index && in_range<int>(*index) ? static_cast<int>(*index) : -1;
+}
+
 optional<size_t> PlaylistModel::nextSongIndex(optional<size_t> shuffleIndex) const noexcept
 {
     return m_playlist.nextIndex(shuffleIndex);
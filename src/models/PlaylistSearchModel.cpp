@@ -2,6 +2,10 @@
 #include "adapters/QtAudioTrackAdapter.h"
 #include "core/Playlist.h"
 
+#include <QHash>
+#include <QUrl>
+#include <QVariantMap>
+
 #include <limits>
 #include <utility>
 #include <vector>
@@ -56,6 +60,10 @@ QVariant PlaylistSearchModel::data(const QModelIndex &index, int role) const
         return audioInfo->audioSource();
     case OriginalIndexRole:
         return result.originalIndex;
+    case MatchTimestampRole:
+        return result.matchTimestampMs;
+    case MatchedLyricRole:
+        return result.matchedLyric;
     }
 
     return {};
@@ -69,6 +77,8 @@ QHash<int, QByteArray> PlaylistSearchModel::roleNames() const
     names[AudioImageSourceRole] = "audioImageSource";
     names[AudioSourceRole] = "audioSource";
     names[OriginalIndexRole] = "originalIndex";
+    names[MatchTimestampRole] = "matchTimestamp";
+    names[MatchedLyricRole] = "matchedLyric";
     return names;
 }
 
@@ -86,6 +96,20 @@ void PlaylistSearchModel::setIsSearching(bool newIsSearching)
     emit isSearchingChanged();
 }
 
+PlaylistSearchModel::SearchScope PlaylistSearchModel::searchScope() const
+{
+    return m_searchScope;
+}
+
+void PlaylistSearchModel::setSearchScope(SearchScope newSearchScope)
+{
+    if (m_searchScope == newSearchScope)
+        return;
+
+    m_searchScope = newSearchScope;
+    emit searchScopeChanged();
+}
+
 void PlaylistSearchModel::performSearch(const QVariantList &audioInfoList, const QString &searchText)
 {
     if (audioInfoList.isEmpty() || searchText.isEmpty()) {
@@ -153,6 +177,48 @@ void PlaylistSearchModel::performSearch(const QVariantList &audioInfoList, const
     setIsSearching(false);
 }
 
+void PlaylistSearchModel::performLyricsSearch(const QVariantList &audioInfoList, const QVariantList &lyricMatches)
+{
+    if (audioInfoList.isEmpty() || lyricMatches.isEmpty()) {
+        clearSearch();
+        return;
+    }
+
+    setIsSearching(true);
+
+    // The index covers the whole library; map each hit back to its playlist row.
+    QHash<QUrl, SearchResult> playlistRows{};
+    playlistRows.reserve(audioInfoList.size());
+    for (int i = 0; i < audioInfoList.size(); ++i) {
+        QObject *obj{qvariant_cast<QObject *>(audioInfoList[i])};
+        if (!obj || !obj->inherits(AudioInfo::staticMetaObject.className())) {
+            continue;
+        }
+        auto *audioInfo{static_cast<AudioInfo *>(obj)};
+        playlistRows.insert(audioInfo->audioSource(), SearchResult{audioInfo, i});
+    }
+
+    beginResetModel();
+    m_searchResults.clear();
+
+    for (const QVariant &match : lyricMatches) {
+        const QVariantMap fields{match.toMap()};
+        const auto row{playlistRows.constFind(fields.value(QStringLiteral("audioSource")).toUrl())};
+        if (row == playlistRows.cend()) {
+            continue;
+        }
+
+        m_searchResults.append(SearchResult{
+            row->audioInfo,
+            row->originalIndex,
+            fields.value(QStringLiteral("timestampMs")).toLongLong(),
+            fields.value(QStringLiteral("lyricText")).toString()});
+    }
+
+    endResetModel();
+    setIsSearching(false);
+}
+
 void PlaylistSearchModel::clearSearch()
 {
     m_currentSearchText.clear();
@@ -1,28 +1,50 @@
 #include "services/AudioImporter.h"
 
 #include "adapters/QtAudioTrackAdapter.h"
+#include "core/AudioFileEnumerator.h"
+#include "core/CoverCache.h"
+#include "core/DeviceScheduler.h"
+#include "core/FileFingerprint.h"
+#include "core/ReorderBuffer.h"
+#include "infrastructure/FileFingerprintReader.h"
+#include "infrastructure/StorageDeviceProbe.h"
 #include "infrastructure/TagLibAudioMetadataReader.h"
+#include "services/CoverThumbnails.h"
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QPair>
 #include <QPromise>
-#include <QStandardPaths>
 #include <QThread>
 #include <QThreadPool>
-#include <QtConcurrentRun>
+#include <QTimer>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <utility>
 #include <vector>
 
+using std::condition_variable;
 using std::in_range;
+using std::lock_guard;
 using std::make_shared;
 using std::make_unique;
+using std::map;
+using std::mutex;
+using std::optional;
 using std::set;
 using std::shared_ptr;
 using std::size_t;
-using std::string;
+using std::unique_lock;
 using std::vector;
 namespace fs = std::filesystem;
 
@@ -30,19 +52,265 @@ namespace SongPlayer {
 namespace {
 
 constexpr auto kDefaultIconUrl{"qrc:/qt/qml/MySongPlayer/assets/icons/app_icon.png"};
+// Read-ahead per worker: how far workers may run past the oldest unfinished file
+// before they wait for it, which bounds the reorder buffer.
+constexpr size_t kReorderWindowPerWorker{8};
+constexpr int kDefaultMaxImportWorkerCount{4};
+
+// How often a folder import publishes the number of files discovered so far.
+constexpr size_t kDiscoveryReportInterval{128};
+// Progress range minimum marking a total that is still growing (see ImportBatch).
+constexpr int kGrowingTotalMinimum{-1};
+
+// Yields the audio files of a batch one at a time; called by the feeding task only.
+using AudioFileSource = std::function<optional<fs::path>()>;
+// Builds the rescan of a folder walk; called by the feeding task only, since reading
+// the recorded fingerprints may query the database.
+using LibraryRescanSource = std::function<optional<Core::LibraryRescan>()>;
+// Files the batches of the current queue run have taken on; a canceled batch gives back
+// the ones it never delivered. Batches run one at a time, so the set is used by the
+// feeding task of the running batch, and by the GUI thread only between batches.
+using ClaimedFiles = set<fs::path>;
+
+// Worker-side state of one batch. A feeding task turns the file source into requests
+// and assigns each to its storage device; readers claim requests in selection order
+// within per-device concurrency limits, read them in parallel and hand results back
+// through a reorder buffer, so the future still reports them in selection order.
+// While the feeding task of a folder import is still discovering files, the progress
+// range is (kGrowingTotalMinimum, discovered) instead of (0, total). A rescan skips
+// files whose fingerprint is unchanged, and every batch skips files an earlier batch of
+// the queue run claimed, so the total only counts files to be read.
+struct ImportBatch {
+    ImportBatch(shared_ptr<const Core::IAudioMetadataReader> metadataReader,
+                AudioFileSource fileSource,
+                LibraryRescanSource libraryRescanSource,
+                shared_ptr<ClaimedFiles> claimed,
+                fs::path coverCache,
+                optional<int> knownTotal,
+                int readerCount,
+                int solidStateWorkerCount)
+        : reader{std::move(metadataReader)}
+        , source{std::move(fileSource)}
+        , rescanSource{std::move(libraryRescanSource)}
+        , claimedFiles{std::move(claimed)}
+        , coverCacheDirectory{std::move(coverCache)}
+        , totalKnown{knownTotal.has_value()}
+        , workersPerSolidStateDevice{solidStateWorkerCount}
+        , activeWorkers{readerCount + 1}
+    {
+        promise.start();
+        promise.setProgressRange(totalKnown ? 0 : kGrowingTotalMinimum, knownTotal.value_or(0));
+    }
+
+    const shared_ptr<const Core::IAudioMetadataReader> reader;
+    const AudioFileSource source;
+    const LibraryRescanSource rescanSource;
+    // Used by the feeding task only.
+    optional<Core::LibraryRescan> rescan;
+    const shared_ptr<ClaimedFiles> claimedFiles;
+    const fs::path coverCacheDirectory;
+    const bool totalKnown;
+    const int workersPerSolidStateDevice;
+    QPromise<Core::AudioImportResult> promise;
+
+    mutex lock;
+    condition_variable workAvailable;
+    // Appended by the feeding task. Elements of a deque never move, so a reader may
+    // use a claimed request after releasing the lock.
+    std::deque<Core::AudioImportRequest> requests;
+    std::deque<optional<Core::FileFingerprint>> fingerprints;
+    Core::DeviceScheduler scheduler;
+    bool feeding{true};
+    Core::ReorderBuffer<Core::AudioImportResult> reorder;
+    int activeWorkers;
+    // Recorded files a completed rescan walk did not find.
+    vector<fs::path> missingFiles;
+};
+
+void finishWorker(ImportBatch& batch)
+{
+    if (--batch.activeWorkers == 0) {
+        batch.promise.finish();
+    }
+}
+
+void feedImportBatch(ImportBatch& batch)
+{
+    // Probing stats every source directory, so it stays off the GUI thread.
+    Infrastructure::StorageDeviceProbe probe;
+    map<std::uint64_t, size_t> deviceIndexes;
+    size_t discovered{0};
+    bool walkComplete{false};
+    if (batch.rescanSource && !batch.promise.isCanceled()) {
+        batch.rescan = batch.rescanSource();
+    }
+    while (!batch.promise.isCanceled()) {
+        optional<fs::path> file{batch.source()};
+        if (!file) {
+            walkComplete = true;
+            break;
+        }
+        // One stat per file; an unchanged file is never opened.
+        optional<Core::FileFingerprint> fingerprint{Infrastructure::readFileFingerprint(*file)};
+        if (batch.rescan && !batch.rescan->needsRead(*file, fingerprint)) {
+            continue;
+        }
+        // Already read by an earlier batch of this queue run. Checked after the rescan
+        // so the rescan still counts the file as present.
+        if (!batch.claimedFiles->insert(*file).second) {
+            continue;
+        }
+        const Infrastructure::StorageDevice device{probe.deviceFor(*file)};
+        {
+            lock_guard guard{batch.lock};
+            const auto [known, inserted] = deviceIndexes.try_emplace(device.id, 0);
+            if (inserted) {
+                known->second = batch.scheduler.addDevice(
+                    device.sequentialOnly ? 1 : batch.workersPerSolidStateDevice);
+            }
+            batch.requests.push_back(Core::AudioImportRequest{
+                .audioFile = std::move(*file),
+                .coverCacheDirectory = batch.coverCacheDirectory,
+            });
+            batch.fingerprints.push_back(std::move(fingerprint));
+            batch.scheduler.append(known->second);
+        }
+        batch.workAvailable.notify_all();
+
+        ++discovered;
+        if (!batch.totalKnown && discovered % kDiscoveryReportInterval == 0 && in_range<int>(discovered)) {
+            batch.promise.setProgressRange(kGrowingTotalMinimum, static_cast<int>(discovered));
+        }
+    }
+
+    vector<fs::path> missingFiles;
+    if (walkComplete && batch.rescan) {
+        missingFiles = batch.rescan->missingFiles();
+    }
+
+    lock_guard guard{batch.lock};
+    batch.missingFiles = std::move(missingFiles);
+    batch.feeding = false;
+    if (!batch.totalKnown) {
+        batch.promise.setProgressRange(0, static_cast<int>(std::min(discovered, static_cast<size_t>(std::numeric_limits<int>::max()))));
+    }
+    batch.workAvailable.notify_all();
+    finishWorker(batch);
+}
+
+void runImportWorker(ImportBatch& batch, int readerIndex)
+{
+    unique_lock guard{batch.lock};
+    while (true) {
+        // Readers beyond what the devices found so far may run at once wait until more
+        // devices turn up, and leave once discovery is over.
+        if (readerIndex >= batch.scheduler.usefulConcurrency()) {
+            if (!batch.feeding || batch.promise.isCanceled()) {
+                break;
+            }
+            batch.workAvailable.wait(guard);
+            continue;
+        }
+
+        guard.unlock();
+        batch.promise.suspendIfRequested();
+        guard.lock();
+        if (batch.promise.isCanceled()) {
+            break;
+        }
+
+        const size_t window{kReorderWindowPerWorker * static_cast<size_t>(batch.scheduler.usefulConcurrency())};
+        const optional<size_t> index{batch.scheduler.claim(batch.reorder.nextIndex() + window)};
+        if (!index) {
+            if (batch.scheduler.exhausted() && !batch.feeding) {
+                break;
+            }
+            // Nothing is claimable only while another read is running (a busy device
+            // or the oldest undelivered request) or before the next file is found, and
+            // both wake us.
+            batch.workAvailable.wait(guard);
+            continue;
+        }
+
+        const Core::AudioImportRequest& request{batch.requests[*index]};
+        optional<Core::FileFingerprint> fingerprint{batch.fingerprints[*index]};
+        guard.unlock();
+        Core::AudioImportResult result{batch.reader->read(request)};
+        if (result) {
+            result->fingerprint = std::move(fingerprint);
+            if (result->coverFile) {
+                // A cover shared with tracks imported earlier is in use again.
+                Core::markCoverUsed(*result->coverFile);
+                CoverThumbnails::ensureForCover(*result->coverFile);
+            }
+        }
+        guard.lock();
+
+        batch.scheduler.release(*index);
+        for (Core::AudioImportResult& ready : batch.reorder.push(*index, std::move(result))) {
+            batch.promise.addResult(std::move(ready));
+        }
+        batch.promise.setProgressValue(static_cast<int>(batch.reorder.nextIndex()));
+        batch.workAvailable.notify_all();
+    }
+
+    finishWorker(batch);
+}
+
+int defaultImportWorkerCount()
+{
+    // Beyond a few readers the import is bound by the disk rather than by TagLib.
+    return std::clamp(QThread::idealThreadCount(), 1, kDefaultMaxImportWorkerCount);
+}
+
+// The fingerprints every source recorded alike; a file any of them would read is read.
+Core::FileFingerprints agreedFingerprints(const vector<AudioImporter::RecordedFingerprints>& sources)
+{
+    if (sources.empty()) {
+        return {};
+    }
+    Core::FileFingerprints agreed{sources.front()()};
+    for (size_t index{1}; index < sources.size() && !agreed.empty(); ++index) {
+        const Core::FileFingerprints other{sources[index]()};
+        std::erase_if(agreed, [&other](const Core::FileFingerprints::value_type& entry) {
+            const auto match{other.find(entry.first)};
+            return match == other.end() || match->second != entry.second;
+        });
+    }
+    return agreed;
+}
 
 } // namespace
 
+struct AudioImporter::QueuedBatch {
+    int id{0};
+    // A file selection, or a folder walk when directoryUrl is set.
+    QList<QUrl> fileUrls;
+    QUrl directoryUrl;
+    bool recursive{true};
+    // One source per request the folder walk stands for.
+    vector<RecordedFingerprints> recorded;
+};
+
 struct AudioImporter::ImportSession {
     QThreadPool pool;
     QFutureWatcher<Core::AudioImportResult> watcher;
+    // Kept for the files a rescan found missing, read once the batch has finished.
+    shared_ptr<ImportBatch> batch;
+    std::deque<QueuedBatch> queue;
+    // Cleared whenever the queue runs empty, so a later import reads the files again.
+    shared_ptr<ClaimedFiles> claimedFiles{make_shared<ClaimedFiles>()};
+    // Results [deliveredResults, readyResults) have arrived but not been delivered yet.
+    int deliveredResults{0};
+    int readyResults{0};
+    QTimer chunkTimer;
 
     ImportSession()
     {
-        // One background reader preserves selection order and avoids saturating the disk.
-        pool.setMaxThreadCount(1);
         pool.setObjectName(QStringLiteral("audio-import-pool"));
         watcher.setPendingResultsLimit(32);
+        chunkTimer.setSingleShot(true);
+        chunkTimer.setInterval(kChunkInterval);
     }
 };
 
@@ -57,13 +325,18 @@ AudioImporter::AudioImporter(
     : QObject(parent)
     , m_metadataReader{std::move(metadataReader)}
     , m_session{make_unique<ImportSession>()}
+    , m_importWorkerCount{defaultImportWorkerCount()}
 {
     Q_ASSERT(m_metadataReader);
 
-    connect(&m_session->watcher, &QFutureWatcherBase::resultReadyAt,
-            this, &AudioImporter::handleResult);
+    connect(&m_session->watcher, &QFutureWatcherBase::resultsReadyAt,
+            this, &AudioImporter::handleResultsReady);
+    connect(&m_session->chunkTimer, &QTimer::timeout,
+            this, &AudioImporter::deliverPendingResults);
     connect(&m_session->watcher, &QFutureWatcherBase::finished,
             this, &AudioImporter::handleFinished);
+    connect(&m_session->watcher, &QFutureWatcherBase::progressRangeChanged,
+            this, &AudioImporter::handleProgressRange);
 }
 
 AudioImporter::~AudioImporter()
@@ -90,119 +363,321 @@ int AudioImporter::importTotal() const noexcept
     return m_importTotal;
 }
 
-void AudioImporter::importLocalAudio(const QList<QUrl>& fileUrls)
+bool AudioImporter::importTotalKnown() const noexcept
+{
+    return m_importTotalKnown;
+}
+
+int AudioImporter::importBatchId() const noexcept
+{
+    return m_importBatchId;
+}
+
+int AudioImporter::queuedImportCount() const noexcept
+{
+    return static_cast<int>(m_session->queue.size());
+}
+
+int AudioImporter::importWorkerCount() const noexcept
+{
+    return m_importWorkerCount;
+}
+
+void AudioImporter::setImportWorkerCount(int workerCount)
 {
     Q_ASSERT(QThread::currentThread() == thread());
 
-    if (m_importing) {
-        emit importRejected(QStringLiteral("An audio import is already running"));
+    workerCount = std::clamp(workerCount, 1, kMaxImportWorkerCount);
+    if (m_importWorkerCount == workerCount) {
         return;
     }
+    m_importWorkerCount = workerCount;
+    emit importWorkerCountChanged();
+}
+
+int AudioImporter::importLocalAudio(const QList<QUrl>& fileUrls)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
 
     if (!in_range<int>(fileUrls.size())) {
         emit importRejected(QStringLiteral("The import batch is too large"));
-        return;
+        return 0;
     }
+    return enqueue(QueuedBatch{
+        .id = 0,
+        .fileUrls = fileUrls,
+        .directoryUrl = {},
+        .recursive = false,
+        .recorded = {},
+    });
+}
 
+int AudioImporter::importDirectory(const QUrl& directoryUrl, bool recursive)
+{
+    return rescanDirectory(directoryUrl, recursive, {});
+}
+
+int AudioImporter::rescanDirectory(const QUrl& directoryUrl, bool recursive, RecordedFingerprints recorded)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (!recorded) {
+        recorded = [] { return Core::FileFingerprints{}; };
+    }
+
+    // A queued walk of the same folder has not started yet, so it will see everything
+    // this one would. It keeps only the fingerprints both agree on and thereby reads
+    // every file either of them would have read.
+    const fs::path directory{QtAdapter::toLocalFilePath(directoryUrl).lexically_normal()};
+    for (QueuedBatch& queued : m_session->queue) {
+        if (queued.directoryUrl.isEmpty() || queued.recursive != recursive
+            || QtAdapter::toLocalFilePath(queued.directoryUrl).lexically_normal() != directory) {
+            continue;
+        }
+        queued.recorded.push_back(std::move(recorded));
+        return queued.id;
+    }
+
+    vector<RecordedFingerprints> sources;
+    sources.push_back(std::move(recorded));
+    return enqueue(QueuedBatch{
+        .id = 0,
+        .fileUrls = {},
+        .directoryUrl = directoryUrl,
+        .recursive = recursive,
+        .recorded = std::move(sources),
+    });
+}
+
+int AudioImporter::enqueue(QueuedBatch batch)
+{
+    batch.id = ++m_lastBatchId;
+    const int batchId{batch.id};
+    m_session->queue.push_back(std::move(batch));
+    if (!m_importing) {
+        m_importing = true;
+        emit importingChanged();
+    }
+    emit importQueueChanged();
+    startNextBatch();
+    return batchId;
+}
+
+void AudioImporter::startNextBatch()
+{
+    // A batch with nothing to read finishes right away, so keep going until one runs.
+    while (m_importBatchId == 0 && !m_session->queue.empty()) {
+        QueuedBatch next{std::move(m_session->queue.front())};
+        m_session->queue.pop_front();
+        m_importBatchId = next.id;
+        emit importQueueChanged();
+        if (next.directoryUrl.isEmpty()) {
+            startSelection(next.fileUrls);
+        } else {
+            startFolderWalk(next.directoryUrl, next.recursive, std::move(next.recorded));
+        }
+    }
+}
+
+void AudioImporter::startSelection(const QList<QUrl>& fileUrls)
+{
     set<fs::path> seenFiles;
     vector<fs::path> uniqueFiles;
     uniqueFiles.reserve(static_cast<size_t>(fileUrls.size()));
-    int invalidInputs{0};
+    // Reported once the batch has started, so they fall within it.
+    QList<QPair<QUrl, QString>> invalidInputs;
+    int alreadyImported{0};
     for (const QUrl& url : fileUrls) {
         fs::path file{QtAdapter::toLocalFilePath(url).lexically_normal()};
         if (file.empty()) {
-            ++invalidInputs;
-            emit importFailed(url, QStringLiteral("Only local audio files can be imported"));
+            invalidInputs.append({url, QStringLiteral("Only local audio files can be imported")});
             continue;
         }
         if (!seenFiles.insert(file).second) {
-            ++invalidInputs;
-            emit importFailed(url, QStringLiteral("The same file appears more than once in this import"));
+            invalidInputs.append({url, QStringLiteral("The same file appears more than once in this import")});
+            continue;
+        }
+        // An earlier batch of this queue run already read it; not counted at all.
+        if (m_session->claimedFiles->contains(file)) {
+            ++alreadyImported;
             continue;
         }
         uniqueFiles.push_back(std::move(file));
     }
 
-    vector<Core::AudioImportRequest> requests;
-    requests.reserve(uniqueFiles.size());
-    const fs::path cacheRoot{QtAdapter::toLocalFilePath(QUrl::fromLocalFile(
-        QStandardPaths::writableLocation(QStandardPaths::CacheLocation)))};
-    const fs::path coverCache{cacheRoot / string{Core::kCoverCacheDirectoryName}};
-    for (const fs::path& file : uniqueFiles) {
-        requests.push_back(Core::AudioImportRequest{
-            .audioFile = file,
-            .coverCacheDirectory = coverCache,
-        });
+    resetProgress(static_cast<int>(fileUrls.size()) - alreadyImported,
+                  static_cast<int>(invalidInputs.size()), true);
+    emit importStarted(m_importBatchId, m_importTotal);
+    for (const auto& [url, reason] : std::as_const(invalidInputs)) {
+        emit importFailed(url, reason);
     }
 
-    resetProgress(static_cast<int>(fileUrls.size()), invalidInputs);
-
-    if (requests.empty()) {
-        emit importStarted(m_importTotal);
-        emit importFinished(0, m_failedCount, false);
+    if (uniqueFiles.empty()) {
+        finishBatch(false);
         return;
     }
 
-    m_importing = true;
-    emit importingChanged();
-    emit importStarted(m_importTotal);
-
-    auto task{[reader = m_metadataReader,
-               requests = std::move(requests)](
-                    QPromise<Core::AudioImportResult>& promise) mutable {
-        promise.setProgressRange(0, static_cast<int>(requests.size()));
+    const auto total{static_cast<int>(uniqueFiles.size())};
+    // Devices are only known once the feeding task has probed them, so start enough
+    // readers for several drives; the surplus exits once discovery is over.
+    const int readerCount{std::min(total, kMaxImportWorkerCount)};
+    startBatch([files = std::move(uniqueFiles), next = size_t{0}]() mutable -> optional<fs::path> {
+        if (next == files.size()) {
+            return std::nullopt;
+        }
+        return std::move(files[next++]);
+    }, {}, total, readerCount);
+}
 
-        int completed{0};
-        for (const Core::AudioImportRequest& request : requests) {
-            promise.suspendIfRequested();
-            if (promise.isCanceled()) {
-                break;
-            }
+void AudioImporter::startFolderWalk(const QUrl& directoryUrl, bool recursive, vector<RecordedFingerprints> recorded)
+{
+    const fs::path directory{QtAdapter::toLocalFilePath(directoryUrl).lexically_normal()};
+    std::error_code error;
+    if (directory.empty() || !fs::is_directory(directory, error)) {
+        resetProgress(1, 1, true);
+        emit importStarted(m_importBatchId, m_importTotal);
+        emit importFailed(directoryUrl, QStringLiteral("Only existing local folders can be imported"));
+        finishBatch(false);
+        return;
+    }
 
-            promise.addResult(reader->read(request));
-            promise.setProgressValue(++completed);
-        }
-    }};
+    // The walk runs on the feeding task; the GUI thread only ever sees the count of
+    // files discovered so far.
+    resetProgress(0, 0, false);
+    emit importStarted(m_importBatchId, m_importTotal);
+    startBatch([enumerator = Core::AudioFileEnumerator{directory, recursive}]() mutable {
+        return enumerator.next();
+    }, [directory, recursive, recorded = std::move(recorded)]() -> optional<Core::LibraryRescan> {
+        return Core::LibraryRescan{directory, recursive, agreedFingerprints(recorded)};
+    }, std::nullopt, kMaxImportWorkerCount);
+}
 
-    QFuture<Core::AudioImportResult> future{
-        QtConcurrent::run(&m_session->pool, std::move(task))};
-    m_session->watcher.setFuture(future);
+void AudioImporter::startBatch(std::function<std::optional<std::filesystem::path>()> fileSource,
+                               std::function<std::optional<Core::LibraryRescan>()> rescanSource,
+                               std::optional<int> knownTotal,
+                               int readerCount)
+{
+    auto batch{make_shared<ImportBatch>(
+        m_metadataReader, std::move(fileSource), std::move(rescanSource), m_session->claimedFiles,
+        CoverThumbnails::coverCacheDirectory(), knownTotal, readerCount, m_importWorkerCount)};
+    m_session->batch = batch;
+    m_session->deliveredResults = 0;
+    m_session->readyResults = 0;
+    m_session->watcher.setFuture(batch->promise.future());
+
+    m_session->pool.setMaxThreadCount(readerCount + 1);
+    m_session->pool.start([batch] { feedImportBatch(*batch); });
+    for (int reader{0}; reader < readerCount; ++reader) {
+        m_session->pool.start([batch, reader] { runImportWorker(*batch, reader); });
+    }
 }
 
 void AudioImporter::cancelImport()
 {
     Q_ASSERT(QThread::currentThread() == thread());
-    if (m_importing) {
+
+    const std::deque<QueuedBatch> dropped{std::exchange(m_session->queue, {})};
+    if (!dropped.empty()) {
+        emit importQueueChanged();
+        settleIfDrained();
+    }
+    for (const QueuedBatch& batch : dropped) {
+        emit importFinished(batch.id, 0, 0, true);
+    }
+    if (m_importBatchId != 0) {
+        cancelImportBatch(m_importBatchId);
+    }
+}
+
+void AudioImporter::cancelImportBatch(int batchId)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (batchId != 0 && batchId == m_importBatchId) {
+        // Results that reached the GUI thread before the cancel are kept.
+        deliverPendingResults();
         m_session->watcher.future().cancel();
+        return;
+    }
+
+    const auto queued{std::ranges::find(m_session->queue, batchId, &QueuedBatch::id)};
+    if (queued == m_session->queue.end()) {
+        return;
     }
+    m_session->queue.erase(queued);
+    emit importQueueChanged();
+    settleIfDrained();
+    emit importFinished(batchId, 0, 0, true);
 }
 
-void AudioImporter::handleResult(int resultIndex)
+void AudioImporter::handleResultsReady(int beginIndex, int endIndex)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    Q_UNUSED(beginIndex);
+
+    // Results are reported in selection order, so the ready ones always form a prefix.
+    m_session->readyResults = std::max(m_session->readyResults, endIndex);
+    if (static_cast<size_t>(m_session->readyResults - m_session->deliveredResults) >= kMaxChunkSize) {
+        deliverPendingResults();
+    } else if (!m_session->chunkTimer.isActive()) {
+        m_session->chunkTimer.start();
+    }
+}
+
+void AudioImporter::deliverPendingResults()
 {
     Q_ASSERT(QThread::currentThread() == thread());
 
-    const Core::AudioImportResult result{
-        m_session->watcher.future().resultAt(resultIndex)};
-    ++m_importCompleted;
-
-    if (result) {
-        ++m_importedCount;
-        const Core::ImportedAudio& imported{*result};
-        const QUrl coverUrl{imported.coverFile
-            ? QtAdapter::fromLocalFilePath(*imported.coverFile)
-            : QUrl{QString::fromLatin1(kDefaultIconUrl)}};
-        emit audioImported(
-            QtAdapter::fromUtf8String(imported.title),
-            QtAdapter::fromUtf8String(imported.artist),
-            QtAdapter::fromLocalFilePath(imported.audioFile),
-            coverUrl);
-    } else {
-        ++m_failedCount;
-        emit importFailed(
-            QtAdapter::fromLocalFilePath(result.error().audioFile),
-            QtAdapter::fromUtf8String(result.error().message));
+    m_session->chunkTimer.stop();
+    const QFuture<Core::AudioImportResult> future{m_session->watcher.future()};
+    while (m_session->deliveredResults < m_session->readyResults) {
+        const int chunkEnd{std::min(m_session->readyResults,
+                                    m_session->deliveredResults + static_cast<int>(kMaxChunkSize))};
+        QList<ImportedTrack> tracks;
+        tracks.reserve(chunkEnd - m_session->deliveredResults);
+        for (; m_session->deliveredResults < chunkEnd; ++m_session->deliveredResults) {
+            const Core::AudioImportResult result{future.resultAt(m_session->deliveredResults)};
+            ++m_importCompleted;
+            if (!result) {
+                ++m_failedCount;
+                emit importFailed(
+                    QtAdapter::fromLocalFilePath(result.error().audioFile),
+                    QtAdapter::fromUtf8String(result.error().message));
+                continue;
+            }
+
+            ++m_importedCount;
+            const Core::ImportedAudio& imported{*result};
+            tracks.append(ImportedTrack{
+                .title = QtAdapter::fromUtf8String(imported.title),
+                .authorName = QtAdapter::fromUtf8String(imported.artist),
+                .audioSource = QtAdapter::fromLocalFilePath(imported.audioFile),
+                .imageSource = imported.coverFile
+                    ? QtAdapter::fromLocalFilePath(*imported.coverFile)
+                    : QUrl{QString::fromLatin1(kDefaultIconUrl)},
+                .embeddedLyrics = QtAdapter::fromUtf8String(imported.embeddedLyrics),
+                .properties = imported.properties,
+                .fingerprint = imported.fingerprint,
+            });
+        }
+
+        if (!tracks.isEmpty()) {
+            emit audioImported(tracks);
+        }
+        emit importProgressChanged();
     }
+}
 
+void AudioImporter::handleProgressRange(int minimum, int maximum)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (m_importTotalKnown) {
+        return;
+    }
+    // Only folder imports publish a growing total, and they start without failures.
+    m_importTotal = maximum;
+    m_importTotalKnown = minimum != kGrowingTotalMinimum;
     emit importProgressChanged();
 }
 
@@ -210,18 +685,58 @@ void AudioImporter::handleFinished()
 {
     Q_ASSERT(QThread::currentThread() == thread());
 
+    deliverPendingResults();
     const bool canceled{m_session->watcher.future().isCanceled()};
-    if (m_importing) {
-        m_importing = false;
-        emit importingChanged();
+    // The feeding task recorded the missing files before the batch finished.
+    const shared_ptr<ImportBatch> batch{std::exchange(m_session->batch, {})};
+    if (batch && canceled) {
+        // Results arrive in request order, so every request from the first undelivered
+        // result on was never imported; the batches after this one may read them. The
+        // future may hold more results than that, but the watcher drops the ones it had
+        // not announced before the cancel.
+        const auto delivered{static_cast<size_t>(m_session->deliveredResults)};
+        lock_guard guard{batch->lock};
+        for (size_t index{delivered}; index < batch->requests.size(); ++index) {
+            m_session->claimedFiles->erase(batch->requests[index].audioFile);
+        }
+    }
+    if (batch) {
+        for (const fs::path& missingFile : batch->missingFiles) {
+            emit audioRemoved(QtAdapter::fromLocalFilePath(missingFile));
+        }
     }
-    emit importFinished(m_importedCount, m_failedCount, canceled);
+    finishBatch(canceled);
+    startNextBatch();
+}
+
+void AudioImporter::finishBatch(bool canceled)
+{
+    const int batchId{std::exchange(m_importBatchId, 0)};
+    if (!m_importTotalKnown) {
+        m_importTotalKnown = true;
+        emit importProgressChanged();
+    }
+    emit importQueueChanged();
+    // Before the summary, so the last importFinished of a queue run sees the importer idle.
+    settleIfDrained();
+    emit importFinished(batchId, m_importedCount, m_failedCount, canceled);
+}
+
+void AudioImporter::settleIfDrained()
+{
+    if (!m_importing || m_importBatchId != 0 || !m_session->queue.empty()) {
+        return;
+    }
+    m_session->claimedFiles->clear();
+    m_importing = false;
+    emit importingChanged();
 }
 
-void AudioImporter::resetProgress(int total, int initialFailures)
+void AudioImporter::resetProgress(int total, int initialFailures, bool totalKnown)
 {
     m_importCompleted = initialFailures;
     m_importTotal = total;
+    m_importTotalKnown = totalKnown;
     m_importedCount = 0;
     m_failedCount = initialFailures;
     emit importProgressChanged();
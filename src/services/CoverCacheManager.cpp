@@ -0,0 +1,154 @@
+#include "services/CoverCacheManager.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+#include "core/CoverCache.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <set>
+#include <string>
+#include <utility>
+
+using std::set;
+using std::string;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer {
+
+CoverCacheManager::CoverCacheManager(fs::path coverCacheDirectory, QObject* parent)
+    : QObject{parent}
+    , m_directory{std::move(coverCacheDirectory)}
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(kIdleDelay);
+    connect(&m_idleTimer, &QTimer::timeout, this, [this] {
+        if (!m_busy && !isCollecting()) {
+            emit collectionDue();
+        }
+    });
+}
+
+CoverCacheManager::~CoverCacheManager()
+{
+    m_idleTimer.stop();
+    if (m_stopCollection) {
+        m_stopCollection->store(true);
+    }
+    m_collection.waitForFinished();
+}
+
+std::uint64_t CoverCacheManager::maxBytes() const
+{
+    return m_maxBytes;
+}
+
+void CoverCacheManager::setMaxBytes(std::uint64_t maxBytes)
+{
+    if (m_maxBytes == maxBytes) {
+        return;
+    }
+    // A lower cap is enforced at the next idle moment rather than on the spot.
+    const bool lowered{maxBytes < m_maxBytes};
+    m_maxBytes = maxBytes;
+    if (lowered) {
+        scheduleCollection();
+    }
+}
+
+void CoverCacheManager::setIdleDelay(std::chrono::milliseconds delay)
+{
+    m_idleTimer.setInterval(delay);
+}
+
+void CoverCacheManager::setOrphanGracePeriod(std::chrono::milliseconds period)
+{
+    m_orphanGracePeriod = period;
+}
+
+void CoverCacheManager::setBusy(bool busy)
+{
+    if (m_busy == busy) {
+        return;
+    }
+    m_busy = busy;
+    if (busy) {
+        m_idleTimer.stop();
+        if (m_stopCollection) {
+            m_stopCollection->store(true);
+        }
+        return;
+    }
+    // Whatever ran meanwhile has grown the cache.
+    scheduleCollection();
+}
+
+void CoverCacheManager::scheduleCollection()
+{
+    if (!m_busy) {
+        m_idleTimer.start();
+    }
+}
+
+void CoverCacheManager::collect(const vector<QUrl>& referencedImages)
+{
+    if (isCollecting()) {
+        return;
+    }
+
+    set<string> referenced;
+    for (const QUrl& imageSource : referencedImages) {
+        if (!imageSource.isLocalFile()) {
+            continue;
+        }
+        const fs::path coverFile{QtAdapter::toLocalFilePath(imageSource)};
+        if (coverFile.parent_path() == m_directory) {
+            referenced.insert(Core::coverCacheEntryName(coverFile));
+        }
+    }
+
+    m_stopCollection = std::make_shared<std::atomic_bool>(false);
+    m_collection = QtConcurrent::run([directory = m_directory, referenced = std::move(referenced),
+                                      maxBytes = m_maxBytes, gracePeriod = m_orphanGracePeriod,
+                                      stop = m_stopCollection] {
+        Collection result;
+        try {
+            const std::int64_t cutoffNs{Core::coverCacheClockNs()
+                - std::chrono::duration_cast<std::chrono::nanoseconds>(gracePeriod).count()};
+            const vector<Core::CoverCacheEntry> doomed{Core::planCoverCacheCollection(
+                Core::scanCoverCache(directory), referenced, maxBytes, cutoffNs)};
+            for (const Core::CoverCacheEntry& entry : doomed) {
+                if (stop->load()) {
+                    break;
+                }
+                result.freedBytes += Core::removeCoverCacheEntry(entry);
+                ++result.removedCovers;
+            }
+        } catch (...) {
+            // An unreadable cache is left as it is; the next collection tries again.
+        }
+        return result;
+    });
+    m_collection.then(this, [this](Collection result) {
+        emit collected(result.removedCovers, static_cast<qint64>(result.freedBytes));
+    });
+}
+
+bool CoverCacheManager::isCollecting() const
+{
+    return m_collection.isRunning();
+}
+
+void CoverCacheManager::markUsed(const QUrl& imageSource)
+{
+    if (!imageSource.isLocalFile()) {
+        return;
+    }
+    fs::path coverFile{QtAdapter::toLocalFilePath(imageSource)};
+    if (coverFile.parent_path() != m_directory) {
+        return;
+    }
+    QtConcurrent::run([coverFile = std::move(coverFile)] { Core::markCoverUsed(coverFile); });
+}
+
+} // namespace SongPlayer
@@ -0,0 +1,387 @@
+#include "services/CoverThumbnailAtlas.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+#include "core/AudioImport.h"
+#include "core/ThumbnailAtlas.h"
+#include "services/CoverThumbnails.h"
+
+#include <QFile>
+#include <QImage>
+#include <QImageReader>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace SongPlayer {
+namespace {
+
+constexpr auto kRebuildDelay{std::chrono::seconds{2}};
+constexpr std::size_t kBytesPerPixel{4};
+
+QString toQtPath(const fs::path& path)
+{
+    return QtAdapter::fromLocalFilePath(path).toLocalFile();
+}
+
+} // namespace
+
+// Everything the rebuild task needs; shared with it so the provider never has to be
+// touched off its own thread.
+//
+// The atlas is a base file plus up to kMaxAtlasSegments - 1 delta files, each a
+// complete atlas of its own. A burst of misses appends a delta holding only the new
+// tiles; the segments are merged into a new base once there are too many of them or
+// some of their tiles have lost their thumbnail.
+struct CoverThumbnailAtlas::State {
+    struct Mapping {
+        QFile file;
+        std::optional<Core::ThumbnailAtlasView> view;
+    };
+    using Mappings = std::vector<std::shared_ptr<const Mapping>>;
+
+    static constexpr std::size_t kMaxAtlasSegments{8};
+
+    fs::path coverCacheDirectory;
+    std::mutex mutex;
+    // The base first, then the deltas in the order they were written.
+    Mappings mappings;
+    // Serializes rebuilds, which share one temporary file.
+    std::mutex buildMutex;
+    // Set once the mapped atlas could not be replaced; later rebuilds would only
+    // rewrite the pending atlas, so they wait for the next start.
+    bool swapBlocked{false};
+
+    fs::path atlasPath() const
+    {
+        return coverCacheDirectory / std::string{Core::kThumbnailAtlasFileName};
+    }
+
+    // "thumbnail-atlas.bin.<segment>" for segment 1 and up; the base is segment 0.
+    fs::path segmentPath(std::size_t segment) const
+    {
+        fs::path path{atlasPath()};
+        if (segment > 0) {
+            path += "." + std::to_string(segment);
+        }
+        return path;
+    }
+
+    // Where an atlas waits for the next start when the mapped one cannot be replaced
+    // (Windows refuses to rename over a mapped file).
+    fs::path pendingAtlasPath() const
+    {
+        fs::path path{atlasPath()};
+        path += ".next";
+        return path;
+    }
+
+    Mappings currentMappings()
+    {
+        const std::scoped_lock lock{mutex};
+        return mappings;
+    }
+
+    static std::shared_ptr<const Mapping> map(const fs::path& atlasFile)
+    {
+        auto mapped{std::make_shared<Mapping>()};
+        mapped->file.setFileName(toQtPath(atlasFile));
+        if (!mapped->file.open(QIODevice::ReadOnly) || mapped->file.size() <= 0) {
+            return {};
+        }
+        const uchar* data{mapped->file.map(0, mapped->file.size())};
+        if (data == nullptr) {
+            return {};
+        }
+        mapped->view = Core::ThumbnailAtlasView::open(
+            {reinterpret_cast<const char*>(data), static_cast<std::size_t>(mapped->file.size())});
+        if (!mapped->view) {
+            return {};
+        }
+        return mapped;
+    }
+
+    // The base and the deltas written after it, stopping at the first gap.
+    Mappings mapSegments() const
+    {
+        Mappings mapped;
+        for (std::size_t segment{0}; segment < kMaxAtlasSegments; ++segment) {
+            std::shared_ptr<const Mapping> mapping{map(segmentPath(segment))};
+            if (!mapping) {
+                break;
+            }
+            mapped.push_back(std::move(mapping));
+        }
+        return mapped;
+    }
+
+    void removeDeltas() const
+    {
+        std::error_code error;
+        for (std::size_t segment{1}; segment < kMaxAtlasSegments; ++segment) {
+            fs::remove(segmentPath(segment), error);
+        }
+    }
+
+    // Writes tiles to the shared temporary file and renames it to target.
+    bool write(const fs::path& target, std::span<const Core::ThumbnailTile> tiles, std::error_code& error)
+    {
+        fs::path temporary{atlasPath()};
+        temporary += ".tmp";
+        {
+            std::ofstream output{temporary, std::ios::binary | std::ios::trunc};
+            if (!Core::writeThumbnailAtlas(output, static_cast<std::uint32_t>(Core::kListThumbnailSize), tiles)
+                || !output.flush()) {
+                output.close();
+                fs::remove(temporary, error);
+                return false;
+            }
+        }
+        fs::rename(temporary, target, error);
+        if (!error) {
+            return true;
+        }
+        if (target == atlasPath()) {
+            // The mapped base cannot be replaced; the new one waits for the next start.
+            swapBlocked = true;
+            fs::rename(temporary, pendingAtlasPath(), error);
+        } else {
+            fs::remove(temporary, error);
+        }
+        return false;
+    }
+
+    // Runs on the thread pool: decodes every list thumbnail that no segment holds yet
+    // and appends them as a delta, or merges all segments into a new base.
+    void rebuild()
+    {
+        const std::scoped_lock buildLock{buildMutex};
+        if (swapBlocked) {
+            return;
+        }
+        const Mappings current{currentMappings()};
+        const auto packed = [&current](std::uint64_t key) {
+            return std::ranges::any_of(current, [key](const std::shared_ptr<const Mapping>& mapping) {
+                return mapping->view->find(key).has_value();
+            });
+        };
+
+        std::vector<Core::ThumbnailTile> tiles;
+        std::unordered_set<std::uint64_t> thumbnailKeys;
+
+        // "@64.jpg" or "@64.png": list thumbnails of JPEG covers and of all others.
+        const std::string jpegSuffix{Core::coverThumbnailFileName(".jpg", Core::kListThumbnailSize)};
+        const std::string pngSuffix{Core::coverThumbnailFileName(".png", Core::kListThumbnailSize)};
+        const std::size_t rowBytes{static_cast<std::size_t>(Core::kListThumbnailSize) * kBytesPerPixel};
+        std::deque<std::string> decodedPixels;
+
+        std::error_code error;
+        const fs::path thumbnailDirectory{coverCacheDirectory / std::string{Core::kCoverThumbnailDirectoryName}};
+        for (const fs::directory_entry& entry : fs::directory_iterator(thumbnailDirectory, error)) {
+            const std::string name{entry.path().filename().string()};
+            const std::size_t suffixSize{name.ends_with(jpegSuffix) ? jpegSuffix.size()
+                                         : name.ends_with(pngSuffix) ? pngSuffix.size()
+                                                                     : 0};
+            if (suffixSize == 0) {
+                continue;
+            }
+            const std::uint64_t key{Core::thumbnailAtlasKey(name.substr(0, name.size() - suffixSize))};
+            thumbnailKeys.insert(key);
+            if (packed(key)) {
+                continue;
+            }
+
+            QImage image{QImageReader{toQtPath(entry.path())}.read()};
+            if (image.isNull()) {
+                continue;
+            }
+            if (image.width() > Core::kListThumbnailSize || image.height() > Core::kListThumbnailSize) {
+                image = image.scaled(Core::kListThumbnailSize, Core::kListThumbnailSize,
+                                     Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+            image.convertTo(QImage::Format_ARGB32_Premultiplied);
+
+            const auto width{static_cast<std::size_t>(image.width())};
+            const auto height{static_cast<std::size_t>(image.height())};
+            std::string& pixels{decodedPixels.emplace_back(height * rowBytes, '\0')};
+            for (std::size_t row{0}; row < height; ++row) {
+                std::memcpy(pixels.data() + row * rowBytes, image.constScanLine(static_cast<int>(row)),
+                            width * kBytesPerPixel);
+            }
+            tiles.push_back(Core::ThumbnailTile{
+                .key = key,
+                .width = static_cast<std::uint32_t>(width),
+                .height = static_cast<std::uint32_t>(height),
+                .pixels = pixels,
+            });
+        }
+
+        // Tiles whose thumbnail file the cover cache collection removed.
+        std::size_t stale{0};
+        for (const std::shared_ptr<const Mapping>& mapping : current) {
+            for (std::size_t index{0}; index < mapping->view->tileCount(); ++index) {
+                stale += thumbnailKeys.contains(mapping->view->tileAt(index).key) ? 0 : 1;
+            }
+        }
+        if (tiles.empty() && stale == 0) {
+            return;
+        }
+
+        if (stale == 0 && !current.empty() && current.size() < kMaxAtlasSegments) {
+            const fs::path delta{segmentPath(current.size())};
+            if (!write(delta, tiles, error)) {
+                return;
+            }
+            std::shared_ptr<const Mapping> appended{map(delta)};
+            if (!appended) {
+                return;
+            }
+            const std::scoped_lock lock{mutex};
+            mappings.push_back(std::move(appended));
+            return;
+        }
+
+        // Old tiles are copied straight out of the current mappings.
+        for (const std::shared_ptr<const Mapping>& mapping : current) {
+            for (std::size_t index{0}; index < mapping->view->tileCount(); ++index) {
+                const Core::ThumbnailTile tile{mapping->view->tileAt(index)};
+                if (thumbnailKeys.contains(tile.key)) {
+                    tiles.push_back(tile);
+                }
+            }
+        }
+        if (!write(atlasPath(), tiles, error)) {
+            return;
+        }
+        removeDeltas();
+
+        std::shared_ptr<const Mapping> rebuilt{map(atlasPath())};
+        const std::scoped_lock lock{mutex};
+        mappings.clear();
+        if (rebuilt) {
+            mappings.push_back(std::move(rebuilt));
+        }
+    }
+};
+
+CoverThumbnailAtlas::CoverThumbnailAtlas(fs::path coverCacheDirectory)
+    : QQuickImageProvider{QQuickImageProvider::Image}
+    , m_state{std::make_shared<State>()}
+{
+    m_state->coverCacheDirectory = std::move(coverCacheDirectory);
+
+    std::error_code error;
+    if (fs::is_regular_file(m_state->pendingAtlasPath(), error)) {
+        // The pending base already holds every tile of the deltas beside it.
+        fs::rename(m_state->pendingAtlasPath(), m_state->atlasPath(), error);
+        if (!error) {
+            m_state->removeDeltas();
+        }
+    }
+    m_state->mappings = m_state->mapSegments();
+
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(kRebuildDelay);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, [this] {
+        if (m_rebuild.isRunning()) {
+            m_rebuildTimer.start();
+            return;
+        }
+        rebuild();
+    });
+    // Drops the tiles of covers collected from the cache since the atlas was written.
+    m_rebuildTimer.start();
+}
+
+CoverThumbnailAtlas::~CoverThumbnailAtlas()
+{
+    m_rebuildTimer.stop();
+    m_rebuild.waitForFinished();
+}
+
+QImage CoverThumbnailAtlas::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    Q_UNUSED(requestedSize)
+
+    const std::string coverFileName{QtAdapter::toUtf8String(id)};
+    if (coverFileName.empty() || fs::path{coverFileName}.filename().string() != coverFileName) {
+        return {};
+    }
+
+    const std::uint64_t key{Core::thumbnailAtlasKey(coverFileName)};
+    for (const std::shared_ptr<const State::Mapping>& mapping : m_state->currentMappings()) {
+        if (const auto tile{mapping->view->find(key)}) {
+            // The image points into the mapping and keeps it alive until QML drops it.
+            const QImage image{
+                reinterpret_cast<const uchar*>(tile->pixels.data()),
+                static_cast<int>(tile->width),
+                static_cast<int>(tile->height),
+                static_cast<qsizetype>(mapping->view->tileSize() * kBytesPerPixel),
+                QImage::Format_ARGB32_Premultiplied,
+                [](void* info) { delete static_cast<std::shared_ptr<const State::Mapping>*>(info); },
+                new std::shared_ptr<const State::Mapping>{mapping},
+            };
+            if (size != nullptr) {
+                *size = image.size();
+            }
+            return image;
+        }
+    }
+
+    // Not packed yet: decode the thumbnail file (writing it first for covers cached
+    // before thumbnails existed) and let the next rebuild pack it.
+    const fs::path coverFile{m_state->coverCacheDirectory / coverFileName};
+    const fs::path thumbnailFile{m_state->coverCacheDirectory / std::string{Core::kCoverThumbnailDirectoryName}
+                                 / Core::coverThumbnailFileName(coverFileName, Core::kListThumbnailSize)};
+    std::error_code error;
+    if (!fs::is_regular_file(thumbnailFile, error)) {
+        CoverThumbnails::ensureForCover(coverFile);
+    }
+    const QImage image{QImageReader{toQtPath(thumbnailFile)}.read()};
+    if (image.isNull()) {
+        return {};
+    }
+    if (!m_missReported.exchange(true)) {
+        QMetaObject::invokeMethod(this, &CoverThumbnailAtlas::scheduleRebuild, Qt::QueuedConnection);
+    }
+    if (size != nullptr) {
+        *size = image.size();
+    }
+    return image;
+}
+
+QFuture<void> CoverThumbnailAtlas::rebuild()
+{
+    m_rebuild = QtConcurrent::run([state = m_state] {
+        try {
+            state->rebuild();
+        } catch (...) {
+            // The atlas is an optimization; misses keep being served from files.
+        }
+    });
+    return m_rebuild;
+}
+
+void CoverThumbnailAtlas::scheduleRebuild()
+{
+    // Misses arrive in bursts while a freshly imported playlist scrolls into view;
+    // rebuilding once the burst is over keeps the atlas rewrite off the hot path.
+    m_missReported = false;
+    m_rebuildTimer.start();
+}
+
+} // namespace SongPlayer
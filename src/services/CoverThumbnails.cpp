@@ -0,0 +1,148 @@
+#include "services/CoverThumbnails.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+#include "core/AudioImport.h"
+
+#include <QImage>
+#include <QImageReader>
+#include <QSize>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace SongPlayer::CoverThumbnails {
+namespace {
+
+constexpr int kThumbnailSizes[]{Core::kDetailThumbnailSize, Core::kListThumbnailSize};
+constexpr int kJpegQuality{85};
+
+// Cached cover names are content hashes, so plain ASCII conversions are safe here.
+fs::path thumbnailPath(const fs::path& coverFile, int size)
+{
+    return coverFile.parent_path() / std::string{Core::kCoverThumbnailDirectoryName}
+        / Core::coverThumbnailFileName(coverFile.filename().string(), size);
+}
+
+// Only files directly inside this user's cover cache; any other directory that
+// happens to be named "covers" holds the user's own images.
+bool isCachedCover(const fs::path& file)
+{
+    return file.parent_path().lexically_normal() == coverCacheDirectory().lexically_normal();
+}
+
+bool saveAtomically(const QImage& image, const fs::path& target)
+{
+    // Another worker may be writing the same thumbnail; each writer uses its own
+    // temporary file and the last rename wins with identical content.
+    fs::path temporary{target};
+    temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+    // The thumbnail name chose the format: PNG keeps the alpha channel of covers that
+    // may have one.
+    const bool png{target.extension() == ".png"};
+    std::error_code error;
+    if (!image.save(QtAdapter::fromLocalFilePath(temporary).toLocalFile(), png ? "PNG" : "JPG",
+                    png ? -1 : kJpegQuality)) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    fs::rename(temporary, target, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+fs::path coverCacheDirectory()
+{
+    const fs::path cacheRoot{QtAdapter::toLocalFilePath(QUrl::fromLocalFile(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation)))};
+    return cacheRoot / std::string{Core::kCoverCacheDirectoryName};
+}
+
+void ensureForCover(const fs::path& coverFile) noexcept
+{
+    try {
+        std::vector<std::pair<int, fs::path>> missing;
+        std::error_code error;
+        for (const int size : kThumbnailSizes) {
+            fs::path target{thumbnailPath(coverFile, size)};
+            if (!fs::is_regular_file(target, error)) {
+                missing.emplace_back(size, std::move(target));
+            }
+        }
+        if (missing.empty()) {
+            return;
+        }
+        fs::create_directories(missing.front().second.parent_path(), error);
+        if (error) {
+            return;
+        }
+
+        // Decoding straight to the largest missing size lets JPEG use its cheap
+        // DCT-domain downscaling instead of materializing a 1500px image.
+        QImageReader reader{QtAdapter::fromLocalFilePath(coverFile).toLocalFile()};
+        reader.setAutoTransform(true);
+        const int largest{missing.front().first};
+        const QSize original{reader.size()};
+        if (original.isValid() && (original.width() > largest || original.height() > largest)) {
+            reader.setScaledSize(original.scaled(largest, largest, Qt::KeepAspectRatio));
+        }
+        const QImage decoded{reader.read()};
+        if (decoded.isNull()) {
+            return;
+        }
+
+        for (const auto& [size, target] : missing) {
+            const QImage thumbnail{decoded.width() > size || decoded.height() > size
+                ? decoded.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                : decoded};
+            saveAtomically(thumbnail, target);
+        }
+    } catch (...) {
+        // Thumbnails are an optimization; views fall back to the full cover.
+    }
+}
+
+QUrl thumbnailUrl(const QUrl& imageSource, int size)
+{
+    if (!imageSource.isLocalFile()) {
+        return imageSource;
+    }
+
+    const fs::path coverFile{QtAdapter::toLocalFilePath(imageSource)};
+    if (!isCachedCover(coverFile)) {
+        return imageSource;
+    }
+    return QtAdapter::fromLocalFilePath(thumbnailPath(coverFile, size));
+}
+
+QUrl atlasUrl(const QUrl& imageSource)
+{
+    if (!imageSource.isLocalFile()) {
+        return imageSource;
+    }
+
+    const fs::path coverFile{QtAdapter::toLocalFilePath(imageSource)};
+    if (!isCachedCover(coverFile)) {
+        return imageSource;
+    }
+    QUrl url;
+    url.setScheme(QStringLiteral("image"));
+    url.setHost(QString::fromLatin1(kAtlasProviderId));
+    url.setPath(u'/' + QtAdapter::fromUtf8String(coverFile.filename().string()));
+    return url;
+}
+
+} // namespace SongPlayer::CoverThumbnails
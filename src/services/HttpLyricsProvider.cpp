@@ -0,0 +1,218 @@
+#include "services/HttpLyricsProvider.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+#include "core/LyricCache.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrlQuery>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+QString lyricsFromJsonObject(const QJsonObject &entry)
+{
+    // Synchronized lyrics are preferred; plain lyrics still beat none.
+    const QString synced{entry.value(QStringLiteral("syncedLyrics")).toString()};
+    return synced.trimmed().isEmpty() ? entry.value(QStringLiteral("plainLyrics")).toString() : synced;
+}
+
+QString lyricsFromReply(const QByteArray &body)
+{
+    QJsonParseError parseError{};
+    const QJsonDocument document{QJsonDocument::fromJson(body, &parseError)};
+    if (parseError.error != QJsonParseError::NoError) {
+        // Not JSON: the endpoint serves the LRC file itself.
+        return QString::fromUtf8(body);
+    }
+
+    if (document.isObject()) {
+        return lyricsFromJsonObject(document.object());
+    }
+
+    // Search endpoints answer with candidates; take the first one with lyrics.
+    const QJsonArray candidates(document.array());
+    for (const QJsonValue &candidate : candidates) {
+        const QString lyrics{lyricsFromJsonObject(candidate.toObject())};
+        if (!lyrics.trimmed().isEmpty()) {
+            return lyrics;
+        }
+    }
+    return {};
+}
+
+// Queries that only differ in case or surrounding blanks share one fetch.
+QString fetchKey(const LyricsQuery &query)
+{
+    return SongPlayer::QtAdapter::fromUtf8String(
+        SongPlayer::Core::remoteLyricSource(SongPlayer::QtAdapter::toUtf8String(query.artist),
+                                            SongPlayer::QtAdapter::toUtf8String(query.title))
+            .path);
+}
+
+} // namespace
+
+HttpLyricsProvider::HttpLyricsProvider(QUrl endpoint, QObject *parent)
+    : HttpLyricsProvider{nullptr, std::move(endpoint), parent}
+{}
+
+HttpLyricsProvider::HttpLyricsProvider(QNetworkAccessManager *networkManager,
+                                       QUrl endpoint,
+                                       QObject *parent)
+    : QObject{parent}
+    , m_networkManager{networkManager != nullptr ? networkManager : &m_ownedNetworkManager}
+    , m_endpoint{std::move(endpoint)}
+{}
+
+HttpLyricsProvider::~HttpLyricsProvider()
+{
+    // Waiting callers see their futures canceled rather than hanging forever.
+    for (Fetch &fetch : m_fetches) {
+        if (fetch.reply) {
+            fetch.reply->disconnect(this);
+            fetch.reply->abort();
+            fetch.reply->deleteLater();
+        }
+        fetch.promise->future().cancel();
+        fetch.promise->finish();
+    }
+}
+
+QFuture<LyricsFetchResult> HttpLyricsProvider::fetchLyrics(const LyricsQuery &query)
+{
+    const QString key{fetchKey(query)};
+
+    const auto pending{m_fetches.find(key)};
+    if (pending != m_fetches.end()) {
+        ++pending->waiters;
+        return pending->promise->future();
+    }
+
+    auto promise{std::make_shared<QPromise<LyricsFetchResult>>()};
+    promise->start();
+    QFuture<LyricsFetchResult> future{promise->future()};
+
+    m_fetches.insert(key, Fetch{.query = query, .promise = std::move(promise), .reply = {}, .waiters = 1});
+    m_queue.push_back(key);
+    startQueuedFetches();
+    return future;
+}
+
+void HttpLyricsProvider::cancelFetch(const LyricsQuery &query)
+{
+    const QString key{fetchKey(query)};
+    const auto fetch{m_fetches.find(key)};
+    if (fetch == m_fetches.end() || --fetch->waiters > 0) {
+        return;
+    }
+
+    if (fetch->reply) {
+        // Disconnected first: abort() finishes the reply synchronously.
+        fetch->reply->disconnect(this);
+        fetch->reply->abort();
+        fetch->reply->deleteLater();
+        --m_runningFetches;
+    } else {
+        std::erase(m_queue, key);
+    }
+    const std::shared_ptr<QPromise<LyricsFetchResult>> promise{fetch->promise};
+    m_fetches.erase(fetch);
+    promise->future().cancel();
+    promise->finish();
+
+    startQueuedFetches();
+}
+
+int HttpLyricsProvider::maxConcurrentFetches() const
+{
+    return m_maxConcurrentFetches;
+}
+
+void HttpLyricsProvider::setMaxConcurrentFetches(int maxFetches)
+{
+    m_maxConcurrentFetches = qMax(1, maxFetches);
+    startQueuedFetches();
+}
+
+QUrl HttpLyricsProvider::endpoint() const
+{
+    return m_endpoint;
+}
+
+void HttpLyricsProvider::startQueuedFetches()
+{
+    while (m_runningFetches < m_maxConcurrentFetches && !m_queue.empty()) {
+        const QString key{m_queue.front()};
+        m_queue.pop_front();
+
+        const auto fetch{m_fetches.find(key)};
+        if (fetch == m_fetches.end()) {
+            continue;
+        }
+
+        QNetworkReply *reply{nullptr};
+        if (m_networkManager) {
+            QUrl requestUrl{m_endpoint};
+            QUrlQuery urlQuery{requestUrl};
+            urlQuery.addQueryItem(QStringLiteral("artist_name"), fetch->query.artist.trimmed());
+            urlQuery.addQueryItem(QStringLiteral("track_name"), fetch->query.title.trimmed());
+            requestUrl.setQuery(urlQuery);
+            reply = m_networkManager->get(QNetworkRequest{requestUrl});
+        }
+        if (reply == nullptr) {
+            qWarning() << "HttpLyricsProvider: Cannot fetch lyrics without a network access manager";
+            fetch->promise->addResult(LyricsFetchResult{});
+            fetch->promise->finish();
+            m_fetches.erase(fetch);
+            continue;
+        }
+
+        ++m_runningFetches;
+        fetch->reply = reply;
+        const QPointer<QNetworkReply> guardedReply{reply};
+        connect(reply, &QNetworkReply::finished, this, [this, key, guardedReply] {
+            handleReply(key, guardedReply);
+        });
+    }
+}
+
+void HttpLyricsProvider::handleReply(const QString &key, const QPointer<QNetworkReply> &reply)
+{
+    --m_runningFetches;
+    const auto fetch{m_fetches.find(key)};
+    if (fetch == m_fetches.end()) {
+        startQueuedFetches();
+        return;
+    }
+
+    // A reply destroyed before it could be read counts as a transient failure.
+    LyricsFetchResult result{};
+    if (reply) {
+        reply->deleteLater();
+        const int httpStatus{reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()};
+        if (reply->error() == QNetworkReply::ContentNotFoundError || httpStatus == 404) {
+            result.status = LyricsFetchResult::Status::NotFound;
+        } else if (reply->error() != QNetworkReply::NoError) {
+            qWarning() << "HttpLyricsProvider: Lyrics request failed:" << reply->errorString();
+        } else {
+            result.lyricsText = lyricsFromReply(reply->readAll());
+            result.status = result.lyricsText.trimmed().isEmpty()
+                ? LyricsFetchResult::Status::NotFound
+                : LyricsFetchResult::Status::Found;
+        }
+    }
+
+    const std::shared_ptr<QPromise<LyricsFetchResult>> promise{fetch->promise};
+    m_fetches.erase(fetch);
+    promise->addResult(std::move(result));
+    promise->finish();
+
+    startQueuedFetches();
+}
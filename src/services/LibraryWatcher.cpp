@@ -0,0 +1,287 @@
+#include "services/LibraryWatcher.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+#include "core/DirectoryTree.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <filesystem>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using std::optional;
+using std::vector;
+namespace fs = std::filesystem;
+
+namespace SongPlayer {
+namespace {
+
+QString toQtPath(const fs::path& path)
+{
+    return QtAdapter::fromLocalFilePath(path).toLocalFile();
+}
+
+bool isInside(const QString& path, const QString& folder)
+{
+    return path == folder || path.startsWith(folder.endsWith(u'/') ? folder : folder + u'/');
+}
+
+// Subdirectories of each changed directory; runs on the thread pool.
+vector<vector<fs::path>> listSubdirectories(const vector<fs::path>& directories)
+{
+    vector<vector<fs::path>> result;
+    result.reserve(directories.size());
+    for (const fs::path& directory : directories) {
+        vector<fs::path>& subdirectories{result.emplace_back()};
+        std::error_code error;
+        fs::directory_iterator entries{directory, fs::directory_options::skip_permission_denied, error};
+        for (; !error && entries != fs::directory_iterator{}; entries.increment(error)) {
+            std::error_code statusError;
+            if (entries->is_directory(statusError) && !entries->is_symlink(statusError)) {
+                subdirectories.push_back(entries->path());
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+LibraryWatcher::LibraryWatcher(QObject* parent)
+    : QObject{parent}
+{
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(kSettleDelay);
+    m_pollTimer.setInterval(kPollInterval);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &LibraryWatcher::handleDirectoryChanged);
+    connect(&m_settleTimer, &QTimer::timeout, this, &LibraryWatcher::settle);
+    connect(&m_pollTimer, &QTimer::timeout, this, &LibraryWatcher::poll);
+}
+
+void LibraryWatcher::watchFolder(const QUrl& folderUrl)
+{
+    if (!folderUrl.isLocalFile()) {
+        return;
+    }
+    const QString folder{QDir::cleanPath(folderUrl.toLocalFile())};
+    if (!folderOf(folder).isEmpty()) {
+        // Already covered by this folder or by one it lies in.
+        return;
+    }
+    m_folders.insert(folder);
+    addTree(folder, folder);
+}
+
+void LibraryWatcher::unwatchFolder(const QUrl& folderUrl)
+{
+    const QString folder{QDir::cleanPath(folderUrl.toLocalFile())};
+    if (!m_folders.remove(folder)) {
+        return;
+    }
+    m_polledFolders.remove(folder);
+    if (m_polledFolders.isEmpty()) {
+        m_pollTimer.stop();
+    }
+
+    QStringList inside;
+    for (const QString& directory : m_watcher.directories()) {
+        if (isInside(directory, folder)) {
+            inside.append(directory);
+        }
+    }
+    if (!inside.isEmpty()) {
+        m_watcher.removePaths(inside);
+    }
+}
+
+bool LibraryWatcher::isPolled(const QUrl& folderUrl) const
+{
+    return m_polledFolders.contains(QDir::cleanPath(folderUrl.toLocalFile()));
+}
+
+int LibraryWatcher::watchedDirectoryCount() const
+{
+    return static_cast<int>(m_watcher.directories().size());
+}
+
+void LibraryWatcher::setSettleDelay(std::chrono::milliseconds delay)
+{
+    m_settleTimer.setInterval(delay);
+}
+
+void LibraryWatcher::setPollInterval(std::chrono::milliseconds interval)
+{
+    m_pollTimer.setInterval(interval);
+}
+
+void LibraryWatcher::addTree(const QString& root, const QString& folder)
+{
+    const auto watched{static_cast<std::size_t>(watchedDirectoryCount())};
+    if (watched >= kMaxWatchedDirectories) {
+        pollFolder(folder);
+        return;
+    }
+
+    QtConcurrent::run([directory = QtAdapter::toLocalFilePath(QUrl::fromLocalFile(root)),
+                       limit = kMaxWatchedDirectories - watched] {
+        return Core::collectDirectoryTree(directory, limit);
+    }).then(this, [this, folder](optional<vector<fs::path>> tree) {
+        if (!m_folders.contains(folder) || m_polledFolders.contains(folder)) {
+            return;
+        }
+        if (!tree) {
+            pollFolder(folder);
+            return;
+        }
+
+        const QStringList watchedList{m_watcher.directories()};
+        const QSet<QString> alreadyWatched{watchedList.cbegin(), watchedList.cend()};
+        QStringList directories;
+        for (const fs::path& directory : *tree) {
+            const QString path{toQtPath(directory)};
+            if (!alreadyWatched.contains(path)) {
+                directories.append(path);
+            }
+        }
+        // Other listings may have used up the budget meanwhile.
+        if (static_cast<std::size_t>(alreadyWatched.size() + directories.size()) > kMaxWatchedDirectories) {
+            pollFolder(folder);
+            return;
+        }
+        if (!directories.isEmpty() && !m_watcher.addPaths(directories).isEmpty()) {
+            // Typically the inotify watch limit; a partly watched folder would miss changes.
+            pollFolder(folder);
+        }
+    });
+}
+
+void LibraryWatcher::handleDirectoryChanged(const QString& path)
+{
+    m_changedDirectories.insert(path);
+    m_settleTimer.start();
+}
+
+void LibraryWatcher::settle()
+{
+    // A removed directory has already left the watch list when its event arrives.
+    const QStringList watchedList{m_watcher.directories()};
+    const QSet<QString> watched{watchedList.cbegin(), watchedList.cend()};
+
+    QStringList changed;
+    vector<fs::path> changedPaths;
+    QSet<QString> removedParents;
+    for (const QString& directory : std::exchange(m_changedDirectories, {})) {
+        const QString folder{folderOf(directory)};
+        if (folder.isEmpty() || m_polledFolders.contains(folder)) {
+            continue;
+        }
+        if (watched.contains(directory)) {
+            changed.append(directory);
+            changedPaths.push_back(QtAdapter::toLocalFilePath(QUrl::fromLocalFile(directory)));
+        } else if (directory == folder) {
+            // The whole folder vanished, most likely with an unmounted drive: keep its
+            // tracks and look for it again on every poll.
+            pollFolder(folder);
+        } else {
+            // Renamed, moved or deleted: only a walk of what is left can tell, and it
+            // reports just the files that are really gone.
+            QString parent{directory};
+            do {
+                parent = QFileInfo{parent}.path();
+            } while (parent != folder && !watched.contains(parent));
+            removedParents.insert(parent);
+        }
+    }
+    for (const QString& parent : std::as_const(removedParents)) {
+        emit rescanRequested(QUrl::fromLocalFile(parent), true);
+    }
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    QtConcurrent::run([changedPaths = std::move(changedPaths)] {
+        return listSubdirectories(changedPaths);
+    }).then(this, [this, changed](vector<vector<fs::path>> subdirectories) {
+        const QStringList watchedList{m_watcher.directories()};
+        const QSet<QString> watchedNow{watchedList.cbegin(), watchedList.cend()};
+        for (qsizetype index{0}; index < changed.size(); ++index) {
+            const QString folder{folderOf(changed[index])};
+            if (folder.isEmpty() || m_polledFolders.contains(folder)) {
+                continue;
+            }
+            emit rescanRequested(QUrl::fromLocalFile(changed[index]), false);
+            for (const fs::path& subdirectory : subdirectories[static_cast<std::size_t>(index)]) {
+                const QString path{toQtPath(subdirectory)};
+                if (!watchedNow.contains(path)) {
+                    // New or moved in: read everything below it and watch it.
+                    emit rescanRequested(QUrl::fromLocalFile(path), true);
+                    addTree(path, folder);
+                }
+            }
+        }
+    });
+}
+
+void LibraryWatcher::poll()
+{
+    QStringList returning;
+    for (const QString& folder : std::as_const(m_polledFolders)) {
+        if (QDir{folder}.exists()) {
+            returning.append(folder);
+        }
+    }
+    for (const QString& folder : std::as_const(returning)) {
+        // A remounted drive or freed watches let the folder be watched again; if its
+        // tree still does not fit, addTree puts it back on the poll list.
+        if (static_cast<std::size_t>(watchedDirectoryCount()) < kMaxWatchedDirectories) {
+            m_polledFolders.remove(folder);
+            addTree(folder, folder);
+        }
+        // Whatever happened while it was polled is caught up with either way.
+        emit rescanRequested(QUrl::fromLocalFile(folder), true);
+    }
+    if (m_polledFolders.isEmpty()) {
+        m_pollTimer.stop();
+    }
+}
+
+void LibraryWatcher::pollFolder(const QString& folder)
+{
+    if (m_polledFolders.contains(folder)) {
+        return;
+    }
+    m_polledFolders.insert(folder);
+
+    QStringList inside;
+    for (const QString& directory : m_watcher.directories()) {
+        if (isInside(directory, folder)) {
+            inside.append(directory);
+        }
+    }
+    if (!inside.isEmpty()) {
+        m_watcher.removePaths(inside);
+    }
+    if (!m_pollTimer.isActive()) {
+        m_pollTimer.start();
+    }
+    emit folderPolled(QUrl::fromLocalFile(folder));
+}
+
+QString LibraryWatcher::folderOf(const QString& path) const
+{
+    for (const QString& folder : m_folders) {
+        if (isInside(path, folder)) {
+            return folder;
+        }
+    }
+    return {};
+}
+
+} // namespace SongPlayer
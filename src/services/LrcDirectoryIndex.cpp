@@ -0,0 +1,199 @@
+#include "services/LrcDirectoryIndex.h"
+
+#include "adapters/QtAudioTrackAdapter.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#include <utility>
+
+LrcDirectoryIndex::LrcDirectoryIndex(QThreadPool *workerPool, QObject *parent)
+    : QObject(parent)
+    , m_workerPool(workerPool)
+{
+    Q_ASSERT(m_workerPool);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &LrcDirectoryIndex::scheduleRescan);
+}
+
+std::shared_ptr<const LrcDirectoryIndex::Listing> LrcDirectoryIndex::listing(const QString& dirPath)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto entry = m_entries.find(dirPath);
+        if (entry != m_entries.end()) {
+            const bool expired = entry->unwatchedScannedAt >= 0 &&
+                QDateTime::currentMSecsSinceEpoch() - entry->unwatchedScannedAt >= kUnwatchedExpireMs;
+            if (!expired) {
+                entry->lastUsed = ++m_useCounter;
+                return entry->listing;
+            }
+        }
+    }
+
+    // Unknown (or expired unwatched) directory: scan unlocked, then publish. Two
+    // workers racing on the same directory both produce a valid snapshot.
+    std::shared_ptr<const Listing> scanned = scan(dirPath);
+
+    QString evictedDirPath;
+    bool newlyIndexed = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry& entry = m_entries[dirPath];
+        newlyIndexed = !entry.listing;
+        entry.listing = scanned;
+        entry.lastUsed = ++m_useCounter;
+        // Only an expired unwatched listing is restamped. A worker that lost the race
+        // for a directory seen for the first time leaves the stamp alone, since the
+        // directory is about to be watched.
+        if (!newlyIndexed && entry.unwatchedScannedAt >= 0) {
+            entry.unwatchedScannedAt = QDateTime::currentMSecsSinceEpoch();
+        }
+
+        if (newlyIndexed && static_cast<std::size_t>(m_entries.size()) > kMaxWatchedDirectories) {
+            auto leastRecent = m_entries.end();
+            for (auto candidate = m_entries.begin(); candidate != m_entries.end(); ++candidate) {
+                if (leastRecent == m_entries.end() || candidate->lastUsed < leastRecent->lastUsed) {
+                    leastRecent = candidate;
+                }
+            }
+            evictedDirPath = leastRecent.key();
+            m_entries.erase(leastRecent);
+        }
+    }
+
+    // QFileSystemWatcher belongs to the index's thread, so registration is posted there.
+    if (newlyIndexed) {
+        QMetaObject::invokeMethod(this, [this, dirPath, evictedDirPath] {
+            watch(dirPath, evictedDirPath);
+        }, Qt::QueuedConnection);
+    }
+    return scanned;
+}
+
+std::shared_ptr<const LrcDirectoryIndex::Listing> LrcDirectoryIndex::scan(const QString& dirPath)
+{
+    auto listing = std::make_shared<Listing>();
+
+    QDir directory(dirPath);
+    if (!directory.exists()) {
+        return listing;
+    }
+
+    // Set name filters to only include files with the ".lrc" extension,
+    // and filter for readable files to avoid processing inaccessible entries.
+    directory.setNameFilters({QStringLiteral("*.lrc")});
+    directory.setFilter(QDir::Files | QDir::Readable);
+
+    // Normalize every candidate name once per scan. Matching a track against the
+    // directory then only prepares the audio name and compares precomputed bigrams.
+    const QFileInfoList fileList = directory.entryInfoList();
+    listing->filePaths.reserve(fileList.size());
+    listing->names.reserve(static_cast<std::size_t>(fileList.size()));
+    for (const QFileInfo& fileInfo : fileList) {
+        const QString lrcBaseName = fileInfo.completeBaseName();
+        if (lrcBaseName.isEmpty()) {
+            // Skip LRC files that have no base name, as they cannot be meaningfully compared.
+            continue;
+        }
+
+        listing->filePaths.append(fileInfo.absoluteFilePath());
+        listing->names.push_back(SongPlayer::Core::prepareLyricFileName(
+            SongPlayer::QtAdapter::toUtf8String(lrcBaseName))));
+    }
+
+    return listing;
+}
+
+void LrcDirectoryIndex::watch(const QString& dirPath, const QString& evictedDirPath)
+{
+    if (!evictedDirPath.isEmpty()) {
+        m_watcher.removePath(evictedDirPath);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_entries.contains(dirPath)) {
+            // Already evicted again before the watch could be registered.
+            return;
+        }
+    }
+
+    if (!m_watcher.addPath(dirPath)) {
+        qDebug() << "LrcDirectoryIndex: Cannot watch" << dirPath << "- falling back to periodic rescans";
+        QMutexLocker locker(&m_mutex);
+        const auto entry = m_entries.find(dirPath);
+        if (entry != m_entries.end()) {
+            entry->unwatchedScannedAt = QDateTime::currentMSecsSinceEpoch();
+        }
+        return;
+    }
+
+    {
+        // A directory the watcher refused earlier is kept current by events from now on.
+        QMutexLocker locker(&m_mutex);
+        const auto entry = m_entries.find(dirPath);
+        if (entry != m_entries.end()) {
+            entry->unwatchedScannedAt = -1;
+        }
+    }
+
+    // A file created between the initial scan and the watch registration raised no
+    // event; one rescan closes that window.
+    scheduleRescan(dirPath);
+}
+
+void LrcDirectoryIndex::scheduleRescan(const QString& dirPath)
+{
+    if (m_rescanning.contains(dirPath)) {
+        m_rescanAgain.insert(dirPath);
+        return;
+    }
+    m_rescanning.insert(dirPath);
+
+    // A burst of events (an album copy, an editor's temporary files) collapses into
+    // at most one running rescan plus one follow-up per directory.
+    m_workerPool->start([this, dirPath] {
+        std::shared_ptr<const Listing> listing = scan(dirPath);
+        const bool exists = QFileInfo(dirPath).isDir();
+        QMetaObject::invokeMethod(this, [this, dirPath, listing = std::move(listing), exists]() mutable {
+            installRescan(dirPath, std::move(listing), exists);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LrcDirectoryIndex::installRescan(const QString& dirPath,
+                                      std::shared_ptr<const Listing> listing,
+                                      bool exists)
+{
+    m_rescanning.remove(dirPath);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto entry = m_entries.find(dirPath);
+        if (entry != m_entries.end()) {
+            if (exists) {
+                entry->listing = std::move(listing);
+            } else {
+                // The watcher drops removed directories; forget the entry so a later
+                // lookup scans and watches the directory afresh.
+                m_entries.erase(entry);
+            }
+        }
+    }
+
+    if (!exists) {
+        m_rescanAgain.remove(dirPath);
+        m_watcher.removePath(dirPath);
+        return;
+    }
+
+    if (m_rescanAgain.remove(dirPath)) {
+        scheduleRescan(dirPath);
+    }
+}
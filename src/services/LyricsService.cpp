@@ -5,10 +5,20 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QTextStream>
+#include <QThread>
+#include <QtConcurrentRun>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace {
 
@@ -22,26 +32,394 @@ std::string toUtf8String(const QString& value)
 
 LyricsService::LyricsService(QObject *parent)
     : QObject(parent)
+    , m_cacheDirectory(QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+                           .filePath(QString::fromLatin1(SongPlayer::Core::kLyricCacheDirectoryName)))
 {
+    // Two workers let a fresh lookup start while a stale one is still blocked in a
+    // slow stat on a network share; canceled lookups drop out at the next stage.
+    m_pool.setMaxThreadCount(2);
+    m_pool.setObjectName(QStringLiteral("lyrics-pool"));
 }
 
-std::vector<LyricsService::LyricLine> LyricsService::parseLrcFile(const QString& audioFilePath)
+LyricsService::~LyricsService()
 {
-    std::vector<LyricLine> lyrics;
+    m_pool.clear();
+    m_pool.waitForDone();
+}
 
-    /* Attempt to locate the corresponding LRC file for the given audio track.
-     *  This involves checking for an exact match first, then performing a fuzzy search
-     *  if an exact match is not found, to increase the likelihood of finding lyrics.
-     */
-    QString lrcFilePath = findLrcFile(audioFilePath);
-    if (lrcFilePath.isEmpty()) {
+QFuture<std::vector<LyricsService::LyricLine>> LyricsService::loadLyrics(
+    const QString& audioFilePath,
+    std::optional<SongPlayer::Core::LyricAssociation> association,
+    std::optional<LyricsQuery> remoteQuery)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    const auto prefetched = std::ranges::find(m_prefetched, audioFilePath, &PrefetchedLyrics::audioFilePath);
+    if (!audioFilePath.isEmpty() && prefetched != m_prefetched.end()) {
+        QFuture<std::vector<LyricLine>> lyrics = prefetched->lyrics;
+        const bool fresh = prefetched->age.elapsed() < kPrefetchMaxAgeMs;
+        m_prefetched.erase(prefetched);
+        if (fresh && !lyrics.isCanceled()) {
+            return lyrics;
+        }
+    }
+
+    const bool remote = m_lyricsProvider && remoteQuery && !remoteQuery->title.trimmed().isEmpty();
+    std::shared_ptr<RemoteFetch> fetch;
+    if (remote) {
+        fetch = std::make_shared<RemoteFetch>(RemoteFetch{.query = std::move(*remoteQuery)});
+    }
+    if (audioFilePath.isEmpty()) {
+        if (!remote) {
+            return QtFuture::makeReadyValueFuture(std::vector<LyricLine>{});
+        }
+        QFuture<std::vector<LyricLine>> lyrics = loadRemoteLyrics(fetch);
+        withdrawOnCancel(lyrics, fetch);
         return lyrics;
     }
 
+    QFuture<std::vector<LyricLine>> local = QtConcurrent::run(
+        &m_pool, [this, audioFilePath, association = std::move(association)](
+                     QPromise<std::vector<LyricLine>>& promise) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            ResolvedLyrics resolved = resolveLyrics(audioFilePath, association, promise);
+            if (!promise.isCanceled()) {
+                promise.addResult(std::move(resolved.lyrics));
+            }
+        });
+    if (!remote) {
+        return local;
+    }
+
+    // The provider is the last step of the chain: only asked when no local source
+    // had lyrics, and only from the GUI thread it lives on.
+    QFuture<std::vector<LyricLine>> lyrics =
+        local
+            .then(this, [this, fetch](std::vector<LyricLine> found) {
+                if (!found.empty() || !m_lyricsProvider || fetch->canceled) {
+                    return QtFuture::makeReadyValueFuture(std::move(found));
+                }
+                return loadRemoteLyrics(fetch);
+            })
+            .unwrap();
+    withdrawOnCancel(lyrics, fetch, local);
+    return lyrics;
+}
+
+void LyricsService::withdrawOnCancel(const QFuture<std::vector<LyricLine>>& lyrics,
+                                     const std::shared_ptr<RemoteFetch>& fetch,
+                                     QFuture<std::vector<LyricLine>> local)
+{
+    auto* watcher = new QFutureWatcher<std::vector<LyricLine>>(this);
+    connect(watcher, &QFutureWatcherBase::canceled, this, [this, fetch, local]() mutable {
+        // The local search on the lyrics pool stops at its next stage instead of
+        // holding a worker that the current song's lookup is waiting for.
+        local.cancel();
+        fetch->canceled = true;
+        // A finished request is no longer the provider's to cancel.
+        if (fetch->request.isValid() && !fetch->request.isFinished() && m_lyricsProvider) {
+            fetch->request = {};
+            m_lyricsProvider->cancelFetch(fetch->query);
+        }
+    });
+    connect(watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater);
+    watcher->setFuture(lyrics);
+}
+
+template <typename T>
+LyricsService::ResolvedLyrics LyricsService::resolveLyrics(
+    const QString& audioFilePath,
+    const std::optional<SongPlayer::Core::LyricAssociation>& association,
+    const QPromise<T>& promise)
+{
+    /* Attempt to locate lyrics for the given audio track, from the most to the least
+     *  reliable source: an LRC file sharing the audio file's base name, lyrics embedded
+     *  in the audio file's tags (captured at import time), then a fuzzy search over the
+     *  LRC files in the same directory.
+     */
+    if (association && associationIsCurrent(audioFilePath, *association)) {
+        // The library job already resolved the sidecar for this track and nothing in
+        // its directory changed since: skip the exact-name probe and the fuzzy search.
+        const QString lrcPath = association->lrcFile
+            ? QString::fromStdString(association->lrcFile->path)
+            : QString();
+        if (!lrcPath.isEmpty() && association->exactMatch) {
+            return loadLrcFile(lrcPath);
+        }
+        if (std::optional<ResolvedLyrics> embedded = loadEmbeddedLyrics(audioFilePath)) {
+            return std::move(*embedded);
+        }
+        return lrcPath.isEmpty() ? ResolvedLyrics{} : loadLrcFile(lrcPath);
+    }
+
+    const QString exactLrcPath = findExactLrcFile(audioFilePath);
+    if (!exactLrcPath.isEmpty()) {
+        return loadLrcFile(exactLrcPath);
+    }
+
+    if (promise.isCanceled()) {
+        return {};
+    }
+
+    if (std::optional<ResolvedLyrics> embedded = loadEmbeddedLyrics(audioFilePath)) {
+        return std::move(*embedded);
+    }
+
+    if (promise.isCanceled()) {
+        return {};
+    }
+
+    const QString fuzzyLrcPath = findBestLrcMatch(audioFilePath);
+    if (fuzzyLrcPath.isEmpty() || promise.isCanceled()) {
+        return {};
+    }
+    return loadLrcFile(fuzzyLrcPath);
+}
+
+void LyricsService::prefetchLyrics(const QString& audioFilePath,
+                                   std::optional<SongPlayer::Core::LyricAssociation> association,
+                                   std::optional<LyricsQuery> remoteQuery)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (audioFilePath.isEmpty() ||
+        std::ranges::contains(m_prefetched, audioFilePath, &PrefetchedLyrics::audioFilePath)) {
+        return;
+    }
+
+    if (m_prefetched.size() >= kPrefetchCapacity) {
+        m_prefetched.back().lyrics.cancel();
+        m_prefetched.pop_back();
+    }
+
+    PrefetchedLyrics entry{
+        .audioFilePath = audioFilePath,
+        .lyrics = {},
+        .age = {},
+    };
+    // Resolve through the regular path; nothing is cached under this file yet.
+    entry.lyrics = loadLyrics(audioFilePath, std::move(association), std::move(remoteQuery));
+    entry.age.start();
+    m_prefetched.insert(m_prefetched.begin(), std::move(entry));
+}
+
+void LyricsService::setLyricsProvider(ILyricsProvider *provider)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    m_lyricsProvider = provider;
+}
+
+QFuture<std::vector<LyricsService::LyricLine>> LyricsService::loadRemoteLyrics(
+    const std::shared_ptr<RemoteFetch>& fetch)
+{
+    SongPlayer::Core::LyricSourceIdentity source = SongPlayer::Core::remoteLyricSource(
+        toUtf8String(fetch->query.artist), toUtf8String(fetch->query.title));
+
+    // Consult the persistent cache on the worker first, so a track looked up once
+    // (with or without success) does not go back to the network on every play.
+    return QtConcurrent::run(&m_pool, [this, source] {
+               return loadRemoteCachedLyrics(source);
+           })
+        .then(this, [this, fetch, source](std::optional<std::vector<LyricLine>> cached) {
+            if (cached || !m_lyricsProvider || fetch->canceled) {
+                return QtFuture::makeReadyValueFuture(cached ? std::move(*cached) : std::vector<LyricLine>{});
+            }
+
+            fetch->request = m_lyricsProvider->fetchLyrics(fetch->query);
+            return fetch->request.then(
+                &m_pool, [this, source](LyricsFetchResult result) {
+                    std::vector<LyricLine> lyrics;
+                    if (result.status == LyricsFetchResult::Status::Found) {
+                        lyrics = SongPlayer::Core::parseEmbeddedLyrics(toUtf8String(result.lyricsText));
+                    }
+                    // An empty entry records "not found"; transient failures are retried.
+                    if (result.status != LyricsFetchResult::Status::Failed) {
+                        storeCachedLyrics(source, lyrics);
+                    }
+                    return lyrics;
+                });
+        })
+        .unwrap();
+}
+
+std::optional<std::vector<LyricsService::LyricLine>> LyricsService::loadRemoteCachedLyrics(
+    const SongPlayer::Core::LyricSourceIdentity& source) const
+{
+    std::optional<std::vector<LyricLine>> cached = loadCachedLyrics(source);
+    if (cached && cached->empty()) {
+        // The entry's write time is when the provider last answered "not found".
+        const qint64 ageMs = QFileInfo(cacheFilePath(source)).lastModified().msecsTo(QDateTime::currentDateTime());
+        if (ageMs >= SongPlayer::Core::kRemoteLyricsNotFoundTtlMs) {
+            return std::nullopt;
+        }
+    }
+    return cached;
+}
+
+QFuture<std::vector<LyricsService::LyricAssociationEntry>> LyricsService::resolveLyricAssociations(
+    std::vector<LyricAssociationEntry> entries)
+{
+    return QtConcurrent::run(&m_pool, [this, entries = std::move(entries)](
+                                          QPromise<std::vector<LyricAssociationEntry>>& promise) {
+        // A library-wide pass reads each directory once and bypasses the watched index,
+        // which is reserved for the directories actually being played from.
+        QHash<QString, std::shared_ptr<const LrcDirectoryIndex::Listing>> listings;
+        std::vector<LyricAssociationEntry> changed;
+        for (const LyricAssociationEntry& entry : entries) {
+            if (promise.isCanceled()) {
+                return;
+            }
+            if (entry.association && associationIsCurrent(entry.audioFilePath, *entry.association)) {
+                continue;
+            }
+
+            std::optional<SongPlayer::Core::LyricAssociation> resolved =
+                resolveAssociation(entry.audioFilePath, listings);
+            if (resolved && resolved != entry.association) {
+                changed.push_back(LyricAssociationEntry{
+                    .audioFilePath = entry.audioFilePath,
+                    .association = std::move(resolved),
+                });
+            }
+        }
+        promise.addResult(std::move(changed));
+    });
+}
+
+QFuture<std::vector<LyricsService::LyricTextEntry>> LyricsService::collectLyricText(
+    std::vector<LyricTextEntry> entries)
+{
+    return QtConcurrent::run(&m_pool, [this, entries = std::move(entries)](
+                                          QPromise<std::vector<LyricTextEntry>>& promise) mutable {
+        // Resolution reads parsed lyrics from the binary cache, so an unchanged
+        // library costs a few stats per track and never reparses an LRC file.
+        std::vector<LyricTextEntry> changed;
+        for (LyricTextEntry& entry : entries) {
+            ResolvedLyrics resolved = resolveLyrics(entry.audioFilePath, entry.association, promise);
+            if (promise.isCanceled()) {
+                return;
+            }
+            if (entry.indexed && resolved.source == entry.source) {
+                continue;
+            }
+            entry.indexed = true;
+            entry.source = std::move(resolved.source);
+            entry.lyrics = std::move(resolved.lyrics);
+            changed.push_back(std::move(entry));
+        }
+        promise.addResult(std::move(changed));
+    });
+}
+
+bool LyricsService::associationIsCurrent(const QString& audioFilePath,
+                                         const SongPlayer::Core::LyricAssociation& association) const
+{
+    const qint64 directoryModifiedMs =
+        QFileInfo(QFileInfo(audioFilePath).absolutePath()).lastModified().toMSecsSinceEpoch();
+    const std::optional<SongPlayer::Core::LyricSourceIdentity> lrcFile = association.lrcFile
+        ? sourceIdentity(QString::fromStdString(association.lrcFile->path))
+        : std::nullopt;
+    return SongPlayer::Core::lyricAssociationIsCurrent(association, directoryModifiedMs, lrcFile);
+}
+
+std::optional<SongPlayer::Core::LyricAssociation> LyricsService::resolveAssociation(
+    const QString& audioFilePath,
+    QHash<QString, std::shared_ptr<const LrcDirectoryIndex::Listing>>& listings) const
+{
+    const QFileInfo audioInfo(audioFilePath);
+    if (!audioInfo.isFile()) {
+        return std::nullopt;
+    }
+
+    // Read the directory time before looking inside it, so a file added during the
+    // resolution makes the stored association stale rather than silently missed.
+    const QString dirPath = audioInfo.absolutePath();
+    SongPlayer::Core::LyricAssociation association{
+        .lrcFile = std::nullopt,
+        .exactMatch = false,
+        .directoryModifiedMs = QFileInfo(dirPath).lastModified().toMSecsSinceEpoch(),
+    };
+
+    const QString exactLrcPath = findExactLrcFile(audioFilePath);
+    if (!exactLrcPath.isEmpty()) {
+        association.lrcFile = sourceIdentity(exactLrcPath);
+        association.exactMatch = association.lrcFile.has_value();
+        return association;
+    }
+
+    auto listing = listings.constFind(dirPath);
+    if (listing == listings.cend()) {
+        listing = listings.insert(dirPath, LrcDirectoryIndex::scan(dirPath));
+    }
+    const QString fuzzyLrcPath = bestLrcMatch(audioInfo.completeBaseName(), **listing);
+    if (!fuzzyLrcPath.isEmpty()) {
+        association.lrcFile = sourceIdentity(fuzzyLrcPath);
+    }
+    return association;
+}
+
+std::optional<LyricsService::ResolvedLyrics> LyricsService::loadEmbeddedLyrics(
+    const QString& audioFilePath) const
+{
+    std::optional<SongPlayer::Core::LyricSourceIdentity> audioSource = sourceIdentity(audioFilePath);
+    if (!audioSource) {
+        return std::nullopt;
+    }
+    std::optional<std::vector<LyricLine>> lyrics = loadCachedLyrics(*audioSource);
+    if (!lyrics) {
+        return std::nullopt;
+    }
+    return ResolvedLyrics{
+        .source = std::move(audioSource),
+        .lyrics = std::move(*lyrics),
+    };
+}
+
+QFuture<void> LyricsService::storeEmbeddedLyrics(const QString& audioFilePath, const QString& lyricsText)
+{
+    if (lyricsText.isEmpty()) {
+        return QtFuture::makeReadyVoidFuture();
+    }
+
+    // Keyed by the audio file's identity, so re-tagging the file invalidates the entry
+    // exactly like editing an LRC file does. Parsing and the cache write stay off the
+    // GUI thread like every other lyric file operation.
+    return QtConcurrent::run(&m_pool, [this, audioFilePath, text = toUtf8String(lyricsText)] {
+        const std::optional<SongPlayer::Core::LyricSourceIdentity> source = sourceIdentity(audioFilePath);
+        if (!source) {
+            return;
+        }
+
+        const std::vector<LyricLine> lyrics = SongPlayer::Core::parseEmbeddedLyrics(text);
+        if (!lyrics.empty()) {
+            storeCachedLyrics(*source, lyrics);
+        }
+    });
+}
+
+LyricsService::ResolvedLyrics LyricsService::loadLrcFile(const QString& lrcFilePath)
+{
+    // A parsed copy keyed by the LRC file's path, size and modification time skips
+    // the read and parse entirely. Any edit to the LRC file changes the identity,
+    // so a stale entry is simply never matched and gets overwritten below.
+    ResolvedLyrics resolved{
+        .source = sourceIdentity(lrcFilePath),
+        .lyrics = {},
+    };
+    if (!resolved.source) {
+        return resolved;
+    }
+    if (std::optional<std::vector<LyricLine>> cached = loadCachedLyrics(*resolved.source)) {
+        resolved.lyrics = std::move(*cached);
+        return resolved;
+    }
+
     QFile lrcFile(lrcFilePath);
     if (!lrcFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-
-        return lyrics;
+        resolved.source.reset();
+        return resolved;
     }
 
     QTextStream stream(&lrcFile);
@@ -50,74 +428,97 @@ std::vector<LyricsService::LyricLine> LyricsService::parseLrcFile(const QString&
     lrcFile.close();
 
     const QByteArray contentBytes = content.toUtf8();
-    lyrics = SongPlayer::Core::parseLrcContent(
+    resolved.lyrics = SongPlayer::Core::parseLrcContent(
         std::string_view(contentBytes.constData(), static_cast<std::size_t>(contentBytes.size())));
+    storeCachedLyrics(*resolved.source, resolved.lyrics);
 
+    return resolved;
+}
 
-    return lyrics;
+std::optional<SongPlayer::Core::LyricSourceIdentity> LyricsService::sourceIdentity(
+    const QString& filePath) const
+{
+    const QFileInfo fileInfo(filePath);
+    if (filePath.isEmpty() || !fileInfo.isFile()) {
+        return std::nullopt;
+    }
+
+    return SongPlayer::Core::LyricSourceIdentity{
+        .path = toUtf8String(fileInfo.absoluteFilePath()),
+        .size = static_cast<std::uint64_t>(fileInfo.size()),
+        .modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch(),
+    };
 }
 
-QString LyricsService::findLrcFile(const QString& audioFilePath)
+std::optional<std::vector<LyricsService::LyricLine>> LyricsService::loadCachedLyrics(
+    const SongPlayer::Core::LyricSourceIdentity& source) const
 {
-    QFileInfo audioInfo(audioFilePath);
+    QFile cacheFile(cacheFilePath(source));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
 
-    QString exactLrcPath = audioInfo.absolutePath() + "/" +
-                           audioInfo.completeBaseName() + ".lrc";
+    // The cache layout is designed to be decoded in place from a mapping; fall back
+    // to a plain read on file systems that refuse to map.
+    const qint64 size = cacheFile.size();
+    if (uchar* mapped = cacheFile.map(0, size)) {
+        std::optional<std::vector<LyricLine>> lyrics = SongPlayer::Core::decodeLyricCache(
+            std::string_view(reinterpret_cast<const char*>(mapped), static_cast<std::size_t>(size)),
+            source);
+        cacheFile.unmap(mapped);
+        return lyrics;
+    }
 
-    QFileInfo exactLrcInfo(exactLrcPath);
-    if (exactLrcInfo.exists() && exactLrcInfo.isReadable()) {
+    const QByteArray bytes = cacheFile.readAll();
+    return SongPlayer::Core::decodeLyricCache(
+        std::string_view(bytes.constData(), static_cast<std::size_t>(bytes.size())), source);
+}
 
-        return exactLrcPath;
+void LyricsService::storeCachedLyrics(const SongPlayer::Core::LyricSourceIdentity& source,
+                                      std::span<const LyricLine> lyrics) const
+{
+    if (!QDir().mkpath(m_cacheDirectory)) {
+        return;
     }
 
-    QString fuzzyMatch = findBestLrcMatch(audioFilePath);
-    if (!fuzzyMatch.isEmpty()) {
-        return fuzzyMatch;
+    const std::string encoded = SongPlayer::Core::encodeLyricCache(source, lyrics);
+    if (encoded.empty()) {
+        return;
     }
 
+    // QSaveFile writes to a temporary file and renames on commit, so a reader never
+    // observes a partially written cache entry.
+    QSaveFile cacheFile(cacheFilePath(source));
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+        return;
+    }
 
-    return QString();
+    cacheFile.write(encoded.data(), static_cast<qint64>(encoded.size()));
+    if (!cacheFile.commit()) {
+        qDebug() << "LyricsService: Failed to write lyric cache for" << QString::fromStdString(source.path);
+    }
 }
 
-QStringList LyricsService::scanDirectoryForLrcFiles(const QString& dirPath)
+QString LyricsService::cacheFilePath(const SongPlayer::Core::LyricSourceIdentity& source) const
 {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    // Implement a caching mechanism to avoid redundant directory scans.
-    // This significantly improves performance when repeatedly searching the same directories
-    // by returning cached results within a defined expiration period.
-    if (m_directoryCache.contains(dirPath) && m_cacheTimestamp.contains(dirPath)) {
-        qint64 cacheTime = m_cacheTimestamp.value(dirPath);
-        if (currentTime - cacheTime < CACHE_EXPIRE_TIME) {
-            return m_directoryCache.value(dirPath);
-        }
-    }
+    return QDir(m_cacheDirectory).filePath(
+        QString::fromStdString(SongPlayer::Core::lyricCacheFileName(source.path)));
+}
 
-    QStringList lrcFiles;
+QString LyricsService::findExactLrcFile(const QString& audioFilePath) const
+{
+    QFileInfo audioInfo(audioFilePath);
 
-    QDir directory(dirPath);
-    if (!directory.exists()) {
-        // Return an empty list if the directory does not exist or is inaccessible.
-        return lrcFiles;
-    }
+    QString exactLrcPath = audioInfo.absolutePath() + "/" +
+                           audioInfo.completeBaseName() + ".lrc";
 
-    // Set name filters to only include files with the ".lrc" extension,
-    // and filter for readable files to avoid processing inaccessible entries.
-    QStringList nameFilters;
-    nameFilters << "*.lrc";
-    directory.setNameFilters(nameFilters);
-    directory.setFilter(QDir::Files | QDir::Readable);
+    QFileInfo exactLrcInfo(exactLrcPath);
+    if (exactLrcInfo.exists() && exactLrcInfo.isReadable()) {
 
-    QFileInfoList fileList = directory.entryInfoList();
-    for (const QFileInfo& fileInfo : std::as_const(fileList)) {
-        lrcFiles.append(fileInfo.absoluteFilePath());
+        return exactLrcPath;
     }
 
-    // Update the cache with the newly scanned files and the current timestamp.
-    // This ensures that subsequent requests for the same directory benefit from the cache.
-    m_directoryCache[dirPath] = lrcFiles;
-    m_cacheTimestamp[dirPath] = currentTime;
-
-    return lrcFiles;
+    return QString();
 }
 
 QString LyricsService::findBestLrcMatch(const QString& audioFilePath)
@@ -145,47 +546,35 @@ QString LyricsService::findBestLrcMatch(const QString& audioFilePath)
         return QString();
     }
 
-    // Scan the directory containing the audio file for all available LRC files.
-    // This list will be used for fuzzy matching.
-    QStringList lrcFiles = scanDirectoryForLrcFiles(dirPath);
-    if (lrcFiles.isEmpty()) {
-        // If no LRC files are found in the directory, no match is possible.
+    // Fetch the indexed LRC files of the directory containing the audio file. The
+    // listing carries the pre-normalized candidate names used for fuzzy matching.
+    const std::shared_ptr<const LrcDirectoryIndex::Listing> listing = m_lrcIndex.listing(dirPath);
+    const QString bestMatch = bestLrcMatch(audioBaseName, *listing);
+
+    // Log the outcome of the search for debugging and monitoring purposes.
+    if (bestMatch.isEmpty()) {
+        qDebug() << "LyricsService: No suitable LRC match found for" << audioBaseName;
         return QString();
     }
 
-    QString bestMatch;
-    double bestScore = 0.0;
-    // Define a threshold for the match score. Only LRC files with a score above this
-    // will be considered valid matches, filtering out low-confidence results.
-    const double MATCH_THRESHOLD = 60.0;
-
-    // Iterate through all found LRC files to calculate a similarity score for each.
-    // The file with the highest score above the threshold is selected as the best match.
-    for (const QString& lrcFilePath : std::as_const(lrcFiles)) {
-        QFileInfo lrcInfo(lrcFilePath);
-        QString lrcBaseName = lrcInfo.completeBaseName();
-
-        if (lrcBaseName.isEmpty()) {
-            // Skip LRC files that have no base name, as they cannot be meaningfully compared.
-            continue;
-        }
-
-        double score = SongPlayer::Core::lyricFileMatchScore(
-            toUtf8String(audioBaseName),
-            toUtf8String(lrcBaseName));
+    qDebug() << "LyricsService: Found best LRC match for" << audioBaseName << ":" << bestMatch;
+    return bestMatch;
+}
 
-        if (score > bestScore && score >= MATCH_THRESHOLD) {
-            bestScore = score;
-            bestMatch = lrcFilePath;
-        }
+QString LyricsService::bestLrcMatch(const QString& audioBaseName, const LrcDirectoryIndex::Listing& listing)
+{
+    if (listing.filePaths.isEmpty()) {
+        // If no LRC files are found in the directory, no match is possible.
+        return QString();
     }
 
-    // Log the outcome of the search for debugging and monitoring purposes.
-    if (!bestMatch.isEmpty()) {
-        qDebug() << "LyricsService: Found best LRC match for" << audioBaseName << ":" << bestMatch << "(Score:" << bestScore << ")";
-    } else {
-        qDebug() << "LyricsService: No suitable LRC match found for" << audioBaseName;
+    // Score every candidate in one batch. Only LRC files at or above the core match
+    // threshold are considered valid, filtering out low-confidence results.
+    const std::optional<SongPlayer::Core::LyricFileMatch> match =
+        SongPlayer::Core::bestLyricFileMatch(toUtf8String(audioBaseName), listing.names);
+    if (!match) {
+        return QString();
     }
 
-    return bestMatch;
+    return listing.filePaths.at(static_cast<qsizetype>(match->candidateIndex));
 }
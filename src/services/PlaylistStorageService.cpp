@@ -5,13 +5,20 @@
 #include "storage/PlaylistDatabase.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QVariantList>
+#include <QtConcurrent/QtConcurrentRun>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -80,6 +87,168 @@ SongPlayer::Core::PlayMode storedPlayMode(int value)
     return PlayMode::Loop;
 }
 
+// Lyric search rows of one audio item occupy the rowid range [id << bits, (id + 1) << bits).
+constexpr int kLyricSearchLineBits{20};
+constexpr size_t kMaxIndexedLyricLines{size_t{1} << kLyricSearchLineBits};
+
+qlonglong lyricSearchRowId(qlonglong audioItemId, size_t line)
+{
+    return (audioItemId << kLyricSearchLineBits) | static_cast<qlonglong>(line);
+}
+
+QString lyricSearchSourcesQuery()
+{
+    return QStringLiteral(
+        "SELECT a.audio_source, l.lrc_path, l.lrc_size, l.lrc_modified_ms, l.exact_match, "
+        "l.directory_modified_ms, s.audio_item_id AS indexed_item, s.source_path, s.source_size, "
+        "s.source_modified_ms "
+        "FROM audio_items a "
+        "LEFT JOIN lyric_associations l ON l.audio_item_id = a.id "
+        "LEFT JOIN lyric_search_sources s ON s.audio_item_id = a.id");
+}
+
+// The FTS5 expression for user input; empty when nothing searchable is left.
+QString lyricSearchExpression(const QString& text)
+{
+    return SongPlayer::QtAdapter::fromUtf8String(
+        SongPlayer::Core::lyricSearchExpression(SongPlayer::QtAdapter::toUtf8String(text)));
+}
+
+// Binds the expression and the limit. Ranks inside the FTS table first so the join
+// only touches the rows returned.
+QString lyricSearchQuery()
+{
+    return QStringLiteral(
+               "SELECT a.audio_source, m.timestamp_ms, m.line_text FROM ("
+               "SELECT rowid, timestamp_ms, line_text, rank FROM lyric_search "
+               "WHERE lyric_search MATCH ? ORDER BY rank LIMIT ?) m "
+               "JOIN audio_items a ON a.id = (m.rowid >> %1) "
+               "ORDER BY m.rank")
+        .arg(kLyricSearchLineBits);
+}
+
+vector<LyricSearchMatch> readLyricSearchMatches(QSqlQuery& query)
+{
+    vector<LyricSearchMatch> result;
+    while (query.next()) {
+        result.push_back(LyricSearchMatch{
+            .audioSource = QUrl{query.value(0).toString()},
+            .timestampMs = query.value(1).toLongLong(),
+            .lineText = query.value(2).toString(),
+        });
+    }
+    return result;
+}
+
+const QString& coverImageSourcesQuery()
+{
+    static const QString query{QStringLiteral(
+        "SELECT DISTINCT image_source FROM audio_items WHERE image_source IS NOT NULL")};
+    return query;
+}
+
+vector<QUrl> readUrls(QSqlQuery& query)
+{
+    vector<QUrl> result;
+    while (query.next()) {
+        result.emplace_back(query.value(0).toString());
+    }
+    return result;
+}
+
+QString fileFingerprintsQuery()
+{
+    return QStringLiteral("SELECT audio_source, device, inode, size, modified_ns FROM audio_file_fingerprints");
+}
+
+vector<StoredFileFingerprint> readFileFingerprints(QSqlQuery& query)
+{
+    vector<StoredFileFingerprint> result;
+    while (query.next()) {
+        result.push_back(StoredFileFingerprint{
+            .audioSource = QUrl{query.value(0).toString()},
+            .fingerprint = SongPlayer::Core::FileFingerprint{
+                .device = query.value(1).toULongLong(),
+                .inode = query.value(2).toULongLong(),
+                .size = query.value(3).toULongLong(),
+                .modifiedNs = query.value(4).toLongLong(),
+            },
+        });
+    }
+    return result;
+}
+
+// Runs read over a read-only connection of its own; called on the thread pool. SQLite
+// connections belong to the thread that opened them, so every call opens one and drops
+// it again; readers do not block the GUI thread's connection.
+template <typename Read>
+std::invoke_result_t<Read, QSqlDatabase&> readOverOwnConnection(const QString& databasePath, Read read)
+{
+    static std::atomic_int nextConnection{0};
+    const QString connectionName{QStringLiteral("storage_reader_%1").arg(nextConnection.fetch_add(1))};
+    std::invoke_result_t<Read, QSqlDatabase&> result{};
+    {
+        QSqlDatabase database{QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName)};
+        database.setDatabaseName(databasePath);
+        database.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=1000"));
+        if (database.open()) {
+            result = read(database);
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return result;
+}
+
+optional<SongPlayer::Core::LyricAssociation> lyricAssociationFromQuery(const QSqlQuery& query)
+{
+    const QVariant directoryModified{query.value(QStringLiteral("directory_modified_ms"))};
+    if (directoryModified.isNull()) {
+        return nullopt;
+    }
+
+    SongPlayer::Core::LyricAssociation association{
+        .lrcFile = nullopt,
+        .exactMatch = query.value(QStringLiteral("exact_match")).toBool(),
+        .directoryModifiedMs = directoryModified.toLongLong(),
+    };
+    const QVariant lrcPath{query.value(QStringLiteral("lrc_path"))};
+    if (!lrcPath.isNull()) {
+        association.lrcFile = SongPlayer::Core::LyricSourceIdentity{
+            .path = SongPlayer::QtAdapter::toUtf8String(lrcPath.toString()),
+            .size = query.value(QStringLiteral("lrc_size")).toULongLong(),
+            .modifiedMs = query.value(QStringLiteral("lrc_modified_ms")).toLongLong(),
+        };
+    }
+    return association;
+}
+
+// Appends the local tracks among the rows of a lyricSearchSourcesQuery().
+void readLyricSearchSources(QSqlQuery& query, vector<StoredLyricSearchSource>& result)
+{
+    while (query.next()) {
+        const QUrl audioSource{query.value(QStringLiteral("audio_source")).toString()};
+        if (!audioSource.isLocalFile()) {
+            continue;
+        }
+
+        StoredLyricSearchSource stored{
+            .audioSource = audioSource,
+            .association = lyricAssociationFromQuery(query),
+            .indexed = !query.value(QStringLiteral("indexed_item")).isNull(),
+            .indexedSource = nullopt,
+        };
+        const QVariant sourcePath{query.value(QStringLiteral("source_path"))};
+        if (!sourcePath.isNull()) {
+            stored.indexedSource = SongPlayer::Core::LyricSourceIdentity{
+                .path = SongPlayer::QtAdapter::toUtf8String(sourcePath.toString()),
+                .size = query.value(QStringLiteral("source_size")).toULongLong(),
+                .modifiedMs = query.value(QStringLiteral("source_modified_ms")).toLongLong(),
+            };
+        }
+        result.push_back(std::move(stored));
+    }
+}
+
 } // namespace
 
 PlaylistStorageService::PlaylistStorageService(QObject* parent)
@@ -359,6 +528,442 @@ QString PlaylistStorageService::lastError() const
     return m_lastError;
 }
 
+optional<SongPlayer::Core::LyricAssociation> PlaylistStorageService::lyricAssociation(const QUrl& audioSource)
+{
+    if (!m_initialized || audioSource.isEmpty()) {
+        return nullopt;
+    }
+
+    QSqlQuery query{m_database->executeQuery(
+        QStringLiteral(
+            "SELECT l.lrc_path, l.lrc_size, l.lrc_modified_ms, l.exact_match, l.directory_modified_ms "
+            "FROM audio_items a JOIN lyric_associations l ON l.audio_item_id = a.id "
+            "WHERE a.audio_source = ?"),
+        QVariantList{audioSource.toString()})};
+    return query.next() ? lyricAssociationFromQuery(query) : nullopt;
+}
+
+vector<StoredLyricAssociation> PlaylistStorageService::libraryLyricAssociations()
+{
+    vector<StoredLyricAssociation> result;
+    if (!checkInitialized()) {
+        return result;
+    }
+
+    QSqlQuery query{m_database->executeQuery(
+        QStringLiteral(
+            "SELECT a.audio_source, l.lrc_path, l.lrc_size, l.lrc_modified_ms, l.exact_match, "
+            "l.directory_modified_ms "
+            "FROM audio_items a LEFT JOIN lyric_associations l ON l.audio_item_id = a.id"))};
+    while (query.next()) {
+        const QUrl audioSource{query.value(QStringLiteral("audio_source")).toString()};
+        if (!audioSource.isLocalFile()) {
+            // Network tracks have no sidecar LRC to resolve.
+            continue;
+        }
+        result.push_back(StoredLyricAssociation{
+            .audioSource = audioSource,
+            .association = lyricAssociationFromQuery(query),
+        });
+    }
+
+    return result;
+}
+
+bool PlaylistStorageService::storeLyricAssociations(span<const StoredLyricAssociation> associations)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+
+    return m_database->runInTransaction([this, associations]() {
+        for (const StoredLyricAssociation& stored : associations) {
+            if (!stored.association) {
+                continue;
+            }
+
+            const SongPlayer::Core::LyricAssociation& association{*stored.association};
+            const auto& lrcFile{association.lrcFile};
+            // Tracks removed from the library meanwhile match no audio item and insert nothing.
+            if (!m_database->executeNonQuery(
+                    QStringLiteral(
+                        "INSERT OR REPLACE INTO lyric_associations "
+                        "(audio_item_id, lrc_path, lrc_size, lrc_modified_ms, exact_match, directory_modified_ms) "
+                        "SELECT id, ?, ?, ?, ?, ? FROM audio_items WHERE audio_source = ?"),
+                    QVariantList{
+                        lrcFile ? QVariant{SongPlayer::QtAdapter::fromUtf8String(lrcFile->path)} : QVariant{},
+                        lrcFile ? QVariant{static_cast<qulonglong>(lrcFile->size)} : QVariant{},
+                        lrcFile ? QVariant{static_cast<qlonglong>(lrcFile->modifiedMs)} : QVariant{},
+                        association.exactMatch,
+                        static_cast<qlonglong>(association.directoryModifiedMs),
+                        stored.audioSource.toString(),
+                    })) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool PlaylistStorageService::lyricSearchAvailable() const
+{
+    return m_initialized && m_database->lyricSearchAvailable();
+}
+
+vector<StoredLyricSearchSource> PlaylistStorageService::lyricSearchSources()
+{
+    vector<StoredLyricSearchSource> result;
+    if (!checkInitialized() || !m_database->lyricSearchAvailable()) {
+        return result;
+    }
+
+    QSqlQuery query{m_database->executeQuery(lyricSearchSourcesQuery())};
+    readLyricSearchSources(query, result);
+    return result;
+}
+
+vector<StoredLyricSearchSource> PlaylistStorageService::lyricSearchSources(span<const QUrl> audioSources)
+{
+    vector<StoredLyricSearchSource> result;
+    if (!checkInitialized() || !m_database->lyricSearchAvailable()) {
+        return result;
+    }
+
+    // One indexed lookup per track, so a refresh after a single changed sidecar does
+    // not read the whole library.
+    const QString statement{lyricSearchSourcesQuery() + QStringLiteral(" WHERE a.audio_source = ?")};
+    for (const QUrl& audioSource : audioSources) {
+        QSqlQuery query{m_database->executeQuery(statement, QVariantList{audioSource.toString()})};
+        readLyricSearchSources(query, result);
+    }
+    return result;
+}
+
+bool PlaylistStorageService::storeLyricSearchText(span<const IndexedLyricText> entries)
+{
+    if (!checkInitialized() || !m_database->lyricSearchAvailable()) {
+        return false;
+    }
+
+    return m_database->runInTransaction([this, entries]() {
+        for (const IndexedLyricText& entry : entries) {
+            QSqlQuery itemQuery{m_database->executeQuery(
+                QStringLiteral("SELECT id FROM audio_items WHERE audio_source = ?"),
+                QVariantList{entry.audioSource.toString()})};
+            if (!itemQuery.next()) {
+                // Removed from the library while the indexer ran.
+                continue;
+            }
+            const qlonglong audioItemId{itemQuery.value(0).toLongLong()};
+
+            if (!m_database->executeNonQuery(
+                    QStringLiteral("DELETE FROM lyric_search WHERE rowid BETWEEN ? AND ?"),
+                    QVariantList{lyricSearchRowId(audioItemId, 0),
+                                 lyricSearchRowId(audioItemId, kMaxIndexedLyricLines - 1)})) {
+                return false;
+            }
+
+            QVariantList rowIds;
+            QVariantList lineTexts;
+            QVariantList timestamps;
+            const size_t lineCount{std::min(entry.lyrics.size(), kMaxIndexedLyricLines)};
+            for (size_t line{0}; line < lineCount; ++line) {
+                const SongPlayer::Core::LyricLine& lyric{entry.lyrics[line]};
+                if (lyric.text.empty()) {
+                    continue;
+                }
+                rowIds.append(lyricSearchRowId(audioItemId, line));
+                lineTexts.append(SongPlayer::QtAdapter::fromUtf8String(lyric.text));
+                timestamps.append(static_cast<qlonglong>(lyric.timestampMs));
+            }
+            if (!rowIds.isEmpty() &&
+                !m_database->executeBatch(
+                    QStringLiteral("INSERT INTO lyric_search (rowid, line_text, timestamp_ms) VALUES (?, ?, ?)"),
+                    QVariantList{rowIds, lineTexts, timestamps})) {
+                return false;
+            }
+
+            const auto& source{entry.source};
+            if (!m_database->executeNonQuery(
+                    QStringLiteral(
+                        "INSERT OR REPLACE INTO lyric_search_sources "
+                        "(audio_item_id, source_path, source_size, source_modified_ms) VALUES (?, ?, ?, ?)"),
+                    QVariantList{
+                        audioItemId,
+                        source ? QVariant{SongPlayer::QtAdapter::fromUtf8String(source->path)} : QVariant{},
+                        source ? QVariant{static_cast<qulonglong>(source->size)} : QVariant{},
+                        source ? QVariant{static_cast<qlonglong>(source->modifiedMs)} : QVariant{},
+                    })) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+vector<LyricSearchMatch> PlaylistStorageService::searchLyrics(const QString& text, int limit)
+{
+    vector<LyricSearchMatch> result;
+    if (!m_initialized || !m_database->lyricSearchAvailable() || limit <= 0) {
+        return result;
+    }
+
+    const QString expression{lyricSearchExpression(text)};
+    if (expression.isEmpty()) {
+        return result;
+    }
+
+    QSqlQuery query{m_database->executeQuery(lyricSearchQuery(),
+                                             QVariantList{expression, limit})};
+    return readLyricSearchMatches(query);
+}
+
+QFuture<vector<LyricSearchMatch>> PlaylistStorageService::searchLyricsAsync(const QString& text, int limit)
+{
+    const QString expression{lyricSearchExpression(text)};
+    if (!m_initialized || !m_database->lyricSearchAvailable() || limit <= 0 || expression.isEmpty()) {
+        return QtFuture::makeReadyValueFuture(vector<LyricSearchMatch>{});
+    }
+
+    return QtConcurrent::run([databasePath = m_database->databasePath(), expression, limit] {
+        return readOverOwnConnection(databasePath, [&expression, limit](QSqlDatabase& database) {
+            QSqlQuery query{database};
+            query.prepare(lyricSearchQuery());
+            query.addBindValue(expression);
+            query.addBindValue(limit);
+            return query.exec() ? readLyricSearchMatches(query) : vector<LyricSearchMatch>{};
+        });
+    });
+}
+
+vector<StoredFileFingerprint> PlaylistStorageService::fileFingerprints()
+{
+    if (!checkInitialized()) {
+        return {};
+    }
+
+    QSqlQuery query{m_database->executeQuery(fileFingerprintsQuery())};
+    return readFileFingerprints(query);
+}
+
+std::function<vector<StoredFileFingerprint>()> PlaylistStorageService::folderFingerprintsReader(
+    const QUrl& folderUrl) const
+{
+    if (!m_initialized || !folderUrl.isLocalFile()) {
+        return [] { return vector<StoredFileFingerprint>{}; };
+    }
+
+    // Sources are stored as QUrl strings, so the folder's own URL string is their
+    // prefix. LIKE ignores ASCII case, which only adds rows the rescan filters out.
+    QString prefix{QUrl::fromLocalFile(QDir::cleanPath(folderUrl.toLocalFile())).toString()};
+    if (!prefix.endsWith(u'/')) {
+        prefix += u'/';
+    }
+    prefix.replace(u'\\', QStringLiteral("\\\\"))
+        .replace(u'%', QStringLiteral("\\%"))
+        .replace(u'_', QStringLiteral("\\_"));
+
+    return [databasePath = m_database->databasePath(), pattern = prefix + u'%'] {
+        return readOverOwnConnection(databasePath, [&pattern](QSqlDatabase& database) {
+            QSqlQuery query{database};
+            query.prepare(fileFingerprintsQuery() + QStringLiteral(" WHERE audio_source LIKE ? ESCAPE '\\'"));
+            query.addBindValue(pattern);
+            return query.exec() ? readFileFingerprints(query) : vector<StoredFileFingerprint>{};
+        });
+    };
+}
+
+bool PlaylistStorageService::storeFileFingerprints(span<const StoredFileFingerprint> fingerprints)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+    if (fingerprints.empty()) {
+        return true;
+    }
+
+    // SQLite integers are signed 64-bit; device and inode numbers are stored by bit pattern.
+    QVariantList sources;
+    QVariantList devices;
+    QVariantList inodes;
+    QVariantList sizes;
+    QVariantList modifiedTimes;
+    for (const StoredFileFingerprint& stored : fingerprints) {
+        sources.append(stored.audioSource.toString());
+        devices.append(static_cast<qlonglong>(stored.fingerprint.device));
+        inodes.append(static_cast<qlonglong>(stored.fingerprint.inode));
+        sizes.append(static_cast<qlonglong>(stored.fingerprint.size));
+        modifiedTimes.append(static_cast<qlonglong>(stored.fingerprint.modifiedNs));
+    }
+
+    return m_database->runInTransaction([&]() {
+        return m_database->executeBatch(
+            QStringLiteral(
+                "INSERT OR REPLACE INTO audio_file_fingerprints "
+                "(audio_source, device, inode, size, modified_ns) VALUES (?, ?, ?, ?, ?)"),
+            QVariantList{sources, devices, inodes, sizes, modifiedTimes});
+    });
+}
+
+QFuture<vector<QUrl>> PlaylistStorageService::tracksWithoutPropertiesAsync()
+{
+    if (!m_initialized) {
+        return QtFuture::makeReadyValueFuture(vector<QUrl>{});
+    }
+
+    // A file read since then has a fingerprint and is not listed again, even when its
+    // duration really is unknown; only files that cannot be read are tried at every start.
+    return QtConcurrent::run([databasePath = m_database->databasePath()] {
+        return readOverOwnConnection(databasePath, [](QSqlDatabase& database) {
+            QSqlQuery query{database};
+            return query.exec(QStringLiteral(
+                       "SELECT audio_source FROM audio_items a "
+                       "WHERE a.duration_ms = 0 AND a.audio_source LIKE 'file:%' AND NOT EXISTS "
+                       "(SELECT 1 FROM audio_file_fingerprints f WHERE f.audio_source = a.audio_source)"))
+                ? readUrls(query)
+                : vector<QUrl>{};
+        });
+    });
+}
+
+bool PlaylistStorageService::storeAudioProperties(span<const StoredAudioProperties> properties)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+    if (properties.empty()) {
+        return true;
+    }
+
+    QVariantList durations;
+    QVariantList bitrates;
+    QVariantList sampleRates;
+    QVariantList channels;
+    QVariantList sources;
+    for (const StoredAudioProperties& stored : properties) {
+        durations.append(static_cast<qlonglong>(stored.properties.durationMs));
+        bitrates.append(stored.properties.bitrateKbps);
+        sampleRates.append(stored.properties.sampleRateHz);
+        channels.append(stored.properties.channels);
+        sources.append(stored.audioSource.toString());
+    }
+
+    return m_database->runInTransaction([&]() {
+        return m_database->executeBatch(
+            QStringLiteral(
+                "UPDATE audio_items SET duration_ms = ?, bitrate_kbps = ?, sample_rate_hz = ?, channels = ? "
+                "WHERE audio_source = ?"),
+            QVariantList{durations, bitrates, sampleRates, channels, sources});
+    });
+}
+
+bool PlaylistStorageService::removeLibraryFiles(span<const QUrl> audioSources, bool keepPlaylistEntries)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+    if (audioSources.empty()) {
+        return true;
+    }
+
+    QVariantList sources;
+    for (const QUrl& audioSource : audioSources) {
+        sources.append(audioSource.toString());
+    }
+    const QString unlisted{keepPlaylistEntries
+        ? QStringLiteral(" AND id NOT IN (SELECT audio_item_id FROM playlist_items)")
+        : QString{}};
+
+    return m_database->runInTransaction([&]() {
+        // Search rows are not covered by the cascade; they sit in the id range of the item.
+        if (m_database->lyricSearchAvailable()) {
+            for (const QVariant& source : std::as_const(sources)) {
+                QSqlQuery itemQuery{m_database->executeQuery(
+                    QStringLiteral("SELECT id FROM audio_items WHERE audio_source = ?") + unlisted,
+                    QVariantList{source})};
+                if (!itemQuery.next()) {
+                    continue;
+                }
+                const qlonglong audioItemId{itemQuery.value(0).toLongLong()};
+                if (!m_database->executeNonQuery(
+                        QStringLiteral("DELETE FROM lyric_search WHERE rowid BETWEEN ? AND ?"),
+                        QVariantList{lyricSearchRowId(audioItemId, 0),
+                                     lyricSearchRowId(audioItemId, kMaxIndexedLyricLines - 1)})) {
+                    return false;
+                }
+            }
+        }
+        return m_database->executeBatch(
+                   QStringLiteral("DELETE FROM audio_file_fingerprints WHERE audio_source = ?"),
+                   QVariantList{QVariant{sources}}) &&
+               m_database->executeBatch(
+                   QStringLiteral("DELETE FROM audio_items WHERE audio_source = ?") + unlisted,
+                   QVariantList{QVariant{sources}});
+    });
+}
+
+vector<QUrl> PlaylistStorageService::libraryFolders()
+{
+    vector<QUrl> result;
+    if (!checkInitialized()) {
+        return result;
+    }
+
+    QSqlQuery query{m_database->executeQuery(
+        QStringLiteral("SELECT folder_url FROM library_folders ORDER BY added_at, folder_url"))};
+    while (query.next()) {
+        result.emplace_back(query.value(0).toString());
+    }
+
+    return result;
+}
+
+bool PlaylistStorageService::addLibraryFolder(const QUrl& folderUrl)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+
+    return m_database->executeNonQuery(
+        QStringLiteral("INSERT OR IGNORE INTO library_folders (folder_url) VALUES (?)"),
+        QVariantList{folderUrl.toString()});
+}
+
+bool PlaylistStorageService::removeLibraryFolder(const QUrl& folderUrl)
+{
+    if (!checkInitialized()) {
+        return false;
+    }
+
+    return m_database->executeNonQuery(
+        QStringLiteral("DELETE FROM library_folders WHERE folder_url = ?"),
+        QVariantList{folderUrl.toString()});
+}
+
+vector<QUrl> PlaylistStorageService::coverImageSources()
+{
+    if (!checkInitialized()) {
+        return {};
+    }
+
+    QSqlQuery query{m_database->executeQuery(coverImageSourcesQuery())};
+    return readUrls(query);
+}
+
+QFuture<vector<QUrl>> PlaylistStorageService::coverImageSourcesAsync()
+{
+    if (!m_initialized) {
+        return QtFuture::makeReadyValueFuture(vector<QUrl>{});
+    }
+
+    return QtConcurrent::run([databasePath = m_database->databasePath()] {
+        return readOverOwnConnection(databasePath, [](QSqlDatabase& database) {
+            QSqlQuery query{database};
+            return query.exec(coverImageSourcesQuery()) ? readUrls(query) : vector<QUrl>{};
+        });
+    });
+}
+
 void PlaylistStorageService::onDatabaseError(const QString& error)
 {
     m_lastError = error;
@@ -372,22 +977,54 @@ int PlaylistStorageService::getOrCreateAudioItem(const SongPlayer::Core::AudioTr
         return -1;
     }
 
+    const QString title{SongPlayer::QtAdapter::fromUtf8String(audioInfo.title)};
+    const QString authorName{SongPlayer::QtAdapter::fromUtf8String(audioInfo.authorName)};
+    const QString imageSource{SongPlayer::QtAdapter::fromUtf8String(audioInfo.imageSource)};
+    const SongPlayer::Core::AudioProperties& properties{audioInfo.properties};
     QSqlQuery query{m_database->executeQuery(
-        QStringLiteral("SELECT id FROM audio_items WHERE audio_source = ?"), QVariantList{source})};
+        QStringLiteral("SELECT id, title, author_name, image_source, "
+                       "duration_ms, bitrate_kbps, sample_rate_hz, channels "
+                       "FROM audio_items WHERE audio_source = ?"),
+        QVariantList{source})};
     if (query.next()) {
-        return query.value(0).toInt();
+        const int audioItemId{query.value(0).toInt()};
+        const SongPlayer::Core::AudioProperties stored{
+            .durationMs = query.value(4).toLongLong(),
+            .bitrateKbps = query.value(5).toInt(),
+            .sampleRateHz = query.value(6).toInt(),
+            .channels = query.value(7).toInt(),
+        };
+        // A rescan re-reads the tags of changed files; only those rows are rewritten.
+        if (query.value(1).toString() != title || query.value(2).toString() != authorName ||
+            query.value(3).toString() != imageSource || stored != properties) {
+            if (!m_database->executeNonQuery(
+                    QStringLiteral("UPDATE audio_items SET title = ?, author_name = ?, image_source = ?, "
+                                   "duration_ms = ?, bitrate_kbps = ?, sample_rate_hz = ?, channels = ? "
+                                   "WHERE id = ?"),
+                    QVariantList{title, authorName, imageSource,
+                                 static_cast<qlonglong>(properties.durationMs), properties.bitrateKbps,
+                                 properties.sampleRateHz, properties.channels, audioItemId})) {
+                return -1;
+            }
+        }
+        return audioItemId;
     }
 
     if (!m_database->executeNonQuery(
             QStringLiteral("INSERT INTO audio_items "
-                           "(title, author_name, audio_source, image_source, video_source) "
-                           "VALUES (?, ?, ?, ?, ?)"),
+                           "(title, author_name, audio_source, image_source, video_source, "
+                           "duration_ms, bitrate_kbps, sample_rate_hz, channels) "
+                           "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"),
             QVariantList{
-                SongPlayer::QtAdapter::fromUtf8String(audioInfo.title),
-                SongPlayer::QtAdapter::fromUtf8String(audioInfo.authorName),
+                title,
+                authorName,
                 source,
-                SongPlayer::QtAdapter::fromUtf8String(audioInfo.imageSource),
+                imageSource,
                 SongPlayer::QtAdapter::fromUtf8String(audioInfo.videoSource),
+                static_cast<qlonglong>(properties.durationMs),
+                properties.bitrateKbps,
+                properties.sampleRateHz,
+                properties.channels,
             })) {
         return -1;
     }
@@ -444,7 +1081,8 @@ vector<SongPlayer::Core::AudioTrack> PlaylistStorageService::loadAudioItemsForPl
     vector<SongPlayer::Core::AudioTrack> result;
     QSqlQuery query{m_database->executeQuery(
         QStringLiteral(
-            "SELECT a.title, a.author_name, a.audio_source, a.image_source, a.video_source, p.position "
+            "SELECT a.title, a.author_name, a.audio_source, a.image_source, a.video_source, "
+            "a.duration_ms, a.bitrate_kbps, a.sample_rate_hz, a.channels, p.position "
             "FROM audio_items a JOIN playlist_items p ON a.id = p.audio_item_id "
             "WHERE p.playlist_id = ? ORDER BY p.position"),
         QVariantList{playlistId})};
@@ -456,6 +1094,12 @@ vector<SongPlayer::Core::AudioTrack> PlaylistStorageService::loadAudioItemsForPl
             QUrl{query.value(QStringLiteral("audio_source")).toString()},
             normalizeImagePath(query.value(QStringLiteral("image_source")).toString()),
             QUrl{query.value(QStringLiteral("video_source")).toString()})};
+        track.properties = SongPlayer::Core::AudioProperties{
+            .durationMs = query.value(QStringLiteral("duration_ms")).toLongLong(),
+            .bitrateKbps = query.value(QStringLiteral("bitrate_kbps")).toInt(),
+            .sampleRateHz = query.value(QStringLiteral("sample_rate_hz")).toInt(),
+            .channels = query.value(QStringLiteral("channels")).toInt(),
+        };
         track.songIndex = query.value(QStringLiteral("position")).toInt();
         result.push_back(std::move(track));
     }
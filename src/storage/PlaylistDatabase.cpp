@@ -1,6 +1,7 @@
 #include "storage/PlaylistDatabase.h"
 
 #include <QScopeGuard>
+#include <QStringList>
 
 using std::exception;
 using std::function;
@@ -97,6 +98,24 @@ bool PlaylistDatabase::createTables()
             return false;
         }
 
+        if (!createLyricAssociationsTable()) {
+            rollbackTransaction();
+            return false;
+        }
+
+        if (!createFileFingerprintsTable()) {
+            rollbackTransaction();
+            return false;
+        }
+
+        if (!createLibraryFoldersTable()) {
+            rollbackTransaction();
+            return false;
+        }
+
+        // Optional: a missing FTS5 module disables lyric search, not the playlists.
+        m_lyricSearchAvailable = createLyricSearchTables();
+
         if (!createIndexes()) {
             rollbackTransaction();
             return false;
@@ -115,6 +134,16 @@ bool PlaylistDatabase::createTables()
     }
 }
 
+bool PlaylistDatabase::lyricSearchAvailable() const
+{
+    return m_lyricSearchAvailable;
+}
+
+QString PlaylistDatabase::databasePath() const
+{
+    return m_databasePath;
+}
+
 QSqlQuery PlaylistDatabase::executeQuery(const QString &queryString, const QVariantList &values)
 {
     QSqlQuery query(m_database);
@@ -137,6 +166,22 @@ bool PlaylistDatabase::executeNonQuery(const QString &queryString, const QVarian
     return !query.lastError().isValid();
 }
 
+bool PlaylistDatabase::executeBatch(const QString &queryString, const QVariantList &columns)
+{
+    QSqlQuery query(m_database);
+    query.prepare(queryString);
+
+    for (const QVariant &column : columns) {
+        query.addBindValue(column);
+    }
+
+    if (!query.execBatch()) {
+        logError("Execute batch", query.lastError());
+        return false;
+    }
+    return true;
+}
+
 bool PlaylistDatabase::beginTransaction()
 {
     if (!m_database.transaction()) {
@@ -257,7 +302,11 @@ bool PlaylistDatabase::createAudioItemsTable()
             audio_source TEXT NOT NULL UNIQUE,
             image_source TEXT,
             video_source TEXT,
-            created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            duration_ms INTEGER NOT NULL DEFAULT 0,
+            bitrate_kbps INTEGER NOT NULL DEFAULT 0,
+            sample_rate_hz INTEGER NOT NULL DEFAULT 0,
+            channels INTEGER NOT NULL DEFAULT 0
         )
     )"};
 
@@ -267,6 +316,38 @@ bool PlaylistDatabase::createAudioItemsTable()
         return false;
     }
 
+    return addAudioPropertyColumns();
+}
+
+bool PlaylistDatabase::addAudioPropertyColumns()
+{
+    // Databases created before audio properties were read at import lack these
+    // columns. SQLite has no ADD COLUMN IF NOT EXISTS, so the existing columns are
+    // looked up first. Old rows get 0 (unknown); createFileFingerprintsTable() then
+    // drops their fingerprints, which marks their files to be read again once.
+    QSqlQuery columns(m_database);
+    if (!columns.exec(QStringLiteral("PRAGMA table_info(audio_items)"))) {
+        logError("Read audio items columns", columns.lastError());
+        return false;
+    }
+    QStringList existing;
+    while (columns.next()) {
+        existing.append(columns.value(1).toString());
+    }
+
+    for (const char *column : {"duration_ms", "bitrate_kbps", "sample_rate_hz", "channels"}) {
+        if (existing.contains(QLatin1String(column))) {
+            continue;
+        }
+        QSqlQuery query(m_database);
+        if (!query.exec(QStringLiteral("ALTER TABLE audio_items ADD COLUMN %1 INTEGER NOT NULL DEFAULT 0")
+                            .arg(QLatin1String(column)))) {
+            logError("Add audio items column", query.lastError());
+            return false;
+        }
+        m_audioPropertiesAdded = true;
+    }
+
     return true;
 }
 
@@ -297,6 +378,135 @@ bool PlaylistDatabase::createPlaylistItemsTable()
     return true;
 }
 
+bool PlaylistDatabase::createLyricAssociationsTable()
+{
+    // Defines the schema for the 'lyric_associations' table, one row per audio item.
+    // It records which sidecar LRC file a background job resolved for the track (NULL
+    // lrc_path when none matched) together with the fingerprints that keep the row valid:
+    // the LRC file's size and modification time, and the modification time of the audio
+    // file's directory, which changes whenever an LRC file appears or disappears there.
+    const QString createTableQuery{R"(
+        CREATE TABLE IF NOT EXISTS lyric_associations (
+            audio_item_id INTEGER PRIMARY KEY,
+            lrc_path TEXT,
+            lrc_size INTEGER,
+            lrc_modified_ms INTEGER,
+            exact_match INTEGER NOT NULL DEFAULT 0,
+            directory_modified_ms INTEGER NOT NULL,
+            resolved_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            FOREIGN KEY (audio_item_id) REFERENCES audio_items(id) ON DELETE CASCADE
+        )
+    )"};
+
+    QSqlQuery query(m_database);
+    if (!query.exec(createTableQuery)) {
+        logError("Create lyric associations table", query.lastError());
+        return false;
+    }
+
+    return true;
+}
+
+bool PlaylistDatabase::createLyricSearchTables()
+{
+    // 'lyric_search' is an FTS5 index with one row per lyric line. Its rowid packs the
+    // audio item id into the high bits and the line number into the low bits, so all
+    // lines of one track form a rowid range that can be replaced without a table scan.
+    // 'lyric_search_sources' records which lyric source (LRC file, or the audio file
+    // itself for embedded lyrics) each track was indexed from, with the fingerprint
+    // that tells the background indexer whether the track must be indexed again.
+    // NULL source_path marks a track that was indexed and has no lyrics.
+    const QStringList createTableQueries{
+        R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS lyric_search USING fts5(
+            line_text,
+            timestamp_ms UNINDEXED,
+            tokenize = 'unicode61 remove_diacritics 2'
+        )
+        )",
+        R"(
+        CREATE TABLE IF NOT EXISTS lyric_search_sources (
+            audio_item_id INTEGER PRIMARY KEY,
+            source_path TEXT,
+            source_size INTEGER,
+            source_modified_ms INTEGER,
+            indexed_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            FOREIGN KEY (audio_item_id) REFERENCES audio_items(id) ON DELETE CASCADE
+        )
+        )"
+    };
+
+    for (const QString &createTableQuery : createTableQueries) {
+        QSqlQuery query(m_database);
+        if (!query.exec(createTableQuery)) {
+            // Not routed through logError: the playlists work fine without this index.
+            qWarning() << "Lyric search is unavailable:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PlaylistDatabase::createFileFingerprintsTable()
+{
+    // Defines the schema for the 'audio_file_fingerprints' table, one row per imported
+    // local file. It records the device, inode, size and modification time (in
+    // nanoseconds) the file had when its metadata was read, so a folder rescan can
+    // skip every file that still matches. Rows are keyed by audio source rather than
+    // by audio item because imports are recorded before the next playlist save
+    // creates the audio items.
+    const QString createTableQuery{R"(
+        CREATE TABLE IF NOT EXISTS audio_file_fingerprints (
+            audio_source TEXT PRIMARY KEY,
+            device INTEGER NOT NULL,
+            inode INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            modified_ns INTEGER NOT NULL
+        )
+    )"};
+
+    QSqlQuery query(m_database);
+    if (!query.exec(createTableQuery)) {
+        logError("Create audio file fingerprints table", query.lastError());
+        return false;
+    }
+
+    // Files imported before audio properties were read still match their fingerprints.
+    // Without one they are listed by tracksWithoutPropertiesAsync(), and the player
+    // reads them again at its next start.
+    if (m_audioPropertiesAdded
+        && !query.exec(QStringLiteral(
+            "DELETE FROM audio_file_fingerprints WHERE audio_source IN "
+            "(SELECT audio_source FROM audio_items WHERE duration_ms = 0)"))) {
+        logError("Forget fingerprints of audio items without properties", query.lastError());
+        return false;
+    }
+
+    return true;
+}
+
+bool PlaylistDatabase::createLibraryFoldersTable()
+{
+    // Defines the schema for the 'library_folders' table, one row per folder the user
+    // imported. The folders are watched again at every start, so files added or
+    // removed while the player was closed are picked up by the next rescan.
+    const QString createTableQuery{R"(
+        CREATE TABLE IF NOT EXISTS library_folders (
+            folder_url TEXT PRIMARY KEY,
+            added_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )"};
+
+    QSqlQuery query(m_database);
+    if (!query.exec(createTableQuery)) {
+        logError("Create library folders table", query.lastError());
+        return false;
+    }
+
+    return true;
+}
+
 bool PlaylistDatabase::createIndexes()
 {
     // Defines a list of SQL queries to create indexes on frequently queried columns.
@@ -1,9 +1,21 @@
+#include "core/AudioFileEnumerator.h"
 #include "core/AudioImport.h"
+#include "core/CoverCache.h"
+#include "core/DeviceScheduler.h"
+#include "core/DirectoryTree.h"
+#include "core/FileFingerprint.h"
 #include "core/Playlist.h"
 #include "core/Lyrics.h"
+#include "core/LyricCache.h"
+#include "core/ReorderBuffer.h"
+#include "core/ThumbnailAtlas.h"
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +49,7 @@ SongPlayer::Core::AudioTrack track(
         .audioSource = move(source),
         .imageSource = {},
         .videoSource = {},
+        .properties = {},
     };
 }
 
@@ -52,6 +65,16 @@ int main()
     CHECK(playlist.size() == 2);
     CHECK(playlist.currentIndex() == 0);
     CHECK(playlist.containsSource("file:///beta.mp3"));
+    CHECK(playlist.indexOfSource("file:///beta.mp3") == 1);
+    CHECK(!playlist.indexOfSource("file:///gamma.mp3"));
+    CHECK(playlist.replaceTrack(1, track("Beta Retagged", "Bob", "file:///beta.mp3")));
+    CHECK(playlist.trackAt(1)->title == "Beta Retagged");
+    CHECK(!playlist.replaceTrack(1, track("Gamma", "Carol", "file:///gamma.mp3")));
+    CHECK(!playlist.replaceTrack(2, track("Beta Song", "Bob", "file:///beta.mp3")));
+    SongPlayer::Core::AudioTrack timed{track("Beta Retagged", "Bob", "file:///beta.mp3")};
+    timed.properties.durationMs = 215'000;
+    CHECK(playlist.replaceTrack(1, timed));
+    CHECK(playlist.totalDurationMs() == 215'000);
     CHECK(playlist.nextIndex() == 1);
     CHECK(playlist.previousIndex() == 1);
 
@@ -83,14 +106,23 @@ int main()
 
     CHECK(SongPlayer::Core::kUnknownArtistName == "Unknown Artist");
     CHECK(SongPlayer::Core::coverFileNameForAudioStem("song") == "song_cover.jpg");
-    CHECK(SongPlayer::Core::coverFileNameForAudio("song", "/music/a/song.mp3", "png") !=
-          SongPlayer::Core::coverFileNameForAudio("song", "/music/b/song.mp3", "png"));
+    CHECK(SongPlayer::Core::coverFileNameForImage("same artwork", "png") ==
+          SongPlayer::Core::coverFileNameForImage("same artwork", "png"));
+    CHECK(SongPlayer::Core::coverFileNameForImage("same artwork", "png") !=
+          SongPlayer::Core::coverFileNameForImage("other artwork", "png"));
+    CHECK(SongPlayer::Core::coverFileNameForImage("artwork", "").ends_with("-7.jpg"));
+    CHECK(SongPlayer::Core::coverThumbnailFileName("0123abcd-7.jpg", 64) == "0123abcd-7@64.jpg");
+    CHECK(SongPlayer::Core::coverThumbnailFileName("0123abcd-7.png", 64) == "0123abcd-7@64.png");
+    CHECK(SongPlayer::Core::coverThumbnailFileName("0123abcd-7.img", 300) == "0123abcd-7@300.png");
     CHECK(SongPlayer::Core::imageMimeTypeForExtension("jpg") == "image/jpeg");
     CHECK(SongPlayer::Core::imageMimeTypeForExtension("JPEG") == "image/jpeg");
     CHECK(SongPlayer::Core::imageMimeTypeForExtension("png") == "image/png");
     CHECK(SongPlayer::Core::imageMimeTypeForExtension("webp") == "image/unknown");
     CHECK(SongPlayer::Core::imageExtensionForMimeType("image/png") == "png");
     CHECK(SongPlayer::Core::imageExtensionForMimeType("image/webp") == "img");
+    CHECK(SongPlayer::Core::imageMimeTypeForData("\xFF\xD8\xFF\xE0") == "image/jpeg");
+    CHECK(SongPlayer::Core::imageMimeTypeForData("\x89PNG\r\n\x1A\n....") == "image/png");
+    CHECK(SongPlayer::Core::imageMimeTypeForData("GIF8") == "image/unknown");
 
     const vector<SongPlayer::Core::AudioTrack> tracks{
         track("Morning Light", "Composer", "file:///morning.mp3"),
@@ -127,8 +159,276 @@ int main()
     CHECK(SongPlayer::Core::lyricIndexAtPosition(lyrics, 16000) == 1);
     CHECK(SongPlayer::Core::lyricIndexAtPosition(lyrics, 21000) == 2);
 
+    const auto embeddedSynced{SongPlayer::Core::parseEmbeddedLyrics(
+        SongPlayer::Core::formatLrcContent(lyrics))};
+    CHECK(embeddedSynced.size() == lyrics.size());
+    CHECK(embeddedSynced[1].timestampMs == 15250 && embeddedSynced[1].text == "Middle");
+    CHECK(SongPlayer::Core::formatLrcTimestamp(61230) == "[01:01.23]");
+
+    const auto unsynced{SongPlayer::Core::parseEmbeddedLyrics("First line\r\n\nSecond line\n")};
+    CHECK(unsynced.size() == 2);
+    CHECK(unsynced[0].timestampMs == SongPlayer::Core::kUnsyncedLyricTimestamp);
+    CHECK(unsynced[1].text == "Second line");
+    CHECK(!SongPlayer::Core::lyricIndexAtPosition(unsynced, 60000));
+
+    CHECK(SongPlayer::Core::lyricSearchExpression("  hello   wor") == "\"hello\" \"wor\"*");
+    CHECK(SongPlayer::Core::lyricSearchExpression("say \"hi\" OR") == "\"say\" \"\"\"hi\"\"\" \"OR\"*");
+    CHECK(SongPlayer::Core::lyricSearchExpression(" \t ").empty());
+
     CHECK(SongPlayer::Core::normalizeLyricFileName("Song Title - Lyrics.lrc") == "songtitle");
     CHECK(SongPlayer::Core::lyricFileMatchScore("Song Title", "Song Title Lyrics") >= 80.0);
+    CHECK(SongPlayer::Core::lyricFileMatchScore("Morning Light", "Evening Rain") <
+          SongPlayer::Core::kLyricFileMatchThreshold);
+
+    const vector<SongPlayer::Core::LyricFileName> lrcCandidates{
+        SongPlayer::Core::prepareLyricFileName("Evening Rain"),
+        SongPlayer::Core::prepareLyricFileName("Morning Lihgt"),
+        SongPlayer::Core::prepareLyricFileName("Morning Light (Lyrics)"),
+    };
+    const auto bestLrc{SongPlayer::Core::bestLyricFileMatch("Morning Light", lrcCandidates)};
+    CHECK(bestLrc && bestLrc->candidateIndex == 2 && bestLrc->score == 100.0);
+    const auto fuzzyLrc{SongPlayer::Core::bestLyricFileMatch(
+        "Morning Light", std::span{lrcCandidates}.first(2))};
+    CHECK(fuzzyLrc && fuzzyLrc->candidateIndex == 1);
+    CHECK(!SongPlayer::Core::bestLyricFileMatch("Unrelated", lrcCandidates));
+
+    const SongPlayer::Core::LyricSourceIdentity lrcSource{
+        .path = "/music/album/song.lrc",
+        .size = 128,
+        .modifiedMs = 1700000000000,
+    };
+    const string encodedLyrics{SongPlayer::Core::encodeLyricCache(lrcSource, lyrics)};
+    CHECK(!encodedLyrics.empty());
+    const auto cachedLyrics{SongPlayer::Core::decodeLyricCache(encodedLyrics, lrcSource)};
+    CHECK(cachedLyrics && cachedLyrics->size() == lyrics.size());
+    CHECK(cachedLyrics && (*cachedLyrics)[2].timestampMs == 20500);
+    CHECK(cachedLyrics && (*cachedLyrics)[3].text == "Later");
+
+    SongPlayer::Core::LyricSourceIdentity touchedSource{lrcSource};
+    touchedSource.modifiedMs += 1;
+    CHECK(!SongPlayer::Core::decodeLyricCache(encodedLyrics, touchedSource));
+    CHECK(!SongPlayer::Core::decodeLyricCache(
+        std::string_view{encodedLyrics}.substr(0, encodedLyrics.size() - 1), lrcSource));
+    CHECK(SongPlayer::Core::lyricCacheFileName("/a.lrc") !=
+          SongPlayer::Core::lyricCacheFileName("/b.lrc"));
+
+    const auto remoteSource{SongPlayer::Core::remoteLyricSource(" The Band ", "Song")};
+    CHECK(remoteSource == SongPlayer::Core::remoteLyricSource("the band", "SONG"));
+    CHECK(remoteSource != SongPlayer::Core::remoteLyricSource("The Band", "Other Song"));
+    const string notFound{SongPlayer::Core::encodeLyricCache(remoteSource, {})};
+    const auto cachedNotFound{SongPlayer::Core::decodeLyricCache(notFound, remoteSource)};
+    CHECK(cachedNotFound && cachedNotFound->empty());
+
+    const SongPlayer::Core::LyricAssociation association{
+        .lrcFile = lrcSource,
+        .exactMatch = false,
+        .directoryModifiedMs = 1700000000500,
+    };
+    CHECK(SongPlayer::Core::lyricAssociationIsCurrent(association, 1700000000500, lrcSource));
+    CHECK(!SongPlayer::Core::lyricAssociationIsCurrent(association, 1700000000900, lrcSource));
+    CHECK(!SongPlayer::Core::lyricAssociationIsCurrent(association, 1700000000500, touchedSource));
+    CHECK(!SongPlayer::Core::lyricAssociationIsCurrent(association, 1700000000500, nullopt));
+    const SongPlayer::Core::LyricAssociation noLyrics{
+        .lrcFile = nullopt,
+        .exactMatch = false,
+        .directoryModifiedMs = 42,
+    };
+    CHECK(SongPlayer::Core::lyricAssociationIsCurrent(noLyrics, 42, nullopt));
+
+    SongPlayer::Core::ReorderBuffer<string> reorder;
+    CHECK(reorder.push(2, "third").empty());
+    CHECK(reorder.push(1, "second").empty());
+    CHECK(reorder.bufferedCount() == 2);
+    const vector<string> released{reorder.push(0, "first")};
+    CHECK((released == vector<string>{"first", "second", "third"}));
+    CHECK(reorder.nextIndex() == 3 && reorder.bufferedCount() == 0);
+    CHECK((reorder.push(3, "fourth") == vector<string>{"fourth"}));
+
+    // Items 0, 2 and 3 live on a spinning disk (limit 1), items 1 and 4 on an SSD (limit 2).
+    SongPlayer::Core::DeviceScheduler scheduler;
+    const std::size_t spinning{scheduler.addDevice(1)};
+    const std::size_t solid{scheduler.addDevice(2)};
+    for (const std::size_t device : {spinning, solid, spinning, spinning, solid}) {
+        scheduler.append(device);
+    }
+    CHECK(scheduler.usefulConcurrency() == 3);
+    CHECK(scheduler.claim(5) == 0);
+    CHECK(scheduler.claim(5) == 1);
+    CHECK(scheduler.claim(5) == 4);
+    CHECK(!scheduler.claim(5));
+    scheduler.release(0);
+    CHECK(!scheduler.claim(2));
+    CHECK(scheduler.claim(5) == 2);
+    scheduler.release(2);
+    CHECK(!scheduler.exhausted());
+    CHECK(scheduler.claim(5) == 3);
+    CHECK(scheduler.exhausted() && !scheduler.claim(5));
+
+    // Items discovered while the schedule runs: one spinning disk, then an SSD.
+    SongPlayer::Core::DeviceScheduler streaming;
+    CHECK(streaming.exhausted() && !streaming.claim(10));
+    const std::size_t disk{streaming.addDevice(1)};
+    streaming.append(disk);
+    streaming.append(disk);
+    CHECK(streaming.claim(10) == 0);
+    CHECK(!streaming.claim(10));
+    const std::size_t ssd{streaming.addDevice(2)};
+    streaming.append(ssd);
+    CHECK(streaming.usefulConcurrency() == 3);
+    CHECK(streaming.claim(10) == 2);
+    streaming.release(0);
+    CHECK(streaming.claim(10) == 1);
+    CHECK(streaming.exhausted());
+
+    CHECK(SongPlayer::Core::isImportableAudioFile("/music/Track.FLAC"));
+    CHECK(SongPlayer::Core::isImportableAudioFile("song.opus"));
+    CHECK(!SongPlayer::Core::isImportableAudioFile("/music/cover.jpg"));
+    CHECK(!SongPlayer::Core::isImportableAudioFile("/music/mp3"));
+
+    const std::filesystem::path library{
+        std::filesystem::temp_directory_path() / "mysongplayer-core-enumerator"};
+    std::filesystem::remove_all(library);
+
+    std::filesystem::create_directories(library / "b-album" / "disc 1");
+    std::filesystem::create_directories(library / "a-album");
+    for (const char* file : {"02.mp3", "01.flac", "notes.txt", "a-album/02.ogg", "a-album/01.ogg",
+                             "b-album/cover.jpg", "b-album/disc 1/01.m4a"}) {
+        std::ofstream(library / file) << "x";
+    }
+    SongPlayer::Core::AudioFileEnumerator enumerator{library, true};
+    vector<string> walked;
+    while (const auto file{enumerator.next()}) {
+        walked.push_back(file->lexically_relative(library).generic_string());
+    }
+    CHECK((walked == vector<string>{
+        "01.flac", "02.mp3", "a-album/01.ogg", "a-album/02.ogg", "b-album/disc 1/01.m4a"}));
+    SongPlayer::Core::AudioFileEnumerator topLevel{library, false};
+    CHECK(topLevel.next() == library / "01.flac");
+    CHECK(topLevel.next() == library / "02.mp3");
+    CHECK(!topLevel.next());
+    SongPlayer::Core::AudioFileEnumerator missing{library / "missing", true};
+    CHECK(!missing.next());
+    const auto tree{SongPlayer::Core::collectDirectoryTree(library, 8)};
+    CHECK(tree && tree->front() == library && tree->size() == 4);
+    CHECK(!SongPlayer::Core::collectDirectoryTree(library, 3));
+    CHECK(!SongPlayer::Core::collectDirectoryTree(library / "missing", 8));
+    std::filesystem::remove_all(library);
+
+    const std::filesystem::path covers{std::filesystem::temp_directory_path() / "mysongplayer-core-covers"};
+    std::filesystem::remove_all(covers);
+    std::filesystem::create_directories(covers / "thumbnails");
+    for (const char* file : {"album.jpg", "thumbnails/album@64.jpg", "thumbnails/album@256.jpg",
+                             "thumbnails/gone@64.jpg", "logo.png", "thumbnails/logo@64.png",
+                             "single.png.42.tmp", "thumbnail-atlas.bin"}) {
+        std::ofstream(covers / file) << "xx";
+    }
+    const auto scanned{SongPlayer::Core::scanCoverCache(covers)};
+    CHECK(scanned.size() == 4);
+    CHECK(scanned[0].name == "album" && scanned[0].files.size() == 3 && scanned[0].bytes == 6);
+    CHECK(scanned[1].name == "gone" && scanned[3].name == "single.png.42.tmp");
+    CHECK(scanned[2].name == "logo" && scanned[2].files.size() == 2);
+    CHECK(SongPlayer::Core::removeCoverCacheEntry(scanned[0]) == 6);
+    CHECK(!std::filesystem::exists(covers / "thumbnails" / "album@256.jpg"));
+    CHECK(std::filesystem::exists(covers / "thumbnail-atlas.bin"));
+    CHECK(SongPlayer::Core::coverCacheEntryName("/cache/covers/album.jpg") == "album");
+    std::filesystem::remove_all(covers);
+
+    using SongPlayer::Core::CoverCacheEntry;
+    const vector<CoverCacheEntry> cached{
+        CoverCacheEntry{.name = "recent", .files = {}, .bytes = 40, .lastUsedNs = 900},
+        CoverCacheEntry{.name = "orphan", .files = {}, .bytes = 10, .lastUsedNs = 100},
+        CoverCacheEntry{.name = "oldest", .files = {}, .bytes = 30, .lastUsedNs = 200},
+        CoverCacheEntry{.name = "older", .files = {}, .bytes = 30, .lastUsedNs = 300},
+        CoverCacheEntry{.name = "fresh-orphan", .files = {}, .bytes = 10, .lastUsedNs = 800},
+    };
+    const std::set<string> referenced{"recent", "oldest", "older"};
+    const auto names = [](const vector<CoverCacheEntry>& entries) {
+        vector<string> result;
+        for (const CoverCacheEntry& entry : entries) {
+            result.push_back(entry.name);
+        }
+        return result;
+    };
+    CHECK((names(SongPlayer::Core::planCoverCacheCollection(cached, referenced, 1000, 500))
+           == vector<string>{"orphan"}));
+    CHECK((names(SongPlayer::Core::planCoverCacheCollection(cached, referenced, 110, 500))
+           == vector<string>{"orphan"}));
+    CHECK((names(SongPlayer::Core::planCoverCacheCollection(cached, referenced, 60, 500))
+           == vector<string>{"orphan", "fresh-orphan"}));
+    CHECK((names(SongPlayer::Core::planCoverCacheCollection(cached, referenced, 0, 850))
+           == vector<string>{"orphan", "fresh-orphan"}));
+
+    using SongPlayer::Core::FileFingerprint;
+    const FileFingerprint original{.device = 1, .inode = 10, .size = 4096, .modifiedNs = 1'000};
+    FileFingerprint touched{original};
+    touched.modifiedNs += 1;
+    SongPlayer::Core::LibraryRescan rescan{"/music/", true, {
+        {"/music/kept.mp3", original},
+        {"/music/album/changed.flac", original},
+        {"/music/album/gone.ogg", original},
+        {"/music/unreadable.mp3", original},
+        {"/musical/other.mp3", original},
+        {"/elsewhere/other.mp3", original},
+    }};
+    CHECK(!rescan.needsRead("/music/kept.mp3", original));
+    CHECK(rescan.needsRead("/music/album/changed.flac", touched));
+    CHECK(rescan.needsRead("/music/unreadable.mp3", nullopt));
+    CHECK(rescan.needsRead("/music/new.wav", original));
+    CHECK((rescan.missingFiles() == vector<std::filesystem::path>{"/music/album/gone.ogg"}));
+    SongPlayer::Core::LibraryRescan topLevelRescan{"/music", false, {
+        {"/music/kept.mp3", original},
+        {"/music/album/gone.ogg", original},
+    }};
+    CHECK((topLevelRescan.missingFiles() == vector<std::filesystem::path>{"/music/kept.mp3"}));
+    CHECK(!topLevelRescan.needsRead("/music/kept.mp3", original));
+    CHECK(topLevelRescan.missingFiles().empty());
+    const std::filesystem::path unlisted{
+        std::filesystem::temp_directory_path() / "mysongplayer-core-rescan"};
+    std::filesystem::create_directories(unlisted / "album");
+    std::ofstream(unlisted / "album" / "present.mp3") << "x";
+    SongPlayer::Core::LibraryRescan unlistedRescan{unlisted, true, {
+        {unlisted / "album" / "present.mp3", original},
+        {unlisted / "album" / "gone.mp3", original},
+    }};
+    // The walk never reached the album (as if it could not be read): only the file
+    // that is really gone is reported.
+    CHECK((unlistedRescan.missingFiles() == vector<std::filesystem::path>{unlisted / "album" / "gone.mp3"}));
+    std::filesystem::remove_all(unlisted);
+
+    // 2x2 tiles of 4-byte pixels; the second tile only uses the top-left pixel.
+    const string firstPixels(2 * 2 * 4, 'a');
+    const string secondPixels(1 * 2 * 4, 'b');
+    const string replacedPixels(2 * 2 * 4, 'c');
+    const auto firstKey{SongPlayer::Core::thumbnailAtlasKey("00aa-10.jpg")};
+    const auto secondKey{SongPlayer::Core::thumbnailAtlasKey("00bb-20.png")};
+    CHECK(firstKey == SongPlayer::Core::thumbnailAtlasKey("00aa-10.png"));
+    const vector<SongPlayer::Core::ThumbnailTile> tiles{
+        {.key = secondKey, .width = 1, .height = 1, .pixels = secondPixels},
+        {.key = firstKey, .width = 2, .height = 2, .pixels = firstPixels},
+        {.key = firstKey, .width = 2, .height = 2, .pixels = replacedPixels},
+        {.key = 7, .width = 3, .height = 1, .pixels = replacedPixels},
+    };
+    std::ostringstream atlasStream;
+    CHECK(SongPlayer::Core::writeThumbnailAtlas(atlasStream, 2, tiles));
+    const string atlasBytes{atlasStream.str()};
+    const auto atlas{SongPlayer::Core::ThumbnailAtlasView::open(atlasBytes)};
+    CHECK(atlas && atlas->tileSize() == 2 && atlas->tileCount() == 2);
+    const auto firstTile{atlas->find(firstKey)};
+    CHECK(firstTile && firstTile->width == 2 && firstTile->pixels == replacedPixels);
+    CHECK((atlas->tileAt(0).pixels.data() - atlasBytes.data()) % 64 == 0);
+    const auto secondTile{atlas->find(secondKey)};
+    CHECK(secondTile && secondTile->height == 1 &&
+          secondTile->pixels == secondPixels + string(2 * 4, '\0'));
+    CHECK(!atlas->find(7));
+    CHECK(atlas->tileAt(0).key < atlas->tileAt(1).key);
+    CHECK(!SongPlayer::Core::ThumbnailAtlasView::open(atlasBytes.substr(0, atlasBytes.size() - 1)));
+    CHECK(!SongPlayer::Core::ThumbnailAtlasView::open("not an atlas"));
+    std::ostringstream emptyStream;
+    CHECK(SongPlayer::Core::writeThumbnailAtlas(emptyStream, 64, {}));
+    CHECK(!SongPlayer::Core::writeThumbnailAtlas(emptyStream, 0, {}));
+    const string emptyBytes{emptyStream.str()};
+    const auto emptyAtlas{SongPlayer::Core::ThumbnailAtlasView::open(emptyBytes)};
+    CHECK(emptyAtlas && emptyAtlas->tileCount() == 0 && !emptyAtlas->find(firstKey));
 
     return 0;
 }
@@ -1,13 +1,25 @@
 #include "core/AudioImport.h"
+#include "core/FileFingerprint.h"
 #include "services/AudioImporter.h"
+#include "services/CoverCacheManager.h"
+#include "services/LibraryWatcher.h"
 
+#include <QColor>
 #include <QCoreApplication>
+#include <QDir>
 #include <QElapsedTimer>
+#include <QFile>
 #include <QEventLoop>
+#include <QImage>
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <QTemporaryDir>
 #include <QThread>
 #include <QTimer>
 #include <QUrl>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <filesystem>
@@ -15,6 +27,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 
 namespace {
 
@@ -35,6 +48,9 @@ public:
             .artist = "Test Artist",
             .audioFile = request.audioFile,
             .coverFile = std::nullopt,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
         };
     }
 
@@ -48,6 +64,114 @@ private:
     mutable std::atomic_bool m_ranOutsideGuiThread = false;
 };
 
+// Earlier files take longer, so parallel readers finish in reverse selection order.
+class StaggeredMetadataReader final : public SongPlayer::Core::IAudioMetadataReader {
+public:
+    SongPlayer::Core::AudioImportResult read(
+        const SongPlayer::Core::AudioImportRequest& request) const noexcept override
+    {
+        const int running = m_running.fetch_add(1, std::memory_order_relaxed) + 1;
+        int observed = m_maxRunning.load(std::memory_order_relaxed);
+        while (running > observed &&
+               !m_maxRunning.compare_exchange_weak(observed, running, std::memory_order_relaxed)) {
+        }
+
+        const int position = std::stoi(request.audioFile.stem().string());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 * (8 - position)));
+        m_running.fetch_sub(1, std::memory_order_relaxed);
+        return SongPlayer::Core::ImportedAudio{
+            .title = request.audioFile.stem().string(),
+            .artist = "Test Artist",
+            .audioFile = request.audioFile,
+            .coverFile = std::nullopt,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
+        };
+    }
+
+    [[nodiscard]] int maxRunning() const noexcept
+    {
+        return m_maxRunning.load(std::memory_order_relaxed);
+    }
+
+private:
+    mutable std::atomic_int m_running = 0;
+    mutable std::atomic_int m_maxRunning = 0;
+};
+
+// Returns right away, so a large batch is bound by enumeration and delivery.
+class InstantMetadataReader final : public SongPlayer::Core::IAudioMetadataReader {
+public:
+    SongPlayer::Core::AudioImportResult read(
+        const SongPlayer::Core::AudioImportRequest& request) const noexcept override
+    {
+        return SongPlayer::Core::ImportedAudio{
+            .title = request.audioFile.stem().string(),
+            .artist = "Test Artist",
+            .audioFile = request.audioFile,
+            .coverFile = std::nullopt,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
+        };
+    }
+};
+
+// Reads "a" at once and holds every other file until opened.
+class GatedMetadataReader final : public SongPlayer::Core::IAudioMetadataReader {
+public:
+    SongPlayer::Core::AudioImportResult read(
+        const SongPlayer::Core::AudioImportRequest& request) const noexcept override
+    {
+        while (request.audioFile.stem() != "a" && !m_open.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return SongPlayer::Core::ImportedAudio{
+            .title = request.audioFile.stem().string(),
+            .artist = "Test Artist",
+            .audioFile = request.audioFile,
+            .coverFile = std::nullopt,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
+        };
+    }
+
+    void open() noexcept
+    {
+        m_open.store(true, std::memory_order_release);
+    }
+
+private:
+    mutable std::atomic<bool> m_open{false};
+};
+
+// Reports every file as having the same cached cover.
+class CoverMetadataReader final : public SongPlayer::Core::IAudioMetadataReader {
+public:
+    explicit CoverMetadataReader(std::filesystem::path coverFile)
+        : m_coverFile(std::move(coverFile))
+    {}
+
+    SongPlayer::Core::AudioImportResult read(
+        const SongPlayer::Core::AudioImportRequest& request) const noexcept override
+    {
+        return SongPlayer::Core::ImportedAudio{
+            .title = request.audioFile.stem().string(),
+            .artist = "Test Artist",
+            .audioFile = request.audioFile,
+            .coverFile = m_coverFile,
+            .embeddedLyrics = {},
+            .properties = {},
+            .fingerprint = std::nullopt,
+        };
+    }
+
+private:
+    std::filesystem::path m_coverFile;
+};
+
 int failures = 0;
 
 void expect(bool condition, const char* message)
@@ -79,30 +203,35 @@ void verifiesNonBlockingImport(QCoreApplication& application)
     bool timedOut = false;
     bool heartbeatObserved = false;
     bool callbackOnGuiThread = false;
-    bool rejectedConcurrentRequest = false;
+    int firstBatch = 0;
+    QList<int> finishedBatches;
     int imported = -1;
     int failed = -1;
     bool canceled = true;
 
     QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
-                     &application, [&](const QString&, const QString&, const QUrl&, const QUrl&) {
+                     &application, [&](const QList<SongPlayer::ImportedTrack>&) {
         callbackOnGuiThread = QThread::currentThread() == application.thread();
     });
-    QObject::connect(&importer, &SongPlayer::AudioImporter::importRejected,
-                     &application, [&](const QString&) { rejectedConcurrentRequest = true; });
     QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
-                     &application, [&](int importedCount, int failedCount, bool wasCanceled) {
-        imported = importedCount;
-        failed = failedCount;
-        canceled = wasCanceled;
-        loop.quit();
+                     &application, [&](int batchId, int importedCount, int failedCount, bool wasCanceled) {
+        finishedBatches.append(batchId);
+        if (batchId == firstBatch) {
+            imported = importedCount;
+            failed = failedCount;
+            canceled = wasCanceled;
+        }
+        if (!importer.importing()) {
+            loop.quit();
+        }
     });
 
     QElapsedTimer entryTimer;
     entryTimer.start();
-    importer.importLocalAudio({QUrl::fromLocalFile(QStringLiteral("/virtual/first.mp3"))});
+    firstBatch = importer.importLocalAudio({QUrl::fromLocalFile(QStringLiteral("/virtual/first.mp3"))});
     const qint64 entryDurationMs = entryTimer.elapsed();
-    importer.importLocalAudio({QUrl::fromLocalFile(QStringLiteral("/virtual/rejected.mp3"))});
+    const int secondBatch = importer.importLocalAudio({QUrl::fromLocalFile(QStringLiteral("/virtual/queued.mp3"))});
+    const bool queuedBehindFirst = importer.importBatchId() == firstBatch && importer.queuedImportCount() == 1;
     QTimer::singleShot(std::chrono::milliseconds(10), &application,
                        [&] { heartbeatObserved = true; });
 
@@ -113,17 +242,166 @@ void verifiesNonBlockingImport(QCoreApplication& application)
     expect(heartbeatObserved, "GUI event loop remains responsive while metadata is read");
     expect(reader->ranOutsideGuiThread(), "metadata reader runs outside the GUI thread");
     expect(callbackOnGuiThread, "Qt-facing result callback runs on the GUI thread");
-    expect(rejectedConcurrentRequest, "a concurrent batch is explicitly rejected");
+    expect(queuedBehindFirst && secondBatch > firstBatch, "a batch asked for while another runs is queued");
+    expect((finishedBatches == QList<int>{firstBatch, secondBatch}), "queued batches run in FIFO order");
     expect(imported == 1 && failed == 0 && !canceled,
            "successful batch reports a consistent summary");
     expect(importer.importCompleted() == 1 && importer.importTotal() == 1,
            "progress reaches the batch total");
 }
 
+void verifiesQueuedBatchesSkipFilesAlreadyRead(QCoreApplication& application)
+{
+    auto reader = std::make_shared<SlowMetadataReader>(application.thread());
+    SongPlayer::AudioImporter importer(reader);
+
+    QEventLoop loop;
+    bool timedOut = false;
+    QMap<int, int> startedTotals;
+    QList<int> finishedBatches;
+    QList<int> canceledBatches;
+    QStringList importedTitles;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importStarted,
+                     &application, [&](int batchId, int total) { startedTotals.insert(batchId, total); });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+        }
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int batchId, int, int, bool wasCanceled) {
+        finishedBatches.append(batchId);
+        if (wasCanceled) {
+            canceledBatches.append(batchId);
+        }
+        if (!importer.importing()) {
+            loop.quit();
+        }
+    });
+
+    const auto file = [](const char* name) {
+        return QUrl::fromLocalFile(QStringLiteral("/virtual/%1.mp3").arg(QLatin1String(name)));
+    };
+    const int first = importer.importLocalAudio({file("a"), file("b")});
+    const int overlapping = importer.importLocalAudio({file("b"), file("c")});
+    const int dropped = importer.importLocalAudio({file("d")});
+    importer.cancelImportBatch(dropped);
+    expect(importer.queuedImportCount() == 1 && importer.importing(),
+           "canceling a queued batch leaves the others queued");
+    waitForImport(loop, timedOut);
+
+    expect(!timedOut, "a queue of batches completes before timeout");
+    expect((finishedBatches == QList<int>{dropped, first, overlapping}),
+           "a canceled queued batch finishes at once and the rest in FIFO order");
+    expect(canceledBatches == QList<int>{dropped} && !startedTotals.contains(dropped),
+           "a batch canceled while queued never starts");
+    expect(startedTotals.value(overlapping) == 1, "a file read by an earlier batch is not counted again");
+    expect((importedTitles == QStringList{QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")}),
+           "every file of a queue run is read once");
+}
+
+void verifiesCanceledBatchReleasesUnreadFiles(QCoreApplication& application)
+{
+    auto reader = std::make_shared<SlowMetadataReader>(application.thread());
+    SongPlayer::AudioImporter importer(reader);
+    importer.setImportWorkerCount(1);
+
+    QEventLoop loop;
+    bool timedOut = false;
+    QMap<int, int> startedTotals;
+    QStringList importedTitles;
+    QStringList events;
+    int running = 0;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importStarted,
+                     &application, [&](int batchId, int total) {
+        startedTotals.insert(batchId, total);
+        events.append(QStringLiteral("started %1").arg(batchId));
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFailed,
+                     &application, [&](const QUrl&, const QString&) { events.append(QStringLiteral("failed")); });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+        }
+        importer.cancelImportBatch(running);
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int batchId, int, int, bool) {
+        events.append(QStringLiteral("finished %1").arg(batchId));
+        if (!importer.importing()) {
+            loop.quit();
+        }
+    });
+
+    const auto file = [](const char* name) {
+        return QUrl::fromLocalFile(QStringLiteral("/virtual/%1.mp3").arg(QLatin1String(name)));
+    };
+    running = importer.importLocalAudio({file("e"), file("f"), file("g")});
+    const int retried = importer.importLocalAudio({file("f"), file("g"), file("g")});
+    waitForImport(loop, timedOut);
+
+    expect(!timedOut, "a canceled batch and its follower complete before timeout");
+    expect(startedTotals.value(retried) == 3, "files a canceled batch never read are not claimed any more");
+    expect(importedTitles.contains(QStringLiteral("f")) && importedTitles.contains(QStringLiteral("g")),
+           "a later batch reads the files a canceled batch left unread");
+    const qsizetype failedAt = events.indexOf(QStringLiteral("failed"));
+    expect(failedAt > events.indexOf(QStringLiteral("started %1").arg(retried))
+               && failedAt < events.indexOf(QStringLiteral("finished %1").arg(retried)),
+           "invalid inputs are reported between the started and finished of their batch");
+}
+
+void verifiesCanceledBatchReleasesBufferedFiles(QCoreApplication& application)
+{
+    auto reader = std::make_shared<GatedMetadataReader>();
+    SongPlayer::AudioImporter importer(reader);
+    importer.setImportWorkerCount(1);
+
+    QEventLoop loop;
+    bool timedOut = false;
+    QMap<int, int> startedTotals;
+    QStringList importedTitles;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importStarted,
+                     &application, [&](int batchId, int total) { startedTotals.insert(batchId, total); });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+        }
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int, int, bool) {
+        if (!importer.importing()) {
+            loop.quit();
+        }
+    });
+
+    const auto file = [](const char* name) {
+        return QUrl::fromLocalFile(QStringLiteral("/virtual/%1.mp3").arg(QLatin1String(name)));
+    };
+    const int canceled = importer.importLocalAudio({file("a"), file("b"), file("c")});
+    const int retried = importer.importLocalAudio({file("a"), file("b"), file("c")});
+    // "a" is read while the GUI thread is blocked, so its result sits in the future
+    // without ever reaching the importer before the cancel.
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    importer.cancelImportBatch(canceled);
+    reader->open();
+    waitForImport(loop, timedOut);
+
+    expect(!timedOut, "a batch canceled with buffered results and its follower complete before timeout");
+    expect(startedTotals.value(retried) == 3,
+           "a result the canceled batch never delivered does not keep its file claimed");
+    expect(importedTitles.count(QStringLiteral("a")) == 1,
+           "a later batch reads the file whose result a canceled batch dropped");
+}
+
 void verifiesCooperativeCancellation(QCoreApplication& application)
 {
     auto reader = std::make_shared<SlowMetadataReader>(application.thread());
     SongPlayer::AudioImporter importer(reader);
+    // One reader, so every slow file arrives in a chunk of its own.
+    importer.setImportWorkerCount(1);
 
     QEventLoop loop;
     bool timedOut = false;
@@ -131,13 +409,15 @@ void verifiesCooperativeCancellation(QCoreApplication& application)
     int delivered = 0;
 
     QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
-                     &application, [&](const QString&, const QString&, const QUrl&, const QUrl&) {
-        if (++delivered == 1) {
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        const bool firstChunk = delivered == 0;
+        delivered += tracks.size();
+        if (firstChunk) {
             importer.cancelImport();
         }
     });
     QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
-                     &application, [&](int, int, bool wasCanceled) {
+                     &application, [&](int, int, int, bool wasCanceled) {
         canceled = wasCanceled;
         loop.quit();
     });
@@ -156,12 +436,335 @@ void verifiesCooperativeCancellation(QCoreApplication& application)
     expect(!importer.importing(), "importer leaves the busy state after cancellation");
 }
 
+void verifiesParallelImportKeepsSelectionOrder(QCoreApplication& application)
+{
+    auto reader = std::make_shared<StaggeredMetadataReader>();
+    SongPlayer::AudioImporter importer(reader);
+    importer.setImportWorkerCount(4);
+
+    QEventLoop loop;
+    bool timedOut = false;
+    QStringList importedTitles;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+        }
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int, int, bool) { loop.quit(); });
+
+    QList<QUrl> selection;
+    QStringList expectedTitles;
+    for (int position = 0; position < 8; ++position) {
+        selection.append(QUrl::fromLocalFile(QStringLiteral("/virtual/%1.mp3").arg(position)));
+        expectedTitles.append(QString::number(position));
+    }
+    importer.importLocalAudio(selection);
+    waitForImport(loop, timedOut);
+
+    expect(!timedOut, "parallel import completes before timeout");
+    expect(reader->maxRunning() > 1, "metadata is read by several workers at once");
+    expect(importedTitles == expectedTitles, "results reach the GUI in selection order");
+}
+
+void verifiesStreamingDirectoryImport(QCoreApplication& application)
+{
+    QTemporaryDir library;
+    const QDir root(library.path());
+    expect(root.mkpath(QStringLiteral("album/disc")), "library fixture directories are created");
+    QStringList expectedTitles;
+    for (int track = 0; track < 300; ++track) {
+        const QString name = QStringLiteral("%1.mp3").arg(track, 3, 10, QLatin1Char('0'));
+        QFile file(root.filePath(track < 200 ? QStringLiteral("album/") + name : QStringLiteral("album/disc/") + name));
+        expect(file.open(QIODevice::WriteOnly), "library fixture file is written");
+        expectedTitles.append(name.chopped(4));
+    }
+    QFile notAudio(root.filePath(QStringLiteral("album/cover.jpg")));
+    expect(notAudio.open(QIODevice::WriteOnly), "non-audio fixture file is written");
+
+    auto reader = std::make_shared<InstantMetadataReader>();
+    SongPlayer::AudioImporter importer(reader);
+    QEventLoop loop;
+    bool timedOut = false;
+    bool sawGrowingTotal = false;
+    QStringList importedTitles;
+    int chunks = 0;
+    qsizetype largestChunk = 0;
+    int imported = -1;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importProgressChanged, &application, [&] {
+        sawGrowingTotal = sawGrowingTotal || (!importer.importTotalKnown() && importer.importTotal() > 0);
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        ++chunks;
+        largestChunk = std::max(largestChunk, tracks.size());
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+        }
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int importedCount, int, bool) {
+        imported = importedCount;
+        loop.quit();
+    });
+
+    importer.importDirectory(QUrl::fromLocalFile(library.path()));
+    expect(importer.importing() && !importer.importTotalKnown(),
+           "a folder import starts before its total is known");
+    waitForImport(loop, timedOut);
+
+    expect(!timedOut, "folder import completes before timeout");
+    expect(sawGrowingTotal, "progress reports discovered files before the walk ends");
+    expect(imported == 300 && importedTitles == expectedTitles,
+           "folder import reads every audio file in name order, files before subfolders");
+    expect(importer.importTotalKnown() && importer.importTotal() == 300,
+           "the total is final once the import finishes");
+    expect(chunks > 1 && chunks < 300
+               && largestChunk <= static_cast<qsizetype>(SongPlayer::AudioImporter::kMaxChunkSize),
+           "results reach the GUI thread in bounded chunks rather than one by one");
+
+    imported = -1;
+    importer.importDirectory(QUrl::fromLocalFile(root.filePath(QStringLiteral("album/disc"))), false);
+    waitForImport(loop, timedOut);
+    expect(imported == 100, "a non-recursive folder import stays in the folder");
+
+    int failed = -1;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int, int failedCount, bool) { failed = failedCount; });
+    importer.importDirectory(QUrl::fromLocalFile(root.filePath(QStringLiteral("missing"))));
+    expect(failed == 1 && !importer.importing(), "a missing folder fails without starting a batch");
+}
+
+void verifiesRescanReadsOnlyChangedFiles(QCoreApplication& application)
+{
+    QTemporaryDir library;
+    const QDir root(library.path());
+    expect(root.mkpath(QStringLiteral("album")), "rescan fixture directory is created");
+    for (const QString name : {QStringLiteral("album/kept.mp3"), QStringLiteral("album/changed.mp3"),
+                               QStringLiteral("album/gone.mp3")}) {
+        QFile file(root.filePath(name));
+        expect(file.open(QIODevice::WriteOnly) && file.write("v1") == 2, "rescan fixture file is written");
+    }
+
+    auto reader = std::make_shared<InstantMetadataReader>();
+    SongPlayer::AudioImporter importer(reader);
+    QEventLoop loop;
+    bool timedOut = false;
+    QStringList importedTitles;
+    QStringList removedNames;
+    SongPlayer::Core::FileFingerprints recorded;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioImported,
+                     &application, [&](const QList<SongPlayer::ImportedTrack>& tracks) {
+        for (const SongPlayer::ImportedTrack& track : tracks) {
+            importedTitles.append(track.title);
+            if (track.fingerprint) {
+                recorded.emplace(track.audioSource.toLocalFile().toStdString(), *track.fingerprint);
+            }
+        }
+    });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::audioRemoved,
+                     &application, [&](const QUrl& source) { removedNames.append(source.fileName()); });
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int, int, bool) { loop.quit(); });
+
+    importer.importDirectory(QUrl::fromLocalFile(library.path()));
+    waitForImport(loop, timedOut);
+    expect(!timedOut && importedTitles.size() == 3 && recorded.size() == 3,
+           "a first folder import reads and fingerprints every file");
+
+    QFile changed(root.filePath(QStringLiteral("album/changed.mp3")));
+    expect(changed.open(QIODevice::Append) && changed.write("v2") == 2, "changed fixture file grows");
+    changed.close();
+    expect(QFile::remove(root.filePath(QStringLiteral("album/gone.mp3"))), "gone fixture file is deleted");
+    QFile added(root.filePath(QStringLiteral("album/added.mp3")));
+    expect(added.open(QIODevice::WriteOnly), "added fixture file is written");
+    added.close();
+
+    importedTitles.clear();
+    std::atomic<QThread*> recordedReadOn{nullptr};
+    importer.rescanDirectory(QUrl::fromLocalFile(library.path()), true, [&recorded, &recordedReadOn] {
+        recordedReadOn = QThread::currentThread();
+        return recorded;
+    });
+    waitForImport(loop, timedOut);
+    expect(!timedOut, "rescan completes before timeout");
+    expect(recordedReadOn != nullptr && recordedReadOn != application.thread(),
+           "the recorded fingerprints are read on the feeding task");
+    expect((importedTitles == QStringList{QStringLiteral("added"), QStringLiteral("changed")}),
+           "a rescan only reads new and changed files");
+    expect(removedNames == QStringList{QStringLiteral("gone.mp3")}, "a rescan reports files that are gone");
+    expect(importer.importTotal() == 2, "unchanged files do not count towards the rescan total");
+}
+
+void verifiesLibraryWatcherSettlesBursts(QCoreApplication& application)
+{
+    QTemporaryDir library;
+    const QDir root(library.path());
+    expect(root.mkpath(QStringLiteral("album")), "watched fixture directory is created");
+
+    SongPlayer::LibraryWatcher watcher;
+    watcher.setSettleDelay(std::chrono::milliseconds(100));
+    QList<QPair<QString, bool>> rescans;
+    QObject::connect(&watcher, &SongPlayer::LibraryWatcher::rescanRequested, &application,
+                     [&](const QUrl& directory, bool recursive) {
+        rescans.append({QDir(library.path()).relativeFilePath(directory.toLocalFile()), recursive});
+    });
+    const auto waitUntil = [&](const auto& condition) {
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while (!condition() && elapsed.elapsed() < 3000) {
+            application.processEvents(QEventLoop::AllEvents, 20);
+        }
+    };
+
+    watcher.watchFolder(QUrl::fromLocalFile(library.path()));
+    waitUntil([&] { return watcher.watchedDirectoryCount() == 2; });
+    expect(watcher.watchedDirectoryCount() == 2, "the folder and its subdirectory are watched");
+
+    for (int track = 0; track < 20; ++track) {
+        QFile file(root.filePath(QStringLiteral("album/%1.mp3").arg(track)));
+        expect(file.open(QIODevice::WriteOnly), "copied fixture file is written");
+    }
+    waitUntil([&] { return !rescans.isEmpty(); });
+    application.processEvents(QEventLoop::AllEvents, 300);
+    expect((rescans == QList<QPair<QString, bool>>{{QStringLiteral("album"), false}}),
+           "a burst of new files becomes one rescan of their directory");
+
+    rescans.clear();
+    expect(root.mkpath(QStringLiteral("single/cd")), "a new subtree is created");
+    waitUntil([&] { return watcher.watchedDirectoryCount() == 4; });
+    expect(rescans.contains({QStringLiteral("single"), true}), "a new subdirectory is rescanned as a whole");
+    expect(watcher.watchedDirectoryCount() == 4, "a new subtree is watched as well");
+
+    rescans.clear();
+    const QPair<QString, bool> parentRescan{root.relativeFilePath(library.path()), true};
+    expect(QDir(root.filePath(QStringLiteral("album"))).removeRecursively(), "watched directory is deleted");
+    waitUntil([&] { return rescans.contains(parentRescan); });
+    expect(rescans.count(parentRescan) == 1, "a deleted directory becomes one rescan of its parent");
+    expect(!watcher.isPolled(QUrl::fromLocalFile(library.path())), "a watched folder is not polled");
+
+    watcher.unwatchFolder(QUrl::fromLocalFile(library.path()));
+    expect(watcher.watchedDirectoryCount() == 0, "an unwatched folder leaves no watches behind");
+
+    // A folder on a drive that is not mounted yet is polled until it shows up.
+    const QString unmounted{root.filePath(QStringLiteral("drive"))};
+    watcher.setPollInterval(std::chrono::milliseconds(50));
+    watcher.watchFolder(QUrl::fromLocalFile(unmounted));
+    waitUntil([&] { return watcher.isPolled(QUrl::fromLocalFile(unmounted)); });
+    expect(watcher.isPolled(QUrl::fromLocalFile(unmounted)), "a missing folder is polled");
+    expect(root.mkpath(QStringLiteral("drive/album")), "the polled folder appears");
+    waitUntil([&] { return watcher.watchedDirectoryCount() == 2; });
+    expect(!watcher.isPolled(QUrl::fromLocalFile(unmounted)) && watcher.watchedDirectoryCount() == 2,
+           "a polled folder that exists again is watched again");
+}
+
+void verifiesCoverThumbnailsAreWritten(QCoreApplication& application)
+{
+    QTemporaryDir cache;
+    const QDir coverDirectory(cache.filePath(QStringLiteral("covers")));
+    expect(coverDirectory.mkpath(QStringLiteral(".")), "cover cache directory is created");
+    const QString coverPath = coverDirectory.filePath(QStringLiteral("0123abcd-42.png"));
+    QImage cover(1200, 800, QImage::Format_ARGB32);
+    cover.fill(QColor(0, 139, 139, 128));
+    expect(cover.save(coverPath), "full-size cover fixture is written");
+
+    auto reader = std::make_shared<CoverMetadataReader>(coverPath.toStdString());
+    SongPlayer::AudioImporter importer(reader);
+    QEventLoop loop;
+    bool timedOut = false;
+    QObject::connect(&importer, &SongPlayer::AudioImporter::importFinished,
+                     &application, [&](int, int, int, bool) { loop.quit(); });
+    importer.importLocalAudio({
+        QUrl::fromLocalFile(QStringLiteral("/virtual/album-1.mp3")),
+        QUrl::fromLocalFile(QStringLiteral("/virtual/album-2.mp3")),
+    });
+    waitForImport(loop, timedOut);
+    expect(!timedOut, "import with covers completes before timeout");
+
+    const QImage listThumbnail(coverDirectory.filePath(QStringLiteral("thumbnails/0123abcd-42@64.png")));
+    const QImage detailThumbnail(coverDirectory.filePath(QStringLiteral("thumbnails/0123abcd-42@256.png")));
+    expect(listThumbnail.width() == 64 && listThumbnail.height() < 64,
+           "a list thumbnail keeps the aspect ratio within 64px");
+    expect(detailThumbnail.width() == 256, "a detail thumbnail is written at 256px");
+    expect(listThumbnail.hasAlphaChannel() && qAlpha(listThumbnail.pixel(0, 0)) < 255,
+           "the thumbnail of a PNG cover keeps its transparency");
+}
+
+void verifiesCoverCacheCollectsWhenIdle(QCoreApplication& application)
+{
+    QTemporaryDir cache;
+    const QDir coverDirectory(cache.filePath(QStringLiteral("covers")));
+    expect(coverDirectory.mkpath(QStringLiteral("thumbnails")), "cover cache directory is created");
+    for (const QString& name : {QStringLiteral("kept.jpg"), QStringLiteral("thumbnails/kept@64.jpg"),
+                                QStringLiteral("orphan.jpg"), QStringLiteral("thumbnails/orphan@64.jpg")}) {
+        QFile file(coverDirectory.filePath(name));
+        expect(file.open(QIODevice::WriteOnly) && file.write("cover") == 5, "cached cover fixture is written");
+    }
+
+    SongPlayer::CoverCacheManager manager(coverDirectory.absolutePath().toStdString());
+    manager.setIdleDelay(std::chrono::milliseconds(20));
+    manager.setOrphanGracePeriod(std::chrono::milliseconds(0));
+    int dueCount = 0;
+    int removedCovers = -1;
+    qint64 freedBytes = 0;
+    QObject::connect(&manager, &SongPlayer::CoverCacheManager::collectionDue, &application, [&] {
+        ++dueCount;
+        manager.collect({QUrl::fromLocalFile(coverDirectory.filePath(QStringLiteral("kept.jpg"))),
+                         QUrl(QStringLiteral("qrc:/qt/qml/MySongPlayer/assets/icons/app_icon.png"))});
+    });
+    QObject::connect(&manager, &SongPlayer::CoverCacheManager::collected, &application,
+                     [&](int removed, qint64 freed) {
+        removedCovers = removed;
+        freedBytes = freed;
+    });
+    const auto waitUntil = [&](const auto& condition, int timeoutMs) {
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while (!condition() && elapsed.elapsed() < timeoutMs) {
+            application.processEvents(QEventLoop::AllEvents, 10);
+        }
+    };
+
+    manager.setBusy(true);
+    manager.scheduleCollection();
+    waitUntil([] { return false; }, 100);
+    expect(dueCount == 0, "no collection is due while an import runs");
+
+    manager.setBusy(false);
+    waitUntil([&] { return removedCovers >= 0; }, 3000);
+    expect(dueCount == 1, "becoming idle makes one collection due");
+    expect(removedCovers == 1 && freedBytes == 10, "the unreferenced cover is collected with its thumbnail");
+    expect(!coverDirectory.exists(QStringLiteral("orphan.jpg"))
+               && !coverDirectory.exists(QStringLiteral("thumbnails/orphan@64.jpg")),
+           "the collected files are gone");
+    expect(coverDirectory.exists(QStringLiteral("kept.jpg"))
+               && coverDirectory.exists(QStringLiteral("thumbnails/kept@64.jpg")),
+           "a referenced cover and its thumbnail are kept");
+
+    removedCovers = -1;
+    manager.setMaxBytes(0);
+    waitUntil([&] { return removedCovers >= 0; }, 3000);
+    expect(removedCovers == 0 && coverDirectory.exists(QStringLiteral("kept.jpg"))
+               && coverDirectory.exists(QStringLiteral("thumbnails/kept@64.jpg")),
+           "lowering the cap never evicts a referenced cover");
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
 {
     QCoreApplication application(argc, argv);
     verifiesNonBlockingImport(application);
+    verifiesQueuedBatchesSkipFilesAlreadyRead(application);
+    verifiesCanceledBatchReleasesUnreadFiles(application);
+    verifiesCanceledBatchReleasesBufferedFiles(application);
     verifiesCooperativeCancellation(application);
+    verifiesParallelImportKeepsSelectionOrder(application);
+    verifiesStreamingDirectoryImport(application);
+    verifiesRescanReadsOnlyChangedFiles(application);
+    verifiesLibraryWatcherSettlesBursts(application);
+    verifiesCoverThumbnailsAreWritten(application);
+    verifiesCoverCacheCollectsWhenIdle(application);
     return failures == 0 ? 0 : 1;
 }
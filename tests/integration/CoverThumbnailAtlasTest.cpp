@@ -0,0 +1,133 @@
+#include "services/CoverThumbnailAtlas.h"
+
+#include <QColor>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* message)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << message << '\n';
+        ++failures;
+    }
+}
+
+bool writeThumbnail(const QDir& coverDirectory, const QString& name, const QColor& color)
+{
+    QImage thumbnail(64, 40, QImage::Format_RGB32);
+    thumbnail.fill(color);
+    return thumbnail.save(coverDirectory.filePath(QStringLiteral("thumbnails/") + name));
+}
+
+QByteArray fileHash(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha256);
+}
+
+bool matches(const QImage& image, const QColor& color)
+{
+    const QColor pixel = image.pixelColor(32, 20);
+    return qAbs(pixel.red() - color.red()) < 16 && qAbs(pixel.green() - color.green()) < 16
+        && qAbs(pixel.blue() - color.blue()) < 16;
+}
+
+void verifiesAtlasServesListThumbnails()
+{
+    QTemporaryDir cache;
+    const QDir coverDirectory(cache.filePath(QStringLiteral("covers")));
+    expect(coverDirectory.mkpath(QStringLiteral("thumbnails")), "thumbnail directory is created");
+    expect(writeThumbnail(coverDirectory, QStringLiteral("89abcdef-7@64.jpg"), Qt::darkCyan),
+           "list thumbnail fixture is written");
+
+    const std::filesystem::path coverCache = coverDirectory.absolutePath().toStdString();
+    const QString coverId = QStringLiteral("89abcdef-7.jpg");
+    {
+        SongPlayer::CoverThumbnailAtlas atlas(coverCache);
+        QSize size;
+        expect(atlas.requestImage(coverId, &size, {}).width() == 64 && size == QSize(64, 40),
+               "a cover missing from the atlas is served from its thumbnail file");
+        atlas.rebuild().waitForFinished();
+        expect(QFile::exists(coverDirectory.filePath(QStringLiteral("thumbnail-atlas.bin"))),
+               "the rebuild writes the atlas into the cover cache");
+    }
+
+    expect(QFile::remove(coverDirectory.filePath(QStringLiteral("thumbnails/89abcdef-7@64.jpg"))),
+           "thumbnail fixture is removed");
+    SongPlayer::CoverThumbnailAtlas atlas(coverCache);
+    const QImage packed = atlas.requestImage(coverId, nullptr, {});
+    expect(packed.size() == QSize(64, 40), "the mapped atlas serves the tile at its own size");
+    expect(matches(packed, Qt::darkCyan), "tile pixels match the decoded thumbnail");
+    expect(atlas.requestImage(QStringLiteral("../89abcdef-7.jpg"), nullptr, {}).isNull(),
+           "ids outside the cover cache are rejected");
+}
+
+void verifiesNewTilesAreAppended()
+{
+    QTemporaryDir cache;
+    const QDir coverDirectory(cache.filePath(QStringLiteral("covers")));
+    expect(coverDirectory.mkpath(QStringLiteral("thumbnails")), "thumbnail directory is created");
+    expect(writeThumbnail(coverDirectory, QStringLiteral("first@64.jpg"), Qt::darkCyan),
+           "first thumbnail fixture is written");
+
+    const QString basePath = coverDirectory.filePath(QStringLiteral("thumbnail-atlas.bin"));
+    const QString deltaPath = coverDirectory.filePath(QStringLiteral("thumbnail-atlas.bin.1"));
+    const std::filesystem::path coverCache = coverDirectory.absolutePath().toStdString();
+    {
+        SongPlayer::CoverThumbnailAtlas atlas(coverCache);
+        atlas.rebuild().waitForFinished();
+        const QByteArray baseHash = fileHash(basePath);
+        expect(!baseHash.isEmpty(), "the first rebuild writes the base atlas");
+
+        expect(writeThumbnail(coverDirectory, QStringLiteral("second@64.png"), Qt::darkMagenta),
+               "second thumbnail fixture is written");
+        atlas.rebuild().waitForFinished();
+        expect(QFile::exists(deltaPath), "a later burst of misses is appended as a delta");
+        expect(fileHash(basePath) == baseHash, "appending new tiles leaves the base atlas untouched");
+        expect(matches(atlas.requestImage(QStringLiteral("second.png"), nullptr, {}), Qt::darkMagenta),
+               "the delta serves requests once the rebuild finishes");
+    }
+
+    {
+        SongPlayer::CoverThumbnailAtlas atlas(coverCache);
+        atlas.rebuild().waitForFinished();
+        expect(QFile::exists(deltaPath), "a rebuild with nothing new or gone keeps the delta");
+
+        expect(QFile::remove(coverDirectory.filePath(QStringLiteral("thumbnails/first@64.jpg"))),
+               "first thumbnail fixture is removed");
+        atlas.rebuild().waitForFinished();
+        expect(!QFile::exists(deltaPath), "dropping a stale tile merges the deltas into the base");
+        expect(atlas.requestImage(QStringLiteral("first.jpg"), nullptr, {}).isNull(),
+               "the stale tile is no longer served");
+    }
+
+    expect(QFile::remove(coverDirectory.filePath(QStringLiteral("thumbnails/second@64.png"))),
+           "second thumbnail fixture is removed");
+    SongPlayer::CoverThumbnailAtlas atlas(coverCache);
+    expect(matches(atlas.requestImage(QStringLiteral("second.png"), nullptr, {}), Qt::darkMagenta),
+           "the merged base keeps the tiles that were in the delta");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application(argc, argv);
+    verifiesAtlasServesListThumbnails();
+    verifiesNewTilesAreAppended();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include "core/Lyrics.h"
+#include "models/LyricsModel.h"
+
+#include <QCoreApplication>
+#include <QList>
+#include <QModelIndex>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::cerr;
+
+namespace {
+
+int failures{};
+
+void expect(bool condition, const char *message)
+{
+    if (condition) {
+        return;
+    }
+    cerr << "FAILED: " << message << '\n';
+    ++failures;
+}
+
+void verifiesLyricLineChangeTouchesTwoRows()
+{
+    LyricsModel model;
+    std::vector<SongPlayer::Core::LyricLine> lyrics;
+    for (int line = 0; line < 50; ++line) {
+        lyrics.push_back(SongPlayer::Core::LyricLine{
+            .timestampMs = line * 1000,
+            .text = "Line " + std::to_string(line),
+        });
+    }
+    model.setLyrics(std::move(lyrics));
+    expect(model.rowCount() == 50, "every lyric line becomes a model row");
+    expect(model.data(model.index(3, 0), LyricsModel::LyricTextRole).toString() == QStringLiteral("Line 3"),
+           "lyric text role exposes the line text");
+
+    model.updatePosition(10500);
+    QList<int> changedRows;
+    bool onlyCurrentRole{true};
+    QObject::connect(&model, &QAbstractItemModel::dataChanged,
+                     [&](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles) {
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            changedRows.append(row);
+        }
+        onlyCurrentRole = onlyCurrentRole && roles == QList<int>{LyricsModel::LyricIsCurrentRole};
+    });
+
+    model.updatePosition(11500);
+    expect(changedRows == QList<int>({10, 11}), "a line change only refreshes the old and new current rows");
+    expect(onlyCurrentRole, "a line change only refreshes the isCurrent role");
+    expect(model.data(model.index(11, 0), LyricsModel::LyricIsCurrentRole).toBool() &&
+               !model.data(model.index(10, 0), LyricsModel::LyricIsCurrentRole).toBool(),
+           "isCurrent follows the playback position");
+
+    changedRows.clear();
+    model.updatePosition(11900);
+    expect(changedRows.isEmpty(), "a position inside the current line emits nothing");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application{argc, argv};
+    verifiesLyricLineChangeTouchesTwoRows();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include "services/LyricsService.h"
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFile>
+#include <QFuture>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <iostream>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* message)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << message << '\n';
+        ++failures;
+    }
+}
+
+bool writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+std::vector<SongPlayer::Core::LyricLine> waitForLyrics(QFuture<std::vector<SongPlayer::Core::LyricLine>> future)
+{
+    future.waitForFinished();
+    return future.resultCount() > 0 ? future.result() : std::vector<SongPlayer::Core::LyricLine>{};
+}
+
+void verifiesAsynchronousLookup(const QDir& library)
+{
+    LyricsService service;
+
+    expect(writeFile(library.filePath(QStringLiteral("Exact Song.mp3")), "audio"),
+           "exact-match audio fixture is written");
+    expect(writeFile(library.filePath(QStringLiteral("Exact Song.lrc")),
+                     "[00:01.00]First\n[00:02.50]Second\n"),
+           "exact-match LRC fixture is written");
+    expect(writeFile(library.filePath(QStringLiteral("Morning Light.flac")), "audio"),
+           "fuzzy-match audio fixture is written");
+    expect(writeFile(library.filePath(QStringLiteral("Morning Light (Lyrics).lrc")),
+                     "[00:03.00]Dawn\n"),
+           "fuzzy-match LRC fixture is written");
+    expect(writeFile(library.filePath(QStringLiteral("Tagged.mp3")), "audio"),
+           "embedded-lyrics audio fixture is written");
+
+    const auto exact = waitForLyrics(service.loadLyrics(library.filePath(QStringLiteral("Exact Song.mp3"))));
+    expect(exact.size() == 2 && exact[1].timestampMs == 2500, "exact sidecar LRC is parsed");
+
+    const auto cached = waitForLyrics(service.loadLyrics(library.filePath(QStringLiteral("Exact Song.mp3"))));
+    expect(cached.size() == 2 && cached[0].text == "First", "second lookup is served from the lyric cache");
+
+    const auto fuzzy = waitForLyrics(service.loadLyrics(library.filePath(QStringLiteral("Morning Light.flac"))));
+    expect(fuzzy.size() == 1 && fuzzy[0].text == "Dawn", "fuzzy LRC match is found on the worker");
+
+    const QString taggedAudio = library.filePath(QStringLiteral("Tagged.mp3"));
+    service.storeEmbeddedLyrics(taggedAudio, QStringLiteral("[00:04.00]Embedded")).waitForFinished();
+    const auto embedded = waitForLyrics(service.loadLyrics(taggedAudio));
+    expect(embedded.size() == 1 && embedded[0].timestampMs == 4000,
+           "embedded lyrics stored at import are found without a sidecar");
+
+    const auto missing = waitForLyrics(service.loadLyrics(library.filePath(QStringLiteral("Nothing.mp3"))));
+    expect(missing.empty(), "an audio file without lyrics yields an empty result");
+}
+
+void verifiesCanceledLookupDeliversNothing(const QDir& library)
+{
+    LyricsService service;
+
+    // Skipping through many tracks cancels every lookup but the last one.
+    std::vector<QFuture<std::vector<SongPlayer::Core::LyricLine>>> skipped;
+    for (int index = 0; index < 16; ++index) {
+        QFuture<std::vector<SongPlayer::Core::LyricLine>> future =
+            service.loadLyrics(library.filePath(QStringLiteral("Exact Song.mp3")));
+        future.cancel();
+        skipped.push_back(future);
+    }
+    const auto current = waitForLyrics(service.loadLyrics(library.filePath(QStringLiteral("Morning Light.flac"))));
+
+    bool anySkippedDelivered = false;
+    for (QFuture<std::vector<SongPlayer::Core::LyricLine>>& future : skipped) {
+        future.waitForFinished();
+        anySkippedDelivered = anySkippedDelivered || future.resultCount() > 0;
+    }
+    expect(!anySkippedDelivered, "canceled lookups never deliver a result");
+    expect(current.size() == 1 && current[0].text == "Dawn", "the latest lookup still completes");
+}
+
+void verifiesPrefetchedLookupIsHandedOver(const QDir& library)
+{
+    LyricsService service;
+    const QString upcoming = library.filePath(QStringLiteral("Exact Song.mp3"));
+
+    service.prefetchLyrics(upcoming);
+    service.prefetchLyrics(upcoming);
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> handedOver = service.loadLyrics(upcoming);
+    handedOver.waitForFinished();
+    expect(handedOver.resultCount() == 1 && handedOver.result().size() == 2,
+           "a prefetched lookup is handed over with its result");
+
+    // Filling the cache past its capacity cancels the oldest prefetch; asking for it
+    // afterwards must fall back to a fresh lookup instead of a dead future.
+    const QString evicted = library.filePath(QStringLiteral("Morning Light.flac"));
+    service.prefetchLyrics(evicted);
+    for (int index = 0; index < 8; ++index) {
+        service.prefetchLyrics(library.filePath(QStringLiteral("Filler %1.mp3").arg(index)));
+    }
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> lookedUpAgain = service.loadLyrics(evicted);
+    lookedUpAgain.waitForFinished();
+    expect(lookedUpAgain.resultCount() == 1 && lookedUpAgain.result().size() == 1,
+           "an entry evicted from the prefetch cache is looked up again");
+}
+
+void verifiesNewLrcFileIsIndexedWithoutExpiry(const QDir& library)
+{
+    LyricsService service;
+    const QDir album(library.filePath(QStringLiteral("album")));
+    expect(library.mkpath(QStringLiteral("album")), "watched album directory is created");
+    const QString audio = album.filePath(QStringLiteral("Quiet Song.ogg"));
+    expect(writeFile(audio, "audio"), "audio fixture without lyrics is written");
+
+    expect(waitForLyrics(service.loadLyrics(audio)).empty(), "no lyrics before the LRC file exists");
+
+    // Let the index register its watch, then drop in a matching LRC file. It must
+    // become visible well before the old 30 second expiry.
+    QCoreApplication::processEvents();
+    QThread::msleep(50);
+    QCoreApplication::processEvents();
+    expect(writeFile(album.filePath(QStringLiteral("01 - Quiet Song.lrc")), "[00:05.00]Hush\n"),
+           "late LRC file is written");
+
+    std::vector<SongPlayer::Core::LyricLine> found;
+    const QDeadlineTimer deadline(3000);
+    while (found.empty() && !deadline.hasExpired()) {
+        QCoreApplication::processEvents();
+        found = waitForLyrics(service.loadLyrics(audio));
+        QThread::msleep(20);
+    }
+    expect(found.size() == 1 && found[0].text == "Hush",
+           "an LRC file added to a watched directory is found after the change event");
+}
+
+void verifiesLibraryAssociationsResolveOnce(const QDir& library)
+{
+    LyricsService service;
+    const QString exactAudio = library.filePath(QStringLiteral("Exact Song.mp3"));
+    const QString fuzzyAudio = library.filePath(QStringLiteral("Morning Light.flac"));
+    const QString bareAudio = library.filePath(QStringLiteral("Tagged.mp3"));
+
+    QFuture<std::vector<LyricsService::LyricAssociationEntry>> firstPass = service.resolveLyricAssociations({
+        {.audioFilePath = exactAudio, .association = std::nullopt},
+        {.audioFilePath = fuzzyAudio, .association = std::nullopt},
+        {.audioFilePath = bareAudio, .association = std::nullopt},
+    });
+    firstPass.waitForFinished();
+    const std::vector<LyricsService::LyricAssociationEntry> resolved = firstPass.result();
+    expect(resolved.size() == 3, "every unresolved track gets an association");
+    if (resolved.size() != 3) {
+        return;
+    }
+    expect(resolved[0].association && resolved[0].association->exactMatch,
+           "a same-name LRC is recorded as an exact match");
+    expect(resolved[1].association && resolved[1].association->lrcFile &&
+               !resolved[1].association->exactMatch,
+           "a fuzzy LRC match is recorded with its fingerprint");
+    expect(resolved[2].association && !resolved[2].association->lrcFile,
+           "a track without a sidecar is recorded as having none");
+
+    QFuture<std::vector<LyricsService::LyricAssociationEntry>> secondPass =
+        service.resolveLyricAssociations(resolved);
+    secondPass.waitForFinished();
+    expect(secondPass.result().empty(), "unchanged files are not resolved again");
+
+    const auto associated = waitForLyrics(service.loadLyrics(fuzzyAudio, resolved[1].association));
+    expect(associated.size() == 1 && associated[0].text == "Dawn",
+           "a current association loads its LRC directly");
+}
+
+void verifiesLyricTextIsCollectedOnce(const QDir& library)
+{
+    LyricsService service;
+
+    QFuture<std::vector<LyricsService::LyricTextEntry>> firstPass = service.collectLyricText({
+        {.audioFilePath = library.filePath(QStringLiteral("Exact Song.mp3")),
+         .association = std::nullopt, .indexed = false, .source = std::nullopt, .lyrics = {}},
+        {.audioFilePath = library.filePath(QStringLiteral("Nothing.mp3")),
+         .association = std::nullopt, .indexed = false, .source = std::nullopt, .lyrics = {}},
+    });
+    firstPass.waitForFinished();
+    const std::vector<LyricsService::LyricTextEntry> collected = firstPass.result();
+    expect(collected.size() == 2, "every unindexed track is collected");
+    if (collected.size() != 2) {
+        return;
+    }
+    expect(collected[0].source && collected[0].lyrics.size() == 2,
+           "collected lyrics carry their source fingerprint");
+    expect(collected[1].indexed && !collected[1].source && collected[1].lyrics.empty(),
+           "a track without lyrics is collected as indexed without a source");
+
+    QFuture<std::vector<LyricsService::LyricTextEntry>> secondPass = service.collectLyricText(collected);
+    secondPass.waitForFinished();
+    expect(secondPass.result().empty(), "tracks whose lyric source is unchanged are not collected again");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QTemporaryDir library;
+    expect(library.isValid(), "temporary library directory is created");
+    const QDir libraryDir(library.path());
+
+    verifiesAsynchronousLookup(libraryDir);
+    verifiesCanceledLookupDeliversNothing(libraryDir);
+    verifiesPrefetchedLookupIsHandedOver(libraryDir);
+    verifiesLibraryAssociationsResolveOnce(libraryDir);
+    verifiesLyricTextIsCollectedOnce(libraryDir);
+    verifiesNewLrcFileIsIndexedWithoutExpiry(libraryDir);
+    return failures == 0 ? 0 : 1;
+}
@@ -1,3 +1,4 @@
+#include "adapters/QtAudioTrackAdapter.h"
 #include "coordinators/PlaylistCoordinator.h"
 #include "models/AudioInfo.h"
 #include "models/PlaylistModel.h"
@@ -6,9 +7,13 @@
 
 #include <QCoreApplication>
 #include <QUrl>
+#include <QVariantMap>
 
 #include <iostream>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 using std::cerr;
 using std::nullopt;
@@ -65,6 +70,66 @@ void verifiesInsertionAndSingleSourceSignal()
     expect(sourceChanges == 3, "duplicate insertion does not reload or switch audio");
 }
 
+void verifiesRetaggingKeepsTheRow()
+{
+    PlaylistModel model;
+    expect(addTrack(model, QStringLiteral("one")), "first retag fixture track is inserted");
+    expect(addTrack(model, QStringLiteral("two")), "second retag fixture track is inserted");
+    int changedRow{-1};
+    QObject::connect(&model, &PlaylistModel::dataChanged, &model,
+                     [&](const QModelIndex &topLeft, const QModelIndex &) { changedRow = topLeft.row(); });
+
+    expect(model.indexOfAudio(sourceFor(QStringLiteral("two"))) == 1, "a source maps to its row");
+    expect(model.indexOfAudio(sourceFor(QStringLiteral("three"))) == -1, "an unknown source has no row");
+    int totalChanges{0};
+    QObject::connect(&model, &PlaylistModel::totalDurationChanged, &model, [&] { ++totalChanges; });
+    const SongPlayer::Core::AudioProperties live{
+        .durationMs = 245'000,
+        .bitrateKbps = 320,
+        .sampleRateHz = 44'100,
+        .channels = 2,
+    };
+    expect(model.updateAudio(QStringLiteral("Two (Live)"), QStringLiteral("Band"),
+                             sourceFor(QStringLiteral("two")), {}, live),
+           "an existing entry is retagged");
+    expect(changedRow == 1 && model.rowCount() == 2, "retagging changes the row in place");
+    expect(model.getAudioInfoAtIndex(1)->title() == QStringLiteral("Two (Live)"), "the new title is shown");
+    expect(model.data(model.index(1), PlaylistModel::AudioDurationRole).toLongLong() == 245'000
+               && model.data(model.index(1), PlaylistModel::AudioBitrateRole).toInt() == 320,
+           "the audio properties are exposed as roles");
+    expect(totalChanges == 1 && model.totalDurationMs() == 245'000, "the playlist total follows the durations");
+    expect(!model.updateAudio(QStringLiteral("Three"), {}, sourceFor(QStringLiteral("three")), {}, {}),
+           "retagging a missing entry reports failure");
+}
+
+void verifiesChunkInsertion()
+{
+    PlaylistModel model;
+    expect(addTrack(model, QStringLiteral("one")), "chunk fixture track is inserted");
+    int insertions{0};
+    int firstRow{-1};
+    int lastRow{-1};
+    int skipped{0};
+    QObject::connect(&model, &PlaylistModel::rowsInserted, &model,
+                     [&](const QModelIndex &, int first, int last) {
+        ++insertions;
+        firstRow = first;
+        lastRow = last;
+    });
+    QObject::connect(&model, &PlaylistModel::duplicateAudioSkipped, &model,
+                     [&](const QString &, const QString &) { ++skipped; });
+
+    std::vector<SongPlayer::Core::AudioTrack> chunk;
+    for (const QString name : {QStringLiteral("two"), QStringLiteral("one"), QStringLiteral("three"),
+                               QStringLiteral("two")}) {
+        chunk.push_back(SongPlayer::QtAdapter::makeCoreTrack(name, QStringLiteral("Artist"), sourceFor(name), {}));
+    }
+    expect(model.addTracks(chunk) == 2, "a chunk adds only the tracks that are not in the playlist yet");
+    expect(insertions == 1 && firstRow == 1 && lastRow == 2, "a chunk is announced as one row insertion");
+    expect(skipped == 2, "duplicates within the playlist and within the chunk are reported");
+    expect(model.getAudioInfoAtIndex(2)->title() == QStringLiteral("three"), "a chunk keeps its order");
+}
+
 void verifiesRemovalBehavior()
 {
     {
@@ -163,6 +228,38 @@ void verifiesLocalSearchPreservesZeroIndex()
            "local search preserves original index zero");
 }
 
+void verifiesLyricsSearchMapsMatchesToPlaylistRows()
+{
+    PlaylistSearchModel searchModel;
+    AudioInfo first;
+    first.setTitle(QStringLiteral("First"));
+    first.setAudioSource(sourceFor(QStringLiteral("first")));
+    AudioInfo second;
+    second.setTitle(QStringLiteral("Second"));
+    second.setAudioSource(sourceFor(QStringLiteral("second")));
+    const QVariantList tracks{QVariant::fromValue<QObject *>(&first),
+                              QVariant::fromValue<QObject *>(&second)};
+
+    const QVariantList matches{
+        QVariantMap{{QStringLiteral("audioSource"), sourceFor(QStringLiteral("second"))},
+                    {QStringLiteral("timestampMs"), qint64{42000}},
+                    {QStringLiteral("lyricText"), QStringLiteral("the matching line")}},
+        QVariantMap{{QStringLiteral("audioSource"), sourceFor(QStringLiteral("elsewhere"))},
+                    {QStringLiteral("timestampMs"), qint64{1000}},
+                    {QStringLiteral("lyricText"), QStringLiteral("not in this playlist")}},
+    };
+    searchModel.performLyricsSearch(tracks, matches);
+    const QModelIndex hit{searchModel.index(0, 0)};
+    expect(searchModel.rowCount() == 1, "lyric matches outside the playlist are dropped");
+    expect(searchModel.data(hit, PlaylistSearchModel::OriginalIndexRole).toInt() == 1,
+           "a lyric match maps to its playlist row");
+    expect(searchModel.data(hit, PlaylistSearchModel::MatchTimestampRole).toLongLong() == 42000,
+           "a lyric match carries the timestamp to start playback at");
+    expect(searchModel.data(hit, PlaylistSearchModel::MatchedLyricRole).toString() ==
+               QStringLiteral("the matching line"),
+           "a lyric match carries the matching line");
+}
+
 } // namespace
 
 int main(int argc, char *argv[])
@@ -170,8 +267,11 @@ int main(int argc, char *argv[])
     QCoreApplication application{argc, argv};
     QCoreApplication::setApplicationName(QStringLiteral("MySongPlayerModelTests"));
     verifiesInsertionAndSingleSourceSignal();
+    verifiesRetaggingKeepsTheRow();
+    verifiesChunkInsertion();
     verifiesRemovalBehavior();
     verifiesInvalidPlayModeIsRejected();
     verifiesLocalSearchPreservesZeroIndex();
+    verifiesLyricsSearchMapsMatchesToPlaylistRows();
     return failures == 0 ? 0 : 1;
 }
@@ -6,6 +6,8 @@
 #include <QCoreApplication>
 #include <QTemporaryDir>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <string>
@@ -43,9 +45,176 @@ SongPlayer::Core::AudioTrack track(string title, string source)
         .audioSource = move(source),
         .imageSource = "qrc:/qt/qml/MySongPlayer/assets/icons/app_icon.png",
         .videoSource = {},
+        .properties = {},
     };
 }
 
+void verifyLyricSearch(PlaylistStorageService& storage)
+{
+    if (!storage.lyricSearchAvailable()) {
+        cerr << "SKIPPED: SQLite without FTS5, lyric search is disabled\n";
+        return;
+    }
+
+    const vector<StoredLyricSearchSource> unindexed{storage.lyricSearchSources()};
+    expect(unindexed.size() == 3 && !unindexed.front().indexed,
+           "every local library track starts out unindexed");
+
+    const SongPlayer::Core::LyricSourceIdentity betaLrc{
+        .path = "/beta.lrc",
+        .size = 64,
+        .modifiedMs = 1700000000000,
+    };
+    const vector<IndexedLyricText> firstIndex{
+        {.audioSource = QUrl{QStringLiteral("file:///beta.mp3")},
+         .source = betaLrc,
+         .lyrics = {{.timestampMs = 1000, .text = "Walking through the morning rain"},
+                    {.timestampMs = 5500, .text = "Café lights are fading"}}},
+        {.audioSource = QUrl{QStringLiteral("file:///gamma.mp3")}, .source = nullopt, .lyrics = {}},
+    };
+    expect(storage.storeLyricSearchText(firstIndex), "lyric text is indexed");
+
+    const vector<LyricSearchMatch> rain{storage.searchLyrics(QStringLiteral("morning ra"))};
+    expect(rain.size() == 1 && rain.front().timestampMs == 1000 &&
+               rain.front().audioSource == QUrl{QStringLiteral("file:///beta.mp3")},
+           "a lyric search returns the track and the matching line's timestamp");
+    expect(storage.searchLyrics(QStringLiteral("cafe")).size() == 1,
+           "lyric search ignores diacritics");
+    expect(storage.searchLyrics(QStringLiteral("\"unbalanced OR")).empty(),
+           "query syntax in user input is matched literally");
+
+    const vector<IndexedLyricText> reindex{
+        {.audioSource = QUrl{QStringLiteral("file:///beta.mp3")},
+         .source = betaLrc,
+         .lyrics = {{.timestampMs = 2000, .text = "Only sunshine now"}}},
+    };
+    expect(storage.storeLyricSearchText(reindex), "a track is indexed again");
+    expect(storage.searchLyrics(QStringLiteral("rain")).empty(),
+           "indexing a track again replaces its previous lines");
+    expect(storage.searchLyrics(QStringLiteral("sunshine")).size() == 1,
+           "the new lines of a reindexed track are searchable");
+    const vector<LyricSearchMatch> offThread{storage.searchLyricsAsync(QStringLiteral("sunshine")).result()};
+    expect(offThread.size() == 1 && offThread.front().timestampMs == 2000,
+           "a lyric search on the thread pool sees the same index");
+
+    bool betaIndexed{false};
+    bool gammaIndexedWithout{false};
+    for (const StoredLyricSearchSource& stored : storage.lyricSearchSources()) {
+        if (stored.audioSource == QUrl{QStringLiteral("file:///beta.mp3")}) {
+            betaIndexed = stored.indexed && stored.indexedSource == betaLrc;
+        } else if (stored.audioSource == QUrl{QStringLiteral("file:///gamma.mp3")}) {
+            gammaIndexedWithout = stored.indexed && !stored.indexedSource;
+        }
+    }
+    expect(betaIndexed, "the indexed lyric source is recorded");
+    expect(gammaIndexedWithout, "a track without lyrics is recorded as indexed");
+
+    const vector<QUrl> onlyBeta{QUrl{QStringLiteral("file:///beta.mp3")},
+                                QUrl{QStringLiteral("file:///missing.mp3")}};
+    const vector<StoredLyricSearchSource> selected{storage.lyricSearchSources(onlyBeta)};
+    expect(selected.size() == 1 && selected.front().audioSource == onlyBeta.front() &&
+               selected.front().indexedSource == betaLrc,
+           "lyric search sources can be read for selected tracks only");
+}
+
+void verifyLibraryFingerprints(PlaylistStorageService& storage)
+{
+    const SongPlayer::Core::FileFingerprint alphaFingerprint{
+        .device = ~std::uint64_t{0},
+        .inode = 42,
+        .size = 4096,
+        .modifiedNs = 1700000000123456789,
+    };
+    const vector<StoredFileFingerprint> fingerprints{
+        {.audioSource = QUrl{QStringLiteral("file:///alpha.mp3")}, .fingerprint = alphaFingerprint},
+        {.audioSource = QUrl{QStringLiteral("file:///beta.mp3")}, .fingerprint = alphaFingerprint},
+    };
+    expect(storage.storeFileFingerprints(fingerprints), "file fingerprints are stored");
+    const vector<StoredFileFingerprint> stored{storage.fileFingerprints()};
+    expect(stored.size() == 2 && stored.front().fingerprint == alphaFingerprint,
+           "file fingerprints round-trip, full 64-bit device numbers included");
+
+    vector<SongPlayer::Core::AudioTrack> retagged{
+        track("Alpha (Remastered)", "file:///alpha.mp3"),
+        track("Beta", "file:///beta.mp3"),
+        track("Gamma", "file:///gamma.mp3"),
+    };
+    retagged.front().properties = SongPlayer::Core::AudioProperties{
+        .durationMs = 201'500,
+        .bitrateKbps = 912,
+        .sampleRateHz = 96'000,
+        .channels = 2,
+    };
+    expect(storage.savePlaylist(QStringLiteral("Ordered"), retagged), "retagged playlist saves");
+    const PlaylistInfo reloaded{storage.loadPlaylist(QStringLiteral("Ordered"))};
+    expect(reloaded.audioItems.front().title == "Alpha (Remastered)",
+           "saving refreshes the tags of existing audio items");
+    expect(reloaded.audioItems.front().properties == retagged.front().properties,
+           "audio properties round-trip through audio_items");
+
+    const QUrl gamma{QStringLiteral("file:///gamma.mp3")};
+    const vector<QUrl> withoutProperties{storage.tracksWithoutPropertiesAsync().result()};
+    expect(std::ranges::find(withoutProperties, gamma) != withoutProperties.end()
+               && std::ranges::find(withoutProperties, QUrl{QStringLiteral("file:///beta.mp3")})
+                      == withoutProperties.end()
+               && std::ranges::find(withoutProperties, QUrl{QStringLiteral("file:///alpha.mp3")})
+                      == withoutProperties.end(),
+           "only tracks without a duration and without a fingerprint are read again");
+    const vector<StoredAudioProperties> reread{
+        {.audioSource = gamma, .properties = retagged.front().properties},
+    };
+    expect(storage.storeAudioProperties(reread), "re-read audio properties are stored");
+    expect(storage.loadPlaylist(QStringLiteral("Ordered")).audioItems.back().properties
+               == retagged.front().properties,
+           "re-read audio properties reach every playlist listing the track");
+
+    const vector<QUrl> forgotten{QUrl{QStringLiteral("file:///alpha.mp3")}};
+    expect(storage.removeLibraryFiles(forgotten, true), "files that are gone are forgotten by the library");
+    expect(storage.fileFingerprints().size() == 1, "the fingerprints of forgotten files are dropped");
+    expect(storage.loadPlaylist(QStringLiteral("Ordered")).audioItems.size() == 3,
+           "forgetting files keeps the playlist entries that list them");
+
+    const vector<QUrl> gone{QUrl{QStringLiteral("file:///beta.mp3")}};
+    expect(storage.removeLibraryFiles(gone), "files that are gone are removed from the library");
+    expect(storage.fileFingerprints().empty(), "the fingerprints of removed files are dropped");
+    const PlaylistInfo remaining{storage.loadPlaylist(QStringLiteral("Ordered"))};
+    expect(remaining.audioItems.size() == 2 && remaining.audioItems.back().title == "Gamma",
+           "removed files leave the playlists that held them");
+    expect(!storage.lyricAssociation(gone.front()), "removed files lose their lyric association");
+    expect((storage.coverImageSources()
+            == vector<QUrl>{QUrl{QStringLiteral("qrc:/qt/qml/MySongPlayer/assets/icons/app_icon.png")}}),
+           "cover images shared by several audio items are listed once");
+    expect(storage.coverImageSourcesAsync().result() == storage.coverImageSources(),
+           "cover images are listed off the GUI thread as well");
+
+    const QUrl folder{QStringLiteral("file:///music")};
+    expect(storage.addLibraryFolder(folder) && storage.addLibraryFolder(folder), "a library folder is registered");
+    expect(storage.libraryFolders() == vector<QUrl>{folder}, "a library folder is registered once");
+    expect(storage.removeLibraryFolder(folder) && storage.libraryFolders().empty(),
+           "a library folder can be unregistered");
+
+    const vector<StoredFileFingerprint> folderFiles{
+        {.audioSource = QUrl{QStringLiteral("file:///music/a.mp3")}, .fingerprint = alphaFingerprint},
+        {.audioSource = QUrl{QStringLiteral("file:///music/deep/b.mp3")}, .fingerprint = alphaFingerprint},
+        {.audioSource = QUrl{QStringLiteral("file:///music_more/c.mp3")}, .fingerprint = alphaFingerprint},
+        {.audioSource = QUrl{QStringLiteral("file:///musicals.mp3")}, .fingerprint = alphaFingerprint},
+    };
+    expect(storage.storeFileFingerprints(folderFiles), "fingerprints in several folders are stored");
+    const vector<StoredFileFingerprint> belowFolder{storage.folderFingerprintsReader(folder)()};
+    expect(belowFolder.size() == 2 && std::ranges::all_of(belowFolder, [](const StoredFileFingerprint& stored) {
+               return stored.audioSource.path().startsWith(QStringLiteral("/music/"));
+           }),
+           "a folder's fingerprints are read without its siblings");
+    expect(storage.folderFingerprintsReader(QUrl{QStringLiteral("file:///mus_c")})().empty(),
+           "wildcard characters in a folder name are matched literally");
+    vector<QUrl> folderSources;
+    for (const StoredFileFingerprint& stored : folderFiles) {
+        folderSources.push_back(stored.audioSource);
+    }
+    expect(storage.removeLibraryFiles(folderSources) && storage.fileFingerprints().empty(),
+           "the folder fingerprints are removed again");
+}
+
 void verifyStorageBehavior(PlaylistStorageService& storage)
 {
     const QString defaultName{SongPlayer::QtAdapter::fromUtf8String(
@@ -92,6 +261,43 @@ void verifyStorageBehavior(PlaylistStorageService& storage)
     expect(storage.children().size() == childCount,
            "repeated loads do not accumulate temporary QObjects");
 
+    const vector<StoredLyricAssociation> unresolved{storage.libraryLyricAssociations()};
+    expect(unresolved.size() == 3, "every local library track is listed for lyric resolution");
+    expect(!unresolved.empty() && !unresolved.front().association,
+           "tracks start without a lyric association");
+
+    const SongPlayer::Core::LyricAssociation betaLyrics{
+        .lrcFile = SongPlayer::Core::LyricSourceIdentity{
+            .path = "/beta.lrc",
+            .size = 64,
+            .modifiedMs = 1700000000000,
+        },
+        .exactMatch = true,
+        .directoryModifiedMs = 1700000000100,
+    };
+    const SongPlayer::Core::LyricAssociation gammaWithout{
+        .lrcFile = nullopt,
+        .exactMatch = false,
+        .directoryModifiedMs = 1700000000100,
+    };
+    const vector<StoredLyricAssociation> resolved{
+        {.audioSource = QUrl{QStringLiteral("file:///beta.mp3")}, .association = betaLyrics},
+        {.audioSource = QUrl{QStringLiteral("file:///gamma.mp3")}, .association = gammaWithout},
+        {.audioSource = QUrl{QStringLiteral("file:///missing.mp3")}, .association = gammaWithout},
+    };
+    expect(storage.storeLyricAssociations(resolved), "lyric associations are stored");
+    expect(storage.lyricAssociation(QUrl{QStringLiteral("file:///beta.mp3")}) == betaLyrics,
+           "a resolved LRC association round-trips");
+    expect(storage.lyricAssociation(QUrl{QStringLiteral("file:///gamma.mp3")}) == gammaWithout,
+           "a negative association round-trips");
+    expect(!storage.lyricAssociation(QUrl{QStringLiteral("file:///alpha.mp3")}),
+           "an unresolved track has no association");
+    expect(!storage.lyricAssociation(QUrl{QStringLiteral("file:///missing.mp3")}),
+           "associations are only stored for library tracks");
+
+    verifyLyricSearch(storage);
+    verifyLibraryFingerprints(storage);
+
     expect(storage.renamePlaylist(QStringLiteral("Ordered"), QStringLiteral("Renamed")),
            "ordinary playlist can be renamed");
     expect(storage.loadPlaylist(QStringLiteral("Ordered")).id < 0,
@@ -128,6 +334,29 @@ void verifyCommitFailureRollsBack()
     database.closeDatabase();
 }
 
+void verifyPropertyMigrationForgetsFingerprints()
+{
+    SongPlayer::PlaylistDatabase database;
+    expect(database.initializeDatabase(), "database reopens for the migration test");
+    // A library imported before audio properties were read: its rows lack the columns
+    // and its fingerprints still match the files.
+    expect(database.executeNonQuery(QStringLiteral(
+               "INSERT INTO audio_items (title, audio_source) VALUES ('Old', 'file:///old.mp3')"))
+               && database.executeNonQuery(QStringLiteral(
+                   "INSERT INTO audio_file_fingerprints (audio_source, device, inode, size, modified_ns) "
+                   "VALUES ('file:///old.mp3', 1, 2, 3, 4)"))
+               && database.executeNonQuery(QStringLiteral("ALTER TABLE audio_items DROP COLUMN duration_ms")),
+           "a library without audio properties is set up");
+    database.closeDatabase();
+
+    expect(database.initializeDatabase(), "the old library is migrated");
+    QSqlQuery fingerprints{database.executeQuery(QStringLiteral(
+        "SELECT COUNT(*) FROM audio_file_fingerprints WHERE audio_source = 'file:///old.mp3'"))};
+    expect(fingerprints.next() && fingerprints.value(0).toInt() == 0,
+           "migrated rows lose their fingerprints so the next rescan reads their properties");
+    database.closeDatabase();
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
@@ -147,5 +376,6 @@ int main(int argc, char* argv[])
     expect(!storage.isInitialized(), "storage shuts down cleanly");
 
     verifyCommitFailureRollsBack();
+    verifyPropertyMigrationForgetsFingerprints();
     return failures == 0 ? 0 : 1;
 }
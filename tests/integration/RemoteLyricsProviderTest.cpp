@@ -0,0 +1,296 @@
+#include "services/HttpLyricsProvider.h"
+#include "services/LyricsService.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QFuture>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using std::cerr;
+using std::memcpy;
+using std::move;
+using std::string_view;
+
+int failures{0};
+
+void expect(bool condition, string_view message)
+{
+    if (condition) {
+        return;
+    }
+
+    cerr << "FAILED: " << message << '\n';
+    ++failures;
+}
+
+// Local stand-in for a lyrics server: every request stays pending until the test
+// answers it.
+class ControlledReply final : public QNetworkReply
+{
+public:
+    ControlledReply(const QNetworkRequest &request,
+                    QNetworkAccessManager::Operation operation,
+                    QObject *parent)
+        : QNetworkReply{parent}
+    {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(operation);
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    void abort() override
+    {
+        m_aborted = true;
+    }
+
+    [[nodiscard]] bool aborted() const
+    {
+        return m_aborted;
+    }
+
+    void finishSuccess(QByteArray payload)
+    {
+        finish(move(payload), QNetworkReply::NoError, {});
+    }
+
+    void finishError(QNetworkReply::NetworkError error, const QString &message)
+    {
+        finish({}, error, message);
+    }
+
+    qint64 bytesAvailable() const override
+    {
+        return static_cast<qint64>(m_payload.size() - m_readOffset) + QNetworkReply::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 unreadBytes{static_cast<qint64>(m_payload.size() - m_readOffset)};
+        if (unreadBytes <= 0) {
+            return -1;
+        }
+
+        const qint64 bytesToCopy{qMin(maxSize, unreadBytes)};
+        memcpy(data, m_payload.constData() + m_readOffset, static_cast<size_t>(bytesToCopy));
+        m_readOffset += static_cast<qsizetype>(bytesToCopy);
+        return bytesToCopy;
+    }
+
+private:
+    void finish(QByteArray payload, QNetworkReply::NetworkError error, const QString &message)
+    {
+        m_payload = move(payload);
+        if (error != QNetworkReply::NoError) {
+            setError(error, message);
+        }
+        setFinished(true);
+        emit finished();
+    }
+
+    QByteArray m_payload{};
+    qsizetype m_readOffset{0};
+    bool m_aborted{false};
+};
+
+class ControlledNetworkAccessManager final : public QNetworkAccessManager
+{
+public:
+    using QNetworkAccessManager::QNetworkAccessManager;
+
+    [[nodiscard]] qsizetype replyCount() const
+    {
+        return m_replies.size();
+    }
+
+    [[nodiscard]] ControlledReply *replyAt(qsizetype index) const
+    {
+        return m_replies.at(index);
+    }
+
+protected:
+    QNetworkReply *createRequest(Operation operation,
+                                 const QNetworkRequest &request,
+                                 QIODevice *outgoingData) override
+    {
+        Q_UNUSED(outgoingData);
+        auto *reply{new ControlledReply{request, operation, this}};
+        m_replies.append(reply);
+        return reply;
+    }
+
+private:
+    QList<QPointer<ControlledReply>> m_replies{};
+};
+
+template <typename T>
+bool waitFor(const QFuture<T> &future)
+{
+    const QDeadlineTimer deadline{3000};
+    while (!future.isFinished() && !deadline.hasExpired()) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    }
+    return future.isFinished();
+}
+
+QByteArray syncedLyricsResponse(const QString &lyrics)
+{
+    return QJsonDocument{QJsonObject{{QStringLiteral("syncedLyrics"), lyrics}}}.toJson(QJsonDocument::Compact);
+}
+
+void verifiesFetchesAreCoalescedAndBounded()
+{
+    ControlledNetworkAccessManager networkManager{};
+    HttpLyricsProvider provider{&networkManager, QUrl{QStringLiteral("http://127.0.0.1/api/get")}};
+    provider.setMaxConcurrentFetches(2);
+
+    QFuture<LyricsFetchResult> first{provider.fetchLyrics({.artist = QStringLiteral("Band"),
+                                                            .title = QStringLiteral("Song")})};
+    QFuture<LyricsFetchResult> duplicate{provider.fetchLyrics({.artist = QStringLiteral(" band"),
+                                                                .title = QStringLiteral("SONG ")})};
+    QFuture<LyricsFetchResult> second{provider.fetchLyrics({.artist = QStringLiteral("Band"),
+                                                             .title = QStringLiteral("Missing")})};
+    QFuture<LyricsFetchResult> queued{provider.fetchLyrics({.artist = QStringLiteral("Band"),
+                                                             .title = QStringLiteral("Offline")})};
+    expect(networkManager.replyCount() == 2, "requests are coalesced and bounded to two in flight");
+    const QUrlQuery firstQuery{networkManager.replyAt(0)->request().url()};
+    expect(firstQuery.queryItemValue(QStringLiteral("track_name")) == QStringLiteral("Song"),
+           "the track name is sent to the endpoint");
+
+    networkManager.replyAt(0)->finishSuccess(syncedLyricsResponse(QStringLiteral("[00:01.00]Hello")));
+    expect(first.isFinished() && duplicate.isFinished(), "coalesced callers finish together");
+    expect(duplicate.resultCount() == 1 && duplicate.result().status == LyricsFetchResult::Status::Found &&
+               duplicate.result().lyricsText == QStringLiteral("[00:01.00]Hello"),
+           "a coalesced caller receives the shared result");
+    expect(networkManager.replyCount() == 3, "a finished fetch lets the queued one start");
+
+    networkManager.replyAt(1)->finishError(QNetworkReply::ContentNotFoundError, QStringLiteral("not found"));
+    expect(second.resultCount() == 1 && second.result().status == LyricsFetchResult::Status::NotFound,
+           "HTTP 404 is reported as not found");
+
+    networkManager.replyAt(2)->finishError(QNetworkReply::ConnectionRefusedError, QStringLiteral("refused"));
+    expect(queued.resultCount() == 1 && queued.result().status == LyricsFetchResult::Status::Failed,
+           "a network error is reported as a transient failure");
+
+    QFuture<LyricsFetchResult> plain{provider.fetchLyrics({.artist = QStringLiteral("Band"),
+                                                            .title = QStringLiteral("Plain")})};
+    networkManager.replyAt(3)->finishSuccess(QByteArrayLiteral("[00:02.00]Served as a file\n"));
+    expect(plain.resultCount() == 1 && plain.result().status == LyricsFetchResult::Status::Found,
+           "an endpoint serving raw LRC text is understood");
+}
+
+void verifiesRemoteLyricsAreCached()
+{
+    ControlledNetworkAccessManager networkManager{};
+    HttpLyricsProvider provider{&networkManager, QUrl{QStringLiteral("http://127.0.0.1/api/get")}};
+    LyricsService service;
+    service.setLyricsProvider(&provider);
+
+    const LyricsQuery found{.artist = QStringLiteral("Remote Artist"), .title = QStringLiteral("Found Song")};
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> fetched{service.loadLyrics({}, std::nullopt, found)};
+    for (int attempt{0}; attempt < 50 && networkManager.replyCount() == 0; ++attempt) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    }
+    expect(networkManager.replyCount() == 1, "a track without local lyrics asks the provider");
+    if (networkManager.replyCount() != 1) {
+        return;
+    }
+    networkManager.replyAt(0)->finishSuccess(syncedLyricsResponse(QStringLiteral("[00:03.00]From afar")));
+    expect(waitFor(fetched) && fetched.resultCount() == 1 && fetched.result().size() == 1 &&
+               fetched.result().front().timestampMs == 3000,
+           "fetched lyrics are parsed");
+
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> cached{service.loadLyrics({}, std::nullopt, found)};
+    expect(waitFor(cached) && cached.resultCount() == 1 && cached.result().size() == 1,
+           "a second lookup is served from the persistent cache");
+    expect(networkManager.replyCount() == 1, "cached lyrics are not fetched again");
+
+    const LyricsQuery missing{.artist = QStringLiteral("Remote Artist"), .title = QStringLiteral("Unknown Song")};
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> notFound{service.loadLyrics({}, std::nullopt, missing)};
+    for (int attempt{0}; attempt < 50 && networkManager.replyCount() == 1; ++attempt) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    }
+    if (networkManager.replyCount() != 2) {
+        expect(false, "a missing track is asked for once");
+        return;
+    }
+    networkManager.replyAt(1)->finishError(QNetworkReply::ContentNotFoundError, QStringLiteral("not found"));
+    expect(waitFor(notFound) && notFound.resultCount() == 1 && notFound.result().empty(),
+           "a track the provider does not know yields no lyrics");
+
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> negative{service.loadLyrics({}, std::nullopt, missing)};
+    expect(waitFor(negative) && negative.resultCount() == 1 && negative.result().empty(),
+           "the not-found answer is served from the cache");
+    expect(networkManager.replyCount() == 2, "a cached not-found answer is not fetched again within its TTL");
+}
+
+void verifiesCanceledLookupsAbortTheirFetch()
+{
+    ControlledNetworkAccessManager networkManager{};
+    HttpLyricsProvider provider{&networkManager, QUrl{QStringLiteral("http://127.0.0.1/api/get")}};
+    provider.setMaxConcurrentFetches(1);
+
+    const LyricsQuery shared{.artist = QStringLiteral("Band"), .title = QStringLiteral("Shared")};
+    QFuture<LyricsFetchResult> first{provider.fetchLyrics(shared)};
+    QFuture<LyricsFetchResult> second{provider.fetchLyrics(shared)};
+    QFuture<LyricsFetchResult> queued{provider.fetchLyrics({.artist = QStringLiteral("Band"),
+                                                             .title = QStringLiteral("Queued")})};
+    provider.cancelFetch(shared);
+    expect(!networkManager.replyAt(0)->aborted() && !second.isCanceled(),
+           "a fetch keeps running while another caller waits for it");
+    provider.cancelFetch(shared);
+    expect(networkManager.replyAt(0)->aborted() && first.isCanceled(),
+           "the last caller withdrawing aborts the request");
+    expect(networkManager.replyCount() == 2 && !queued.isFinished(),
+           "an aborted fetch frees its slot for the queued one");
+
+    networkManager.replyAt(1)->finishSuccess(syncedLyricsResponse(QStringLiteral("[00:01.00]Queued")));
+
+    LyricsService service;
+    service.setLyricsProvider(&provider);
+    const LyricsQuery skipped{.artist = QStringLiteral("Remote Artist"), .title = QStringLiteral("Skipped Song")};
+    QFuture<std::vector<SongPlayer::Core::LyricLine>> lookup{service.loadLyrics({}, std::nullopt, skipped)};
+    for (int attempt{0}; attempt < 50 && networkManager.replyCount() == 2; ++attempt) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+    }
+    if (networkManager.replyCount() != 3) {
+        expect(false, "a remote lookup reaches the network");
+        return;
+    }
+    lookup.cancel();
+    QCoreApplication::processEvents();
+    expect(networkManager.replyAt(2)->aborted(), "canceling a lyrics lookup aborts its network request");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QTemporaryDir cacheDirectory;
+    expect(cacheDirectory.isValid(), "temporary cache directory is available");
+    qputenv("XDG_CACHE_HOME", cacheDirectory.path().toUtf8());
+
+    QCoreApplication application{argc, argv};
+    verifiesFetchesAreCoalescedAndBounded();
+    verifiesRemoteLyricsAreCached();
+    verifiesCanceledLookupsAbortTheirFetch();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "infrastructure/StorageDeviceProbe.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* message)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << message << '\n';
+        ++failures;
+    }
+}
+
+class TemporaryDirectory {
+public:
+    TemporaryDirectory()
+        : m_path(std::filesystem::temp_directory_path() /
+                 ("mysongplayer-storage-device-probe-test-" + std::to_string(
+                     std::chrono::steady_clock::now().time_since_epoch().count())))
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_path, error);
+        std::filesystem::create_directories(m_path);
+    }
+
+    ~TemporaryDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_path, error);
+    }
+
+    [[nodiscard]] const std::filesystem::path& path() const noexcept
+    {
+        return m_path;
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+
+} // namespace
+
+int main()
+{
+    const TemporaryDirectory temporary;
+    const std::filesystem::path audioFile = temporary.path() / "track.mp3";
+    std::ofstream(audioFile, std::ios::binary) << "x";
+    std::filesystem::create_directories(temporary.path() / "album");
+
+    SongPlayer::Infrastructure::StorageDeviceProbe probe;
+    const SongPlayer::Infrastructure::StorageDevice first = probe.deviceFor(audioFile);
+    const SongPlayer::Infrastructure::StorageDevice sibling = probe.deviceFor(temporary.path() / "other.mp3");
+    expect(first.id == sibling.id && first.sequentialOnly == sibling.sequentialOnly,
+           "files in one directory are scheduled on the same device");
+    const SongPlayer::Infrastructure::StorageDevice nested = probe.deviceFor(temporary.path() / "album" / "01.mp3");
+    expect(nested.id == first.id && nested.sequentialOnly == first.sequentialOnly,
+           "a subdirectory on the same file system maps to the same device");
+#if defined(__unix__) || defined(__APPLE__)
+    expect(first.id != 0, "the device of an existing directory is identified");
+#endif
+
+    return failures == 0 ? 0 : 1;
+}
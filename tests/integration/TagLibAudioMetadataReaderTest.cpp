@@ -1,11 +1,21 @@
 #include "core/AudioImport.h"
+#include "infrastructure/ReadaheadFileStream.h"
 #include "infrastructure/TagLibAudioMetadataReader.h"
 
+#include <taglib/attachedpictureframe.h>
+#include <taglib/fileref.h>
+#include <taglib/flacfile.h>
+#include <taglib/flacpicture.h>
+#include <taglib/id3v2tag.h>
+#include <taglib/mpegfile.h>
+
 #include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -46,6 +56,21 @@ private:
     std::filesystem::path m_path;
 };
 
+// The smallest stream TagLib accepts as FLAC: the marker and one STREAMINFO block
+// (44.1 kHz, stereo, 16 bit, 3 s worth of samples declared, no frames).
+void writeMinimalFlac(const std::filesystem::path& path)
+{
+    static constexpr unsigned char streamInfo[] = {
+        'f', 'L', 'a', 'C', 0x80, 0x00, 0x00, 0x22,
+        0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x0a, 0xc4, 0x42, 0xf0, 0x00, 0x02, 0x04, 0xcc,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(streamInfo), sizeof(streamInfo));
+}
+
 } // namespace
 
 int main()
@@ -79,5 +104,79 @@ int main()
                "a missing path has the InvalidPath error code");
     }
 
+    std::vector<SongPlayer::Core::AudioImportResult> albumTracks;
+    for (const char* name : {"album-track-1.flac", "album-track-2.flac"}) {
+        const std::filesystem::path flacFile = temporary.path() / name;
+        writeMinimalFlac(flacFile);
+        {
+            TagLib::FLAC::File flac(flacFile.c_str(), false);
+            auto* picture = new TagLib::FLAC::Picture;
+            picture->setType(TagLib::FLAC::Picture::FrontCover);
+            picture->setMimeType("");
+            picture->setData(TagLib::ByteVector("\x89PNG\r\n\x1a\n-cover-bytes", 20));
+            flac.addPicture(picture);
+            expect(flac.isValid() && flac.save(), "the FLAC fixture gets a PICTURE block");
+        }
+        albumTracks.push_back(reader.read({
+            .audioFile = flacFile,
+            .coverCacheDirectory = temporary.path() / "covers",
+        }));
+    }
+    const SongPlayer::Core::AudioImportResult& firstTrack = albumTracks.front();
+    const SongPlayer::Core::AudioImportResult& secondTrack = albumTracks.back();
+    expect(firstTrack && firstTrack->coverFile && std::filesystem::is_regular_file(*firstTrack->coverFile),
+           "a FLAC PICTURE block is extracted into the cover cache");
+    if (firstTrack && firstTrack->coverFile) {
+        expect(firstTrack->coverFile->extension() == ".png",
+               "an untyped picture is recognized from its bytes");
+    }
+    expect(firstTrack && secondTrack && firstTrack->coverFile && firstTrack->coverFile == secondTrack->coverFile,
+           "tracks with identical artwork share one content-addressed cover file");
+    expect(firstTrack && firstTrack->properties.durationMs == 3000,
+           "the duration is read from the stream header without decoding");
+    expect(firstTrack && firstTrack->properties.sampleRateHz == 44100 && firstTrack->properties.channels == 2,
+           "sample rate and channel count come with the duration");
+
+    // A cover larger than the default head still arrives with the head read, because
+    // the head is sized from the ID3v2 header.
+    const std::filesystem::path taggedFile = temporary.path() / "readahead.mp3";
+    const std::size_t coverBytes = SongPlayer::Infrastructure::ReadaheadFileStream::kHeadBytes + 4096;
+    std::ofstream(taggedFile, std::ios::binary) << std::string(512 * 1024, '\0');
+    {
+        TagLib::MPEG::File mpeg(taggedFile.c_str(), false);
+        TagLib::ID3v2::Tag* tag = mpeg.ID3v2Tag(true);
+        tag->setTitle("Readahead Title");
+        auto* picture = new TagLib::ID3v2::AttachedPictureFrame;
+        picture->setMimeType("image/jpeg");
+        picture->setType(TagLib::ID3v2::AttachedPictureFrame::FrontCover);
+        picture->setPicture(TagLib::ByteVector(static_cast<unsigned int>(coverBytes), '\x7f'));
+        tag->addFrame(picture);
+        expect(mpeg.save(TagLib::MPEG::File::ID3v2), "the MP3 fixture gets an ID3v2 tag with a large cover");
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    {
+        const auto stream = SongPlayer::Infrastructure::ReadaheadFileStream::open(taggedFile);
+        expect(stream != nullptr, "a readable file opens as a readahead stream");
+        if (stream) {
+            const std::size_t prefetchReads = stream->fileReads();
+            const TagLib::FileRef file(stream.get(), true, TagLib::AudioProperties::Fast);
+            expect(!file.isNull() && file.tag() && file.tag()->title() == "Readahead Title",
+                   "TagLib parses the tags through the readahead stream");
+            // Scanning 512 KiB of non-audio for a first frame costs a handful of window
+            // reads instead of one read per 1 KiB TagLib buffer.
+            expect(stream->fileReads() - prefetchReads < 16, "the parse is served by a few large reads");
+        }
+    }
+    expect(!SongPlayer::Infrastructure::ReadaheadFileStream::open(temporary.path() / "missing.mp3"),
+           "a missing file does not open as a stream");
+#endif
+    const SongPlayer::Core::AudioImportResult tagged = reader.read({
+        .audioFile = taggedFile,
+        .coverCacheDirectory = temporary.path() / "covers",
+    });
+    expect(tagged && tagged->title == "Readahead Title" && tagged->coverFile
+               && std::filesystem::file_size(*tagged->coverFile) == coverBytes,
+           "the reader extracts a cover larger than the default head intact");
+
     return failures == 0 ? 0 : 1;
 }